@@ -19,10 +19,153 @@
 #include <vector>
 #include <atomic>
 
+#ifdef OZO_BENCHMARK_ACCOUNTING
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace ozo::benchmark::detail {
+
+inline std::atomic<std::uint64_t> allocations {0};
+inline std::atomic<std::uint64_t> allocated_bytes {0};
+
+inline void* allocate(std::size_t size) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+// Not inlined, so the compiler does not see free() called for the operator new result.
+[[gnu::noinline]] inline void deallocate(void* p) noexcept {
+    std::free(p);
+}
+
+} // namespace ozo::benchmark::detail
+
+// Global allocation functions are replaced to count heap allocations made via operator new,
+// allocations made by libpq with malloc are not counted.
+void* operator new(std::size_t size) {
+    if (void* p = ozo::benchmark::detail::allocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return ozo::benchmark::detail::allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return ozo::benchmark::detail::allocate(size);
+}
+
+void operator delete(void* p) noexcept { ozo::benchmark::detail::deallocate(p); }
+void operator delete[](void* p) noexcept { ozo::benchmark::detail::deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { ozo::benchmark::detail::deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { ozo::benchmark::detail::deallocate(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { ozo::benchmark::detail::deallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { ozo::benchmark::detail::deallocate(p); }
+#endif
+
 namespace ozo::benchmark {
 
 namespace hana = boost::hana;
 
+/**
+ * Process resources used by a benchmark: heap allocations, syscalls and context switches.
+ * Counted only when benchmarks are built with OZO_BENCHMARK_ACCOUNTING option, which replaces
+ * global operator new. Syscalls are counted with the raw_syscalls:sys_enter tracepoint via
+ * perf_event_open if it is permitted, threads are accounted when they exit.
+ */
+struct resource_usage {
+    std::uint64_t allocations = 0;
+    std::uint64_t allocated_bytes = 0;
+    __OZO_STD_OPTIONAL<std::uint64_t> syscalls;
+    std::uint64_t context_switches = 0;
+
+    static constexpr bool enabled() noexcept {
+#ifdef OZO_BENCHMARK_ACCOUNTING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static resource_usage now() {
+        resource_usage retval;
+#ifdef OZO_BENCHMARK_ACCOUNTING
+        retval.allocations = detail::allocations.load(std::memory_order_relaxed);
+        retval.allocated_bytes = detail::allocated_bytes.load(std::memory_order_relaxed);
+        if (const int fd = syscalls_counter(); fd >= 0) {
+            std::uint64_t value = 0;
+            if (read(fd, &value, sizeof(value)) == sizeof(value)) {
+                retval.syscalls = value;
+            }
+        }
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            retval.context_switches = static_cast<std::uint64_t>(usage.ru_nvcsw + usage.ru_nivcsw);
+        }
+#endif
+        return retval;
+    }
+
+    /**
+     * Prints the usage per request between the snapshots.
+     */
+    static void print(std::ostream& stream, const resource_usage& start, const resource_usage& finish,
+            std::size_t requests) {
+        if (!enabled()) {
+            return;
+        }
+        const auto per_request = [&] (std::uint64_t value) {
+            return static_cast<double>(value) / static_cast<double>(std::max<std::size_t>(requests, 1));
+        };
+        stream << "allocations per request: " << per_request(finish.allocations - start.allocations) << std::endl;
+        stream << "allocated bytes per request: " << per_request(finish.allocated_bytes - start.allocated_bytes) << std::endl;
+        if (start.syscalls && finish.syscalls) {
+            stream << "syscalls per request: " << per_request(*finish.syscalls - *start.syscalls) << std::endl;
+        } else {
+            stream << "syscalls per request: n/a (raw_syscalls:sys_enter tracepoint is not available)" << std::endl;
+        }
+        stream << "context switches per request: " << per_request(finish.context_switches - start.context_switches) << std::endl;
+    }
+
+private:
+#ifdef OZO_BENCHMARK_ACCOUNTING
+    static int syscalls_counter() {
+        static const int fd = [] {
+            std::uint64_t id = 0;
+            for (const char* path : {"/sys/kernel/tracing/events/raw_syscalls/sys_enter/id",
+                                     "/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id"}) {
+                if (std::ifstream(path) >> id) {
+                    break;
+                }
+            }
+            if (!id) {
+                return -1;
+            }
+            perf_event_attr attr {};
+            attr.type = PERF_TYPE_TRACEPOINT;
+            attr.size = sizeof(attr);
+            attr.config = id;
+            attr.inherit = 1;
+            return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        } ();
+        return fd;
+    }
+#endif
+};
+
 template <class Ratio>
 struct duration_name {};
 
@@ -84,6 +227,7 @@ public:
     void start() {
         if (!start_time) {
             total_rows_count = 0;
+            start_usage = resource_usage::now();
             start_time = std::chrono::steady_clock::now();
         }
     }
@@ -93,8 +237,10 @@ public:
             return false;
         }
         total_rows_count += rows_count;
+        ++total_requests_count;
         if (total_rows_count >= max_rows_count) {
             finish = std::chrono::steady_clock::now();
+            finish_usage = resource_usage::now();
             return false;
         }
         return true;
@@ -107,6 +253,7 @@ public:
                       << std::setprecision(3) << std::fixed
                       << (total_rows_count / std::chrono::duration_cast<double_s>(*finish - *start_time).count())
                       << " row/sec" << std::endl;
+            resource_usage::print(std::cout, start_usage, finish_usage, total_requests_count);
         }
     }
 
@@ -115,6 +262,9 @@ private:
     __OZO_STD_OPTIONAL<std::chrono::steady_clock::time_point> start_time;
     __OZO_STD_OPTIONAL<std::chrono::steady_clock::time_point> finish;
     std::size_t total_rows_count;
+    std::size_t total_requests_count = 0;
+    resource_usage start_usage;
+    resource_usage finish_usage;
 };
 
 template <std::size_t coroutines>
@@ -159,6 +309,7 @@ public:
             std::cout << "min read rows speed: " << rows_speeds.front() << " row/sec" << std::endl;
             std::cout << "max read rows speed: " << rows_speeds.back() << " row/sec" << std::endl;
         }
+        resource_usage::print(std::cout, start_usage, finish_usage, total_requests_count);
     }
 
     bool step(std::size_t rows_count, std::size_t token = 0) {
@@ -218,6 +369,8 @@ private:
     std::chrono::steady_clock::time_point next_print = start + std::chrono::seconds(1);
     std::chrono::steady_clock::time_point step_start = start;
     std::array<std::chrono::steady_clock::time_point, coroutines> request_start;
+    const resource_usage start_usage = resource_usage::now();
+    resource_usage finish_usage = start_usage;
 
     bool step_impl() {
         finish = std::chrono::steady_clock::now();
@@ -241,6 +394,7 @@ private:
                       << std::setprecision(4) << std::fixed << rows_per_second << " row/sec"
                       << std::endl;
             if (total_duration > max_duration) {
+                finish_usage = resource_usage::now();
                 finished = true;
                 return false;
             }
@@ -0,0 +1,181 @@
+#include "benchmark.h"
+
+#include <ozo/ext/boost/uuid.h>
+#include <ozo/io/binary_query.h>
+#include <ozo/io/recv.h>
+#include <ozo/query.h>
+#include <ozo/result.h>
+#include <ozo/shortcuts.h>
+
+#include <boost/uuid/random_generator.hpp>
+
+#include <libpq-fe.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ozo::benchmark {
+
+struct codec_composite {
+    std::int64_t id;
+    std::string name;
+    __OZO_STD_OPTIONAL<double> score;
+};
+
+} // namespace ozo::benchmark
+
+BOOST_FUSION_ADAPT_STRUCT(ozo::benchmark::codec_composite, id, name, score)
+OZO_PG_DEFINE_CUSTOM_TYPE(ozo::benchmark::codec_composite, "codec_composite")
+
+namespace ozo::benchmark {
+
+using clock = std::chrono::steady_clock;
+using double_s = std::chrono::duration<double, std::ratio<1>>;
+
+constexpr oid_t codec_composite_oid = 100000;
+
+auto make_oid_map() {
+    auto retval = register_types<codec_composite>();
+    set_type_oid<codec_composite>(retval, codec_composite_oid);
+    return retval;
+}
+
+using oid_map_type = decltype(make_oid_map());
+
+/**
+ * Result of a single column with the same value in each row, like a PostgreSQL server
+ * sends it in the binary format. The value is encoded with ozo itself.
+ */
+template <typename T>
+ozo::result make_result(const oid_map_type& oid_map, const T& value, std::size_t rows, std::size_t& bytes) {
+    const binary_query query(make_query("", value), oid_map);
+    PGresult* res = PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK);
+    char name[] = "value";
+    PGresAttDesc attr {name, 0, 0, 1, query.types()[0], -1, -1};
+    if (!PQsetResultAttrs(res, 1, &attr)) {
+        throw std::runtime_error("PQsetResultAttrs failed");
+    }
+    const bool is_null = query.lengths()[0] == null_state_size;
+    const int length = is_null ? -1 : query.lengths()[0];
+    for (std::size_t row = 0; row < rows; ++row) {
+        if (!PQsetvalue(res, static_cast<int>(row), 0, const_cast<char*>(query.values()[0]), length)) {
+            throw std::runtime_error("PQsetvalue failed");
+        }
+    }
+    bytes = is_null ? 0 : static_cast<std::size_t>(length) * rows;
+    return ozo::result(native_result_handle(res));
+}
+
+struct codec_benchmark {
+    clock::duration min_duration;
+    bool first = true;
+
+    /**
+     * Calls f repeatedly for at least min_duration, f returns the number of items and bytes
+     * processed by the call.
+     */
+    template <typename F>
+    void run(std::string_view operation, std::string_view type, F f) {
+        std::size_t iterations = 0;
+        std::size_t items = 0;
+        std::size_t bytes = 0;
+        const auto start = clock::now();
+        auto finish = start;
+        do {
+            const auto [step_items, step_bytes] = f();
+            items += step_items;
+            bytes += step_bytes;
+            ++iterations;
+            finish = clock::now();
+        } while (finish - start < min_duration);
+        const auto seconds = std::chrono::duration_cast<double_s>(finish - start).count();
+        std::cout << (first ? "[\n" : ",\n")
+                  << "    {\"operation\": \"" << operation << "\", \"type\": \"" << type << "\", "
+                  << "\"iterations\": " << iterations << ", \"items\": " << items << ", "
+                  << "\"bytes\": " << bytes << ", \"seconds\": " << seconds << ", "
+                  << "\"items_per_second\": " << items / seconds << ", "
+                  << "\"bytes_per_second\": " << bytes / seconds << "}";
+        first = false;
+    }
+
+    ~codec_benchmark() {
+        std::cout << (first ? "[]\n" : "\n]\n");
+    }
+};
+
+template <typename T>
+void benchmark_recv(codec_benchmark& benchmark, const oid_map_type& oid_map, std::string_view type,
+        const T& value, std::size_t rows = 10000) {
+    std::size_t bytes = 0;
+    const auto res = make_result(oid_map, value, rows, bytes);
+    std::vector<std::tuple<T>> out;
+    out.reserve(rows);
+    benchmark.run("recv_result", type, [&] {
+        out.clear();
+        recv_result(res, oid_map, std::back_inserter(out));
+        return std::make_pair(out.size(), bytes);
+    });
+}
+
+template <typename ... Ts>
+void benchmark_binary_query(codec_benchmark& benchmark, const oid_map_type& oid_map, std::string_view type,
+        const Ts& ... params) {
+    const auto query = make_query("", params ...);
+    benchmark.run("binary_query", type, [&] {
+        std::size_t bytes = 0;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            const binary_query binary(query, oid_map);
+            for (std::size_t param = 0; param < sizeof...(Ts); ++param) {
+                bytes += std::max(binary.lengths()[param], 0);
+            }
+        }
+        return std::make_pair(std::size_t(1000), bytes);
+    });
+}
+
+} // namespace ozo::benchmark
+
+int main(int argc, char *argv[]) {
+    using namespace ozo::benchmark;
+
+    if (argc > 2) {
+        std::cerr << "Usage: " << argv[0] << " [<min duration of each benchmark in ms>]" << std::endl;
+        return 1;
+    }
+
+    const auto min_duration = std::chrono::milliseconds(argc > 1 ? std::atoi(argv[1]) : 1000);
+    const auto oid_map = make_oid_map();
+    const auto uuid = boost::uuids::random_generator()();
+    const std::string text(64, 'x');
+    const std::vector<char> bytes(1024, 'x');
+    const std::vector<std::int32_t> ints(32, 42);
+    const codec_composite composite {42, "composite", 0.5};
+
+    std::cout << std::setprecision(6) << std::fixed;
+
+    codec_benchmark benchmark {min_duration};
+
+    benchmark_recv(benchmark, oid_map, "int2", std::int16_t(42));
+    benchmark_recv(benchmark, oid_map, "int4", std::int32_t(42));
+    benchmark_recv(benchmark, oid_map, "int8", std::int64_t(42));
+    benchmark_recv(benchmark, oid_map, "float4", 0.5f);
+    benchmark_recv(benchmark, oid_map, "float8", 0.5);
+    benchmark_recv(benchmark, oid_map, "text", text);
+    benchmark_recv(benchmark, oid_map, "bytea", ozo::pg::bytea(bytes));
+    benchmark_recv(benchmark, oid_map, "uuid", uuid);
+    benchmark_recv(benchmark, oid_map, "int4[]", ints);
+    benchmark_recv(benchmark, oid_map, "composite", composite);
+    benchmark_recv(benchmark, oid_map, "nullable int8", __OZO_STD_OPTIONAL<std::int64_t>(42));
+    benchmark_recv(benchmark, oid_map, "nullable int8 null", __OZO_STD_OPTIONAL<std::int64_t>());
+
+    benchmark_binary_query(benchmark, oid_map, "int8", std::int64_t(42));
+    benchmark_binary_query(benchmark, oid_map, "int8, text, float8", std::int64_t(42), text, 0.5);
+    benchmark_binary_query(benchmark, oid_map, "uuid, int4[], nullable int8",
+        uuid, ints, __OZO_STD_OPTIONAL<std::int64_t>());
+    benchmark_binary_query(benchmark, oid_map, "composite", composite);
+    benchmark_binary_query(benchmark, oid_map, "bytea", ozo::pg::bytea(bytes));
+
+    return 0;
+}
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <ozo/asio.h>
+#include <ozo/io/binary_query.h>
+#include <ozo/query.h>
+#include <ozo/wire/protocol.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/write.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ozo::benchmark {
+
+/**
+ * Result which the fake server sends for a query: the same row repeated `rows` times.
+ * Messages are serialized once, so the server costs nearly nothing per row.
+ */
+struct canned_result {
+    std::vector<char> row_description;
+    std::vector<char> data_row;
+    std::size_t rows = 0;
+    std::string command_tag;
+};
+
+/**
+ * Makes a canned result with the columns of the given names and values, the values
+ * are encoded in the binary format with the oid map.
+ */
+template <typename OidMap, typename ... Ts>
+canned_result make_canned_result(const OidMap& oid_map, const std::vector<std::string>& names,
+        std::size_t rows, const Ts& ... values) {
+    static_assert(sizeof...(Ts) > 0, "a result should have at least one column");
+    const binary_query query(make_query("", values ...), oid_map);
+    const auto columns = static_cast<std::int16_t>(sizeof...(Ts));
+    if (names.size() != sizeof...(Ts)) {
+        throw std::invalid_argument("number of names does not match number of values");
+    }
+
+    canned_result retval;
+    wire::frontend::writer description{retval.row_description};
+    description.begin('T').int16(columns);
+    for (std::int16_t i = 0; i < columns; ++i) {
+        description.string(names[i]).int32(0).int16(0).int32(static_cast<std::int32_t>(query.types()[i]))
+            .int16(-1).int32(-1).int16(1);
+    }
+    description.end();
+
+    wire::frontend::writer row{retval.data_row};
+    row.begin('D').int16(columns);
+    for (std::int16_t i = 0; i < columns; ++i) {
+        if (query.lengths()[i] == null_state_size) {
+            row.int32(-1);
+        } else {
+            row.int32(query.lengths()[i]).bytes(query.values()[i], static_cast<std::size_t>(query.lengths()[i]));
+        }
+    }
+    row.end();
+
+    retval.rows = rows;
+    retval.command_tag = "SELECT " + std::to_string(rows);
+    return retval;
+}
+
+struct fake_server_config {
+    canned_result default_result; //!< result for queries without their own canned result
+    std::unordered_map<std::string, canned_result> results; //!< canned results by query text
+    std::chrono::steady_clock::duration delay {}; //!< delay injected before the result of each query
+    std::size_t threads = 1; //!< number of threads serving the connections
+};
+
+/**
+ * Local server which speaks enough of the PostgreSQL protocol v3 for ozo to make requests:
+ * startup with trust authentication, the extended query protocol with canned binary results,
+ * pipelined requests. Every query succeeds with the canned result for its text after the configured
+ * delay, so the benchmarks against it measure the client side costs only and are deterministic.
+ * It may also stand in for a database in tests which do not depend on the query semantics.
+ * It serves in its own threads until destroyed.
+ */
+class fake_server {
+public:
+    explicit fake_server(fake_server_config config)
+    : config_(std::move(config)) {
+        acceptor_.open(asio::ip::tcp::v4());
+        acceptor_.set_option(asio::ip::tcp::acceptor::reuse_address(true));
+        acceptor_.bind(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+        acceptor_.listen();
+        asio::spawn(io_, [this] (asio::yield_context yield) { accept(yield); });
+        for (std::size_t i = 0; i < std::max<std::size_t>(config_.threads, 1); ++i) {
+            threads_.emplace_back([this] { io_.run(); });
+        }
+    }
+
+    ~fake_server() {
+        io_.stop();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    unsigned short port() const {
+        return acceptor_.local_endpoint().port();
+    }
+
+    /**
+     * Connection string to connect to the server with libpq.
+     */
+    std::string conninfo() const {
+        return "host=127.0.0.1 port=" + std::to_string(port())
+            + " user=ozo dbname=ozo sslmode=disable gssencmode=disable";
+    }
+
+private:
+    using socket = asio::ip::tcp::socket;
+
+    struct session {
+        socket stream;
+        asio::steady_timer timer;
+        std::vector<char> in;
+        std::vector<char> out;
+        std::unordered_map<std::string, std::string> statements;
+        std::unordered_map<std::string, std::string> portals;
+
+        explicit session(socket stream)
+        : stream(std::move(stream)), timer(this->stream.get_executor()) {}
+    };
+
+    void accept(asio::yield_context yield) {
+        for (;;) {
+            error_code ec;
+            socket stream(io_);
+            acceptor_.async_accept(stream, yield[ec]);
+            if (ec) {
+                return;
+            }
+            stream.set_option(asio::ip::tcp::no_delay(true), ec);
+            auto s = std::make_shared<session>(std::move(stream));
+            asio::spawn(io_, [this, s] (asio::yield_context yield) {
+                try {
+                    serve(*s, yield);
+                } catch (const boost::coroutines::detail::forced_unwind&) {
+                    throw;
+                } catch (const std::exception& e) {
+                    std::cerr << "fake server session failed: " << e.what() << std::endl;
+                }
+            });
+        }
+    }
+
+    void serve(session& s, asio::yield_context yield) {
+        if (!startup(s, yield)) {
+            return;
+        }
+        for (;;) {
+            error_code ec;
+            const auto size = s.in.size();
+            s.in.resize(size + 64 * 1024);
+            const auto read = s.stream.async_read_some(asio::buffer(s.in.data() + size, 64 * 1024), yield[ec]);
+            s.in.resize(size + read);
+            if (ec) {
+                return;
+            }
+            std::size_t offset = 0;
+            wire::backend::message m;
+            while (const auto consumed = wire::backend::parse_message(s.in.data() + offset, s.in.size() - offset, m)) {
+                offset += consumed;
+                if (!handle(s, m, yield)) {
+                    return;
+                }
+            }
+            s.in.erase(s.in.begin(), s.in.begin() + offset);
+            if (!s.out.empty()) {
+                asio::async_write(s.stream, asio::buffer(s.out), yield[ec]);
+                s.out.clear();
+                if (ec) {
+                    return;
+                }
+            }
+        }
+    }
+
+    bool startup(session& s, asio::yield_context yield) {
+        constexpr std::int32_t ssl_request_code = 80877103;
+        constexpr std::int32_t gssenc_request_code = 80877104;
+        for (;;) {
+            std::int32_t length;
+            asio::async_read(s.stream, asio::buffer(&length, sizeof(length)), yield);
+            length = static_cast<std::int32_t>(ozo::detail::convert_from_big_endian(length));
+            if (length < 8) {
+                return false;
+            }
+            std::vector<char> body(static_cast<std::size_t>(length) - sizeof(length));
+            asio::async_read(s.stream, asio::buffer(body), yield);
+            std::int32_t code;
+            std::memcpy(&code, body.data(), sizeof(code));
+            code = static_cast<std::int32_t>(ozo::detail::convert_from_big_endian(code));
+            if (code == ssl_request_code || code == gssenc_request_code) {
+                asio::async_write(s.stream, asio::buffer("N", 1), yield);
+                continue;
+            }
+            if (code != wire::protocol_version) {
+                return false;
+            }
+            break;
+        }
+        wire::frontend::writer w{s.out};
+        w.begin('R').int32(0).end();
+        w.begin('S').string("server_version").string("15.0").end();
+        w.begin('S').string("server_encoding").string("UTF8").end();
+        w.begin('S').string("client_encoding").string("UTF8").end();
+        w.begin('S').string("integer_datetimes").string("on").end();
+        w.begin('S').string("standard_conforming_strings").string("on").end();
+        w.begin('K').int32(1).int32(1).end();
+        w.begin('Z').byte('I').end();
+        asio::async_write(s.stream, asio::buffer(s.out), yield);
+        s.out.clear();
+        return true;
+    }
+
+    const canned_result& result(const std::string& text) const {
+        const auto i = config_.results.find(text);
+        return i == config_.results.end() ? config_.default_result : i->second;
+    }
+
+    bool handle(session& s, const wire::backend::message& m, asio::yield_context yield) {
+        wire::backend::reader r{m};
+        wire::frontend::writer w{s.out};
+        switch (m.type) {
+            case 'P': {
+                const auto name = r.string();
+                s.statements[std::string(name)] = std::string(r.string());
+                w.begin('1').end();
+                return true;
+            }
+            case 'B': {
+                const auto portal = r.string();
+                s.portals[std::string(portal)] = s.statements[std::string(r.string())];
+                w.begin('2').end();
+                return true;
+            }
+            case 'D': {
+                const auto kind = r.byte();
+                const auto name = std::string(r.string());
+                const auto& text = kind == 'S' ? s.statements[name] : s.portals[name];
+                if (kind == 'S') {
+                    w.begin('t').int16(0).end();
+                }
+                const auto& description = result(text).row_description;
+                if (description.empty()) {
+                    w.begin('n').end();
+                } else {
+                    s.out.insert(s.out.end(), description.begin(), description.end());
+                }
+                return true;
+            }
+            case 'E': {
+                if (config_.delay != std::chrono::steady_clock::duration::zero()) {
+                    s.timer.expires_after(config_.delay);
+                    s.timer.async_wait(yield);
+                }
+                const auto& res = result(s.portals[std::string(r.string())]);
+                for (std::size_t i = 0; i < res.rows; ++i) {
+                    s.out.insert(s.out.end(), res.data_row.begin(), res.data_row.end());
+                }
+                w.begin('C').string(res.command_tag).end();
+                return true;
+            }
+            case 'C':
+                w.begin('3').end();
+                return true;
+            case 'H':
+                return true;
+            case 'S':
+                w.begin('Z').byte('I').end();
+                return true;
+            case 'Q':
+                w.begin('E').byte('S').string("ERROR").byte('C').string("0A000")
+                    .byte('M').string("simple query protocol is not supported").byte('\0').end();
+                w.begin('Z').byte('I').end();
+                return true;
+            case 'X':
+                return false;
+        }
+        w.begin('E').byte('S').string("FATAL").byte('C').string("08P01")
+            .byte('M').string(std::string("unexpected message type ") + m.type).byte('\0').end();
+        asio::async_write(s.stream, asio::buffer(s.out), yield);
+        return false;
+    }
+
+    fake_server_config config_;
+    asio::io_context io_;
+    asio::ip::tcp::acceptor acceptor_ {io_};
+    std::vector<std::thread> threads_;
+};
+
+} // namespace ozo::benchmark
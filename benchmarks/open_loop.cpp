@@ -0,0 +1,209 @@
+#include "benchmark.h"
+#include "fake_server.h"
+
+#include <ozo/connection_info.h>
+#include <ozo/connection_pool.h>
+#include <ozo/detail/histogram.h>
+#include <ozo/query_builder.h>
+#include <ozo/request.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace asio = boost::asio;
+
+using clock = std::chrono::steady_clock;
+using double_s = std::chrono::duration<double, std::ratio<1>>;
+using latency_histogram = ozo::detail::histogram_snapshot<7, 40>;
+
+struct open_loop_config {
+    double rate = 1000; // requests per second for all the threads
+    clock::duration duration = std::chrono::seconds(10);
+    std::size_t threads = 1;
+    std::size_t connections = 10;
+    std::size_t queue_capacity = 1000;
+    clock::duration request_timeout = std::chrono::seconds(1);
+};
+
+/**
+ * Issues requests of a thread at the fixed arrival rate regardless of completion of the
+ * previous ones. Request i of thread t is intended to be sent at start + (i * threads + t) / rate,
+ * latency is measured from the intended time, so a stall of the client or the pool is accounted
+ * for every request it delays, unlike with closed-loop benchmarks (coordinated omission).
+ * Runs within its io_context thread only.
+ */
+template <class Pool, class Query>
+class open_loop_generator {
+public:
+    open_loop_generator(asio::io_context& io, Pool& pool, const Query& query, const open_loop_config& config,
+            std::size_t token, clock::time_point start)
+    : io(io), pool(pool), query(query), config(config), token(token), start(start), timer(io) {}
+
+    void run() {
+        schedule();
+    }
+
+    latency_histogram latencies;
+    std::size_t sent = 0;
+    std::size_t errors = 0;
+    std::size_t max_in_flight = 0;
+    clock::time_point last_completion;
+
+private:
+    clock::time_point intended(std::size_t i) const {
+        const auto offset = (static_cast<double>(i) * config.threads + token) / config.rate;
+        return start + std::chrono::duration_cast<clock::duration>(double_s(offset));
+    }
+
+    void schedule() {
+        const auto next = intended(sent);
+        if (next - start >= config.duration) {
+            return;
+        }
+        timer.expires_at(next);
+        timer.async_wait([this] (ozo::error_code) {
+            // Requests which intended time has passed are sent at once to catch up the schedule.
+            const auto now = clock::now();
+            while (intended(sent) <= now && intended(sent) - start < config.duration) {
+                send(intended(sent++));
+            }
+            schedule();
+        });
+    }
+
+    void send(clock::time_point intended_time) {
+        max_in_flight = std::max(max_in_flight, ++in_flight);
+        const ozo::connection_pool_timeouts timeouts {config.request_timeout, config.request_timeout};
+        auto result = std::make_shared<ozo::result>();
+        ozo::request(ozo::make_connector(pool, io, timeouts), query, config.request_timeout, std::ref(*result),
+            [this, intended_time, result] (ozo::error_code ec, auto) {
+                last_completion = clock::now();
+                latencies.record(static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(last_completion - intended_time).count()));
+                if (ec) {
+                    ++errors;
+                }
+                --in_flight;
+            });
+    }
+
+    asio::io_context& io;
+    Pool& pool;
+    const Query& query;
+    const open_loop_config& config;
+    const std::size_t token;
+    const clock::time_point start;
+    asio::steady_timer timer;
+    std::size_t in_flight = 0;
+};
+
+template <class Query>
+void run_open_loop(const std::string& conn_string, const Query& query, const open_loop_config& config) {
+    using ozo::benchmark::operator <<;
+
+    std::cout << "rate=" << config.rate << " req/sec"
+        << " duration=" << config.duration
+        << " threads=" << config.threads
+        << " connections=" << config.connections
+        << " queue_capacity=" << config.queue_capacity << std::endl;
+
+    const ozo::connection_info<> connection_info(conn_string);
+    ozo::connection_pool_config pool_config;
+    pool_config.capacity = config.connections;
+    pool_config.queue_capacity = config.queue_capacity;
+    auto pool = ozo::make_connection_pool(connection_info, pool_config);
+    using generator = open_loop_generator<decltype(pool), Query>;
+
+    std::vector<std::unique_ptr<asio::io_context>> contexts;
+    std::vector<std::unique_ptr<generator>> generators;
+    const auto start = clock::now() + std::chrono::milliseconds(100);
+    for (std::size_t i = 0; i < config.threads; ++i) {
+        contexts.emplace_back(std::make_unique<asio::io_context>(1));
+        generators.emplace_back(std::make_unique<generator>(*contexts.back(), pool, query, config, i, start));
+        generators.back()->run();
+    }
+
+    std::vector<std::thread> threads;
+    for (const auto& io : contexts) {
+        threads.emplace_back([&io = *io] { io.run(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    latency_histogram latencies;
+    std::size_t sent = 0;
+    std::size_t errors = 0;
+    std::size_t max_in_flight = 0;
+    auto finish = start;
+    for (const auto& g : generators) {
+        latencies += g->latencies;
+        sent += g->sent;
+        errors += g->errors;
+        max_in_flight += g->max_in_flight;
+        finish = std::max(finish, g->last_completion);
+    }
+
+    const auto ns = [] (std::uint64_t v) { return clock::duration(std::chrono::nanoseconds(v)); };
+    const auto seconds = std::chrono::duration_cast<double_s>(finish - start).count();
+    std::cout << std::setprecision(4) << std::fixed
+        << "requests sent: " << sent << ", errors: " << errors << ", max in flight: " << max_in_flight << '\n'
+        << "achieved throughput: " << (sent - errors) / seconds << " req/sec" << '\n'
+        << "p50 latency: " << ns(latencies.percentile(50)) << '\n'
+        << "p99 latency: " << ns(latencies.percentile(99)) << '\n'
+        << "p99.9 latency: " << ns(latencies.percentile(99.9)) << '\n'
+        << "max latency: " << ns(latencies.max) << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    using namespace ozo::benchmark;
+    using namespace ozo::literals;
+
+    if (argc < 2 || argc > 7) {
+        std::cerr << "Usage: " << argv[0] << " <conninfo|fake> [<rate in req/sec> [<duration in sec> [<threads>"
+                  << " [<connections> [<queue capacity>]]]]]\n";
+        return 1;
+    }
+
+    open_loop_config config;
+    if (argc > 2) {
+        config.rate = std::atof(argv[2]);
+    }
+    if (argc > 3) {
+        config.duration = std::chrono::seconds(std::atoi(argv[3]));
+    }
+    if (argc > 4) {
+        config.threads = static_cast<std::size_t>(std::atoi(argv[4]));
+    }
+    if (argc > 5) {
+        config.connections = static_cast<std::size_t>(std::atoi(argv[5]));
+    }
+    if (argc > 6) {
+        config.queue_capacity = static_cast<std::size_t>(std::atoi(argv[6]));
+    }
+
+    std::unique_ptr<fake_server> server;
+    std::string conn_string(argv[1]);
+    if (conn_string == "fake") {
+        fake_server_config server_config;
+        server_config.default_result = make_canned_result(ozo::empty_oid_map{}, {"?column?"}, 1, std::int32_t(1));
+        server_config.delay = std::chrono::microseconds(100);
+        server = std::make_unique<fake_server>(std::move(server_config));
+        conn_string = server->conninfo();
+    }
+
+    run_open_loop(conn_string, "SELECT 1"_SQL.build(), config);
+
+    return 0;
+}
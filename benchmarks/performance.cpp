@@ -1,6 +1,8 @@
 #include "benchmark.h"
+#include "fake_server.h"
 
 #include <ozo/connection_info.h>
+#include <ozo/connection_multiplexer.h>
 #include <ozo/connection_pool.h>
 #include <ozo/request.h>
 #include <ozo/query_builder.h>
@@ -233,6 +235,32 @@ void use_connection_pool_and_parse_result_mult_connection(const std::string& con
     io.run();
 }
 
+template <std::size_t coroutines, class Query>
+void use_connection_multiplexer(const std::string& conn_string, Query query, std::size_t connections) {
+    std::cout << '\n' << __func__ << " coroutines=" << coroutines << " connections=" << connections << std::endl;
+
+    benchmark_t<coroutines> benchmark;
+    asio::io_context io(1);
+    const ozo::connection_info<> connection_info(conn_string);
+    ozo::connection_multiplexer_config config;
+    config.capacity = connections;
+    const auto mux = ozo::make_connection_multiplexer(connection_info, io, config);
+
+    for (std::size_t token = 0; token < coroutines; ++token) {
+        spawn(io, token, [&, token] (asio::yield_context yield) {
+            while (true) {
+                ozo::result result;
+                ozo::request(mux, query, request_timeout, std::ref(result), yield);
+                if (!benchmark.step(result.size(), token)) {
+                    break;
+                }
+            }
+        });
+    }
+
+    io.run();
+}
+
 struct context {
     asio::io_context io;
     boost::asio::executor_work_guard<boost::asio::io_context::executor_type> guard = boost::asio::make_work_guard(io);
@@ -301,14 +329,36 @@ int main(int argc, char **argv) {
     using namespace ozo::literals;
     using namespace hana::literals;
 
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <conninfo>\n";
+    if (argc < 2 || (std::string_view(argv[1]) != "fake" && argc > 2)) {
+        std::cerr << "Usage: " << argv[0] << " <conninfo>\n"
+                  << "       " << argv[0] << " fake [<delay in us>]\n";
         return 1;
     }
 
-    const std::string conn_string(argv[1]);
-
     const auto simple_query = "SELECT 1"_SQL.build();
+    const auto complex_query = (
+        "SELECT typname, typnamespace, typowner, typlen, typbyval, typcategory, "_SQL +
+        "typispreferred, typisdefined, typdelim, typrelid, typelem, typarray "_SQL +
+        "FROM pg_type WHERE typtypmod = "_SQL + -1 + " AND typisdefined = "_SQL + true
+    ).build();
+
+    // Fake server measures the client side costs only: it answers any query immediately or after
+    // the given delay with a canned result.
+    std::unique_ptr<fake_server> server;
+    std::string conn_string(argv[1]);
+    if (conn_string == "fake") {
+        fake_server_config config;
+        config.default_result = make_canned_result(ozo::empty_oid_map{}, {"?column?"}, 1, std::int32_t(1));
+        config.results.emplace(ozo::to_const_char(ozo::get_text(complex_query)),
+            make_canned_result(ozo::empty_oid_map{},
+                {"typname", "typnamespace", "typowner", "typlen", "typbyval", "typcategory",
+                 "typispreferred", "typisdefined", "typdelim", "typrelid", "typelem", "typarray"},
+                400, ozo::pg::name("int4"), ozo::oid_t(11), ozo::oid_t(10), std::int16_t(4), true, 'N',
+                false, true, ',', ozo::oid_t(0), ozo::oid_t(0), ozo::oid_t(1007)));
+        config.delay = std::chrono::microseconds(argc > 2 ? std::atoi(argv[2]) : 0);
+        server = std::make_unique<fake_server>(std::move(config));
+        conn_string = server->conninfo();
+    }
 
     std::cout << "\nquery: " << ozo::to_const_char(ozo::get_text(simple_query)) << std::endl;
     reuse_connection_info(conn_string, simple_query);
@@ -318,12 +368,9 @@ int main(int argc, char **argv) {
     use_connection_pool_mult_threads<2, 2>(conn_string, simple_query, 4, 0);
     use_connection_pool_mult_threads<2, 2>(conn_string, simple_query, 2, 4);
     use_connection_pool_and_parse_result<std::tuple<std::int32_t>>(conn_string, simple_query);
-
-    const auto complex_query = (
-        "SELECT typname, typnamespace, typowner, typlen, typbyval, typcategory, "_SQL +
-        "typispreferred, typisdefined, typdelim, typrelid, typelem, typarray "_SQL +
-        "FROM pg_type WHERE typtypmod = "_SQL + -1 + " AND typisdefined = "_SQL + true
-    ).build();
+    use_connection_pool_mult_connection<64>(conn_string, simple_query);
+    use_connection_multiplexer<64>(conn_string, simple_query, 1);
+    use_connection_multiplexer<64>(conn_string, simple_query, 4);
 
     std::cout << "\nquery: " << ozo::to_const_char(ozo::get_text(complex_query)) << std::endl;
     use_connection_pool(conn_string, complex_query);
@@ -0,0 +1,232 @@
+#include "benchmark.h"
+#include "fake_server.h"
+
+#include <ozo/connection_info.h>
+#include <ozo/connection_pool.h>
+#include <ozo/query_builder.h>
+#include <ozo/request.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+
+#include <sys/resource.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace asio = boost::asio;
+
+using clock = std::chrono::steady_clock;
+using double_s = std::chrono::duration<double, std::ratio<1>>;
+
+constexpr const std::chrono::seconds request_timeout(1);
+constexpr const ozo::connection_pool_timeouts pool_timeouts {std::chrono::seconds(1), std::chrono::seconds(1)};
+
+struct scaling_config {
+    std::size_t coroutines = 8; // per thread
+    clock::duration duration = std::chrono::seconds(5);
+};
+
+/**
+ * Totals of a benchmark run. Pool wait is the time spent in getting a connection from the pool,
+ * which includes waiting for the pool locks and for a free connection.
+ */
+struct scaling_stats {
+    std::mutex mutex;
+    std::size_t requests = 0;
+    std::size_t errors = 0;
+    clock::duration pool_wait {};
+    clock::duration cpu {};
+
+    void add(std::size_t requests_count, std::size_t errors_count, clock::duration wait) {
+        const std::lock_guard<std::mutex> lock(mutex);
+        requests += requests_count;
+        errors += errors_count;
+        pool_wait += wait;
+    }
+
+    void add_cpu(clock::duration value) {
+        const std::lock_guard<std::mutex> lock(mutex);
+        cpu += value;
+    }
+};
+
+/**
+ * CPU time consumed by the calling thread, so the time of the in-process fake server is not accounted.
+ */
+clock::duration thread_cpu_time() {
+    rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    const auto to_duration = [] (const timeval& v) {
+        return std::chrono::seconds(v.tv_sec) + std::chrono::microseconds(v.tv_usec);
+    };
+    return std::chrono::duration_cast<clock::duration>(to_duration(usage.ru_utime) + to_duration(usage.ru_stime));
+}
+
+template <class Pool, class Query>
+void spawn_clients(asio::io_context& io, Pool& pool, const Query& query, std::size_t coroutines,
+        clock::time_point deadline, scaling_stats& stats) {
+    for (std::size_t i = 0; i < coroutines; ++i) {
+        asio::spawn(io, [&, deadline] (asio::yield_context yield) {
+            std::size_t requests = 0;
+            std::size_t errors = 0;
+            clock::duration pool_wait {};
+            while (clock::now() < deadline) {
+                ozo::error_code ec;
+                const auto start = clock::now();
+                auto connection = ozo::get_connection(ozo::make_connector(pool, io, pool_timeouts), yield[ec]);
+                pool_wait += clock::now() - start;
+                if (!ec) {
+                    ozo::result result;
+                    ozo::request(connection, query, request_timeout, std::ref(result), yield[ec]);
+                }
+                ++requests;
+                errors += static_cast<bool>(ec);
+            }
+            stats.add(requests, errors, pool_wait);
+        });
+    }
+}
+
+void run_threads(std::vector<asio::io_context*> contexts, std::size_t threads, scaling_stats& stats) {
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([&io = *contexts[i % contexts.size()], &stats] {
+            const auto start = thread_cpu_time();
+            io.run();
+            stats.add_cpu(thread_cpu_time() - start);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+auto make_pool(const ozo::connection_info<>& connection_info, std::size_t capacity) {
+    ozo::connection_pool_config config;
+    config.capacity = capacity;
+    config.queue_capacity = 0;
+    return ozo::make_connection_pool(connection_info, config);
+}
+
+template <class Query>
+void shared_io_context(const ozo::connection_info<>& connection_info, const Query& query, std::size_t threads,
+        const scaling_config& config, scaling_stats& stats) {
+    asio::io_context io(static_cast<int>(threads));
+    auto pool = make_pool(connection_info, threads * config.coroutines);
+    spawn_clients(io, pool, query, threads * config.coroutines, clock::now() + config.duration, stats);
+    run_threads({&io}, threads, stats);
+}
+
+template <class Query>
+void shared_pool(const ozo::connection_info<>& connection_info, const Query& query, std::size_t threads,
+        const scaling_config& config, scaling_stats& stats) {
+    std::vector<std::unique_ptr<asio::io_context>> contexts;
+    auto pool = make_pool(connection_info, threads * config.coroutines);
+    const auto deadline = clock::now() + config.duration;
+    for (std::size_t i = 0; i < threads; ++i) {
+        contexts.emplace_back(std::make_unique<asio::io_context>(1));
+        spawn_clients(*contexts.back(), pool, query, config.coroutines, deadline, stats);
+    }
+    std::vector<asio::io_context*> ptrs;
+    for (const auto& io : contexts) {
+        ptrs.push_back(io.get());
+    }
+    run_threads(ptrs, threads, stats);
+}
+
+template <class Query>
+void per_thread_pools(const ozo::connection_info<>& connection_info, const Query& query, std::size_t threads,
+        const scaling_config& config, scaling_stats& stats) {
+    using pool_type = decltype(make_pool(connection_info, 0));
+    std::vector<std::unique_ptr<asio::io_context>> contexts;
+    std::vector<std::unique_ptr<pool_type>> pools;
+    const auto deadline = clock::now() + config.duration;
+    for (std::size_t i = 0; i < threads; ++i) {
+        contexts.emplace_back(std::make_unique<asio::io_context>(1));
+        pools.emplace_back(std::make_unique<pool_type>(make_pool(connection_info, config.coroutines)));
+        spawn_clients(*contexts.back(), *pools.back(), query, config.coroutines, deadline, stats);
+    }
+    std::vector<asio::io_context*> ptrs;
+    for (const auto& io : contexts) {
+        ptrs.push_back(io.get());
+    }
+    run_threads(ptrs, threads, stats);
+}
+
+template <class Topology>
+void run(std::string_view name, Topology topology, std::size_t threads, const scaling_config& config) {
+    using ozo::benchmark::operator <<;
+
+    scaling_stats stats;
+    const auto start = clock::now();
+    topology(threads, config, stats);
+    const auto seconds = std::chrono::duration_cast<double_s>(clock::now() - start).count();
+    const auto requests = std::max<std::size_t>(stats.requests, 1);
+    std::cout << std::setprecision(4) << std::fixed
+        << name << " threads=" << threads << " coroutines=" << threads * config.coroutines
+        << ": " << stats.requests / seconds << " req/sec"
+        << ", cpu per request " << stats.cpu / requests
+        << ", pool wait per request " << stats.pool_wait / requests
+        << ", errors " << stats.errors << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    using namespace ozo::benchmark;
+    using namespace ozo::literals;
+
+    if (argc < 2 || argc > 5) {
+        std::cerr << "Usage: " << argv[0] << " <conninfo|fake> [<max threads> [<coroutines per thread>"
+                  << " [<duration of each run in sec>]]]\n";
+        return 1;
+    }
+
+    const std::size_t max_threads = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2]))
+        : std::max(1u, std::thread::hardware_concurrency());
+    scaling_config config;
+    if (argc > 3) {
+        config.coroutines = static_cast<std::size_t>(std::atoi(argv[3]));
+    }
+    if (argc > 4) {
+        config.duration = std::chrono::seconds(std::atoi(argv[4]));
+    }
+
+    std::unique_ptr<fake_server> server;
+    std::string conn_string(argv[1]);
+    if (conn_string == "fake") {
+        fake_server_config server_config;
+        server_config.default_result = make_canned_result(ozo::empty_oid_map{}, {"?column?"}, 1, std::int32_t(1));
+        server_config.threads = max_threads;
+        server = std::make_unique<fake_server>(std::move(server_config));
+        conn_string = server->conninfo();
+    }
+
+    const ozo::connection_info<> connection_info(conn_string);
+    const auto query = "SELECT 1"_SQL.build();
+
+    std::vector<std::size_t> thread_counts;
+    for (std::size_t threads = 1; threads < max_threads; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    for (const auto threads : thread_counts) {
+        run("shared_io_context", [&] (auto&& ... args) { shared_io_context(connection_info, query, args ...); },
+            threads, config);
+        run("shared_pool", [&] (auto&& ... args) { shared_pool(connection_info, query, args ...); },
+            threads, config);
+        run("per_thread_pools", [&] (auto&& ... args) { per_thread_pools(connection_info, query, args ...); },
+            threads, config);
+    }
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <ozo/io/recv.h>
+#include <ozo/shortcuts.h>
+
+#include <functional>
+#include <utility>
+#include <iterator>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @ingroup group-requests-types
+ * @brief Rows which may refer to the data of the result they are received from.
+ *
+ * Columns of `std::string_view`, `ozo::pg::bytea_view` or `ozo::pg::jsonb_view` types are received
+ * without copying, they point into the result. The container owns the result together with the rows,
+ * so the views are valid as long as the container exists. Moving of the container keeps them valid.
+ *
+ * ### Example
+ *
+@code{cpp}
+const auto query = "SELECT id, document FROM documents"_SQL;
+
+ozo::borrowed_rows_of<std::int64_t, ozo::pg::jsonb_view> rows;
+
+ozo::request(conn_info[io], query, ozo::into(rows), boost::asio::use_future);
+
+for (const auto& [id, document] : rows) {
+    parse(document.raw_string());
+}
+@endcode
+ * @tparam Row --- type of a row, e.g. `std::tuple` or an adapted structure
+ * @tparam Result --- type of the result
+ */
+template <typename Row, typename Result = result>
+class borrowed_rows {
+public:
+    using value_type = Row;
+    using result_type = Result;
+    using container_type = std::vector<Row>;
+    using const_iterator = typename container_type::const_iterator;
+    using iterator = const_iterator;
+
+    borrowed_rows() = default;
+    borrowed_rows(borrowed_rows&&) = default;
+    borrowed_rows& operator =(borrowed_rows&&) = default;
+
+    borrowed_rows(const borrowed_rows&) = delete;
+    borrowed_rows& operator =(const borrowed_rows&) = delete;
+
+    /**
+     * @brief Takes ownership of the result and receives rows from it.
+     *
+     * @param res --- result to receive rows from.
+     * @param oid_map --- #OidMap to check oids of the columns.
+     */
+    template <typename M>
+    void assign(result_type&& res, const oid_map_t<M>& oid_map) {
+        rows_.clear();
+        result_ = std::move(res);
+        rows_.reserve(result_.size());
+        detail::recv_rows(std::as_const(result_), oid_map, std::back_inserter(rows_));
+    }
+
+    const result_type& result() const noexcept { return result_; }
+
+    const_iterator begin() const noexcept { return rows_.begin(); }
+    const_iterator end() const noexcept { return rows_.end(); }
+    std::size_t size() const noexcept { return rows_.size(); }
+    bool empty() const noexcept { return rows_.empty(); }
+    const Row& operator [](std::size_t i) const noexcept { return rows_[i]; }
+
+private:
+    result_type result_;
+    container_type rows_;
+};
+
+/**
+ * @ingroup group-requests-types
+ * @brief Shortcut for `ozo::borrowed_rows` of row tuples.
+ *
+ * @tparam Ts --- types of columns in result
+ */
+template <typename ... Ts>
+using borrowed_rows_of = borrowed_rows<typed_row<Ts...>>;
+
+template <typename T, typename M, typename Row>
+borrowed_rows<Row, basic_result<T>>& recv_result(basic_result<T>& in, const oid_map_t<M>& oid_map,
+        borrowed_rows<Row, basic_result<T>>& out) {
+    out.assign(std::move(in), oid_map);
+    return out;
+}
+
+template <typename T, typename M, typename Row>
+borrowed_rows<Row, basic_result<T>>& recv_result(basic_result<T>& in, const oid_map_t<M>& oid_map,
+        std::reference_wrapper<borrowed_rows<Row, basic_result<T>>> out) {
+    return recv_result(in, oid_map, out.get());
+}
+
+/**
+ * @ingroup group-requests-functions
+ * @brief Shortcut for create reference wrapper for `ozo::borrowed_rows`.
+ *
+ * @param v --- `ozo::borrowed_rows` object for the result and rows.
+ */
+template <typename Row, typename Result>
+constexpr auto into(borrowed_rows<Row, Result>& v) { return std::ref(v);}
+
+} // namespace ozo
@@ -13,6 +13,7 @@
 #include <ozo/impl/connection.h>
 
 #include <boost/asio/dispatch.hpp>
+#include <boost/asio/system_executor.hpp>
 
 namespace ozo {
 
@@ -301,6 +302,26 @@ constexpr detail::result_of<get_connection_timer_impl, T> get_connection_timer(T
 }
 #endif
 
+namespace detail {
+
+template <typename T, typename = std::void_t<>>
+struct get_statistics_impl {
+    template <typename Conn>
+    constexpr static no_statistics apply(Conn&&) noexcept {
+        return {};
+    }
+};
+
+template <typename T>
+struct get_statistics_impl<T, std::void_t<decltype(std::declval<T&>().statistics_)>> {
+    template <typename Conn>
+    constexpr static auto apply(Conn&& c) noexcept -> decltype((c.statistics_)) {
+        return c.statistics_;
+    }
+};
+
+} // namespace detail
+
 template <typename, typename = std::void_t<>>
 struct is_connection : std::false_type {};
 template <typename T>
@@ -586,7 +607,7 @@ inline decltype(auto) get_oid_map(T&& conn) noexcept {
 /**
  * @brief Access to a Connection statistics
  *
- * @note This feature is not implemented yet
+ * See @ref group-statistics for details.
  *
  * Please be sure that the connection  is not in the null state via
  * `ozo::is_null_recursive()` function.
@@ -597,7 +618,8 @@ inline decltype(auto) get_oid_map(T&& conn) noexcept {
 template <typename T>
 inline decltype(auto) get_statistics(T&& conn) noexcept {
     static_assert(Connection<T>, "T must be a Connection");
-    return get_connection_statistics(unwrap_connection(std::forward<T>(conn)));
+    decltype(auto) c = unwrap_connection(std::forward<T>(conn));
+    return detail::get_statistics_impl<std::decay_t<decltype(c)>>::apply(c);
 }
 
 /**
@@ -898,6 +920,41 @@ struct connection_provider_traits {
 template <typename T>
 constexpr auto ConnectionProvider = is_connection_provider<std::decay_t<T>>::value;
 
+namespace detail {
+
+template <typename T, typename = std::void_t<>>
+struct has_get_executor_member : std::false_type {};
+
+template <typename T>
+struct has_get_executor_member<T, std::void_t<decltype(std::declval<const T&>().get_executor())>>
+    : std::true_type {};
+
+} // namespace detail
+
+/**
+ * @brief Executor of the `io_context` a #ConnectionProvider provides connections for
+ *
+ * It is the default executor of handlers of operations which may complete without a connection,
+ * e.g. with a shared or a cached result. It is `ozo::get_executor()` of the connection for
+ * a #Connection, the result of `get_executor()` member function for a provider which has one,
+ * e.g. `ozo::connection_provider`, and `boost::asio::system_executor` otherwise.
+ *
+ * @param provider --- #ConnectionProvider object
+ * @return executor of the provider
+ * @ingroup group-connection-functions
+ */
+template <typename T>
+inline auto get_provider_executor(T& provider) noexcept {
+    static_assert(ConnectionProvider<T>, "T is not a ConnectionProvider concept");
+    if constexpr (Connection<T>) {
+        return get_executor(provider);
+    } else if constexpr (detail::has_get_executor_member<T>::value) {
+        return provider.get_executor();
+    } else {
+        return asio::system_executor{};
+    }
+}
+
 #ifdef OZO_DOCUMENTATION
 /**
  * @brief Get a #Connection from #ConnectionProvider
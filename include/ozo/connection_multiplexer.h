@@ -0,0 +1,109 @@
+#pragma once
+
+#include <ozo/impl/multiplexer.h>
+#include <ozo/connection_info.h>
+
+namespace ozo {
+
+/**
+ * @brief Connection multiplexer
+ * @ingroup group-connection-types
+ *
+ * #ConnectionProvider which shares a small set of physical connections among many concurrent
+ * callers, like an in-client transaction pooler. Requests made via the multiplexer are pipelined
+ * with requests of other callers on the least loaded physical connection, a new physical connection
+ * is established while the number of connections is below `connection_multiplexer_config::capacity`
+ * and all of them are busy. A physical connection is pinned for a transaction only: `ozo::begin()`
+ * waits until the requests sent via the connection are completed and gets an exclusive handle to it;
+ * the connection is shared again when the last copy of the handle returned by `ozo::commit()` or
+ * `ozo::rollback()` is destroyed. A connection left within a transaction block is closed then.
+ *
+ * Requests via the multiplexer require libpq pipeline mode (libpq 14 or later). Copies of the
+ * multiplexer share the connections. The time constraint of a request limits the time the caller
+ * waits for a connection, including the wait for a pinned one, and for a result; an already sent
+ * query can not be cancelled, so its result is discarded.
+ *
+ * Requests are flushed to a connection as soon as they are made by default. With
+ * `connection_multiplexer_config::batch_window` set the requests arriving within the window are
+ * collected and sent with a single flush, which trades a bounded latency for
+ * fewer syscalls and packets under load. A zero window collects the requests made within the
+ * current event loop tick, `connection_multiplexer_config::batch_size` flushes a full batch
+ * before the window ends. Requests are balanced across the connections by load, which alone
+ * would spread them so that batches rarely form, so a connection collecting a batch gets the new
+ * requests until the batch is flushed. With capacity 1 the multiplexer is a single connection batcher.
+ *
+ * @warning Do not execute transaction control statements like BEGIN via a shared handle given by
+ * `ozo::get_connection()` or a request completion handler, use `ozo::begin()` instead.
+ *
+ * @code
+ozo::connection_multiplexer mux(ozo::connection_info(conn_str), io, {.capacity = 8});
+for (int i = 0; i < 1000; ++i) {
+    boost::asio::spawn(io, [mux] (auto yield) {
+        ozo::rows_of<std::int64_t> rows;
+        ozo::request(mux, "SELECT 1"_SQL, ozo::into(rows), yield); // shares one of 8 connections
+        auto transaction = ozo::begin(mux, yield); // pins a connection
+        // ...
+    });
+}
+ * @endcode
+ *
+ * @tparam Source --- #ConnectionSource of the physical connections.
+ */
+template <typename Source>
+class connection_multiplexer {
+public:
+    using connection_type = impl::multiplexed_connection<Source>;
+
+    connection_multiplexer(Source source, io_context& io, const connection_multiplexer_config& config = {})
+    : impl_(std::make_shared<impl::multiplexer_state<Source>>(std::move(source), io, config)) {}
+
+    /**
+     * Provides a shared handle to the least loaded physical connection, the handle is ready
+     * when the connection is established.
+     */
+    template <typename TimeConstraint, typename Handler>
+    void async_get_connection(TimeConstraint t, Handler&& handler) const {
+        impl_->select()->async_acquire(t, std::forward<Handler>(handler));
+    }
+
+    /**
+     * #ConnectionProvider of exclusive handles which pin a physical connection.
+     */
+    auto exclusive() const {
+        return exclusive_provider {impl_};
+    }
+
+    /**
+     * Number of physical connections opened by the multiplexer.
+     */
+    std::size_t size() const {
+        return impl_->size();
+    }
+
+private:
+    struct exclusive_provider {
+        using connection_type = impl::multiplexed_connection<Source>;
+
+        std::shared_ptr<impl::multiplexer_state<Source>> impl_;
+
+        template <typename TimeConstraint, typename Handler>
+        void async_get_connection(TimeConstraint t, Handler&& handler) const {
+            impl_->select()->async_pin(t, std::forward<Handler>(handler));
+        }
+    };
+
+    std::shared_ptr<impl::multiplexer_state<Source>> impl_;
+};
+
+template <typename Source>
+auto make_connection_multiplexer(Source&& source, io_context& io, const connection_multiplexer_config& config = {}) {
+    static_assert(ConnectionSource<Source>, "is not a ConnectionSource");
+    return connection_multiplexer<std::decay_t<Source>>{std::forward<Source>(source), io, config};
+}
+
+#ifdef LIBPQ_HAS_PIPELINING
+static_assert(ConnectionProvider<connection_multiplexer<connection_info<>>>, "is not a ConnectionProvider");
+static_assert(Connection<impl::multiplexed_connection<connection_info<>>>, "is not a Connection");
+#endif
+
+} // namespace ozo
@@ -105,6 +105,14 @@ public:
         std::forward<Source>(source_)(io_, std::move(t), std::forward<Handler>(h));
     }
 
+    /**
+     * Executor of the `io_context` the connections are provided for,
+     * see `ozo::get_provider_executor()`.
+     */
+    auto get_executor() const noexcept {
+        return io_.get_executor();
+    }
+
 private:
     source_type source_;
     io_context& io_;
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <ozo/impl/cursor.h>
+
+namespace ozo {
+
+/**
+ * @brief Server-side cursor
+ * @ingroup group-requests-types
+ *
+ * Handle to a binary cursor declared by `ozo::declare_cursor()` within a transaction. Rows are
+ * provided one by one by `ozo::fetch()` and decoded with `ozo::recv_row()` into `Row`. The next
+ * FETCH batch is requested while the consumer processes the current one, so the network latency
+ * is hidden for large ordered scans which can not use COPY. The batch size adapts to the consumer
+ * speed within the `ozo::cursor_config` bounds.
+ *
+ * The cursor owns the transaction until `ozo::close_cursor()` which returns it. Copies of
+ * the cursor refer to the same cursor. Operations on a cursor must not be concurrent.
+ *
+ * @code
+auto transaction = ozo::begin(conn_info[io], yield);
+auto cursor = ozo::declare_cursor<std::tuple<std::int64_t, std::string>>(std::move(transaction),
+    "SELECT id, name FROM users ORDER BY id"_SQL, yield);
+while (auto row = ozo::fetch(cursor, yield)) {
+    process(*row);
+}
+transaction = ozo::close_cursor(cursor, yield);
+ozo::commit(std::move(transaction), yield);
+ * @endcode
+ *
+ * @tparam Row --- type of a row to decode, a type applicable to `ozo::recv_row()`.
+ * @tparam Transaction --- type of the transaction the cursor is declared within.
+ */
+template <typename Row, typename Transaction>
+class cursor {
+public:
+    using row_type = Row;
+    using transaction_type = Transaction;
+
+    cursor() = default;
+
+    explicit cursor(std::shared_ptr<impl::cursor_state<Row, Transaction>> impl)
+    : impl_(std::move(impl)) {}
+
+    /**
+     * Name of the cursor in the database.
+     */
+    const std::string& name() const noexcept { return impl_->name(); }
+
+    /**
+     * Number of rows the next FETCH requests.
+     */
+    std::size_t batch_size() const noexcept { return impl_->batch_size(); }
+
+    explicit operator bool () const noexcept { return impl_ != nullptr; }
+
+    std::shared_ptr<impl::cursor_state<Row, Transaction>> impl_;
+};
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Declares a cursor for the query within the transaction
+ *
+ * Declares a `BINARY NO SCROLL` cursor and requests the first batch of rows. The completion
+ * handler gets the cursor even on error, `ozo::close_cursor()` returns the transaction then.
+ *
+ * @tparam Row --- type of a row to decode.
+ * @param transaction --- transaction from `ozo::begin()`.
+ * @param query --- #Query or `ozo::query_builder` object.
+ * @param config --- `ozo::cursor_config` of batch sizes, optional.
+ * @param time_constraint --- #TimeConstraint of the DECLARE statement and the FETCH of the first batch.
+ * @param token --- operation #CompletionToken with `void(ozo::error_code, ozo::cursor<Row, Transaction>)` signature.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename Row, typename Transaction, typename Query, typename TimeConstraint, typename CompletionToken>
+decltype(auto) declare_cursor(Transaction&& transaction, Query&& query, const cursor_config& config,
+        TimeConstraint time_constraint, CompletionToken&& token);
+
+/**
+ * @brief Provides the next row of the cursor
+ *
+ * The completion handler gets an empty optional when all the rows are fetched.
+ * If a row can not be received into `Row` the handler gets `ozo::error::bad_result_process`
+ * and the cursor fails, so the following calls get the same error.
+ * The time constraint limits the FETCH of the next batch if the call issues one;
+ * the FETCH already in flight is not affected.
+ *
+ * @param cursor --- `ozo::cursor` object.
+ * @param time_constraint --- #TimeConstraint of the FETCH the call issues, optional.
+ * @param token --- operation #CompletionToken with `void(ozo::error_code, std::optional<Row>)` signature.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename Row, typename Transaction, typename TimeConstraint, typename CompletionToken>
+decltype(auto) fetch(const cursor<Row, Transaction>& cursor, TimeConstraint time_constraint, CompletionToken&& token);
+
+/**
+ * @brief Closes the cursor and provides the transaction back
+ *
+ * Waits for the FETCH in flight and executes `CLOSE`. If the cursor has failed the
+ * transaction is provided with the error and no statement is executed.
+ *
+ * @param cursor --- `ozo::cursor` object.
+ * @param time_constraint --- #TimeConstraint of the CLOSE statement, optional.
+ * @param token --- operation #CompletionToken with `void(ozo::error_code, Transaction)` signature.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename Row, typename Transaction, typename TimeConstraint, typename CompletionToken>
+decltype(auto) close_cursor(const cursor<Row, Transaction>& cursor, TimeConstraint time_constraint,
+        CompletionToken&& token);
+#else
+template <typename Row>
+struct declare_cursor_op {
+    template <typename T, typename Q, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (T&& transaction, Q&& query, const cursor_config& config,
+            TimeConstraint t, CompletionToken&& token) const {
+        static_assert(Connection<T>, "transaction should be a Connection");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        using transaction_type = std::decay_t<T>;
+        using cursor_type = cursor<Row, transaction_type>;
+        using signature_t = void (error_code, cursor_type);
+        async_completion<CompletionToken, signature_t> init(token);
+
+        auto name = impl::make_cursor_name();
+        auto declare = impl::make_declare_cursor_query(name, query);
+        auto state = std::make_shared<impl::cursor_state<Row, transaction_type>>(transaction, std::move(name), config);
+        impl::async_execute(std::forward<T>(transaction), std::move(declare), t,
+            asio::bind_executor(state->get_executor(),
+                [state, t, handler = std::move(init.completion_handler)] (error_code ec, transaction_type transaction) mutable {
+                    state->start(ec, std::move(transaction), t);
+                    asio::dispatch(detail::bind(std::move(handler), std::move(ec), cursor_type{std::move(state)}));
+                }));
+
+        return init.result.get();
+    }
+
+    template <typename T, typename Q, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (T&& transaction, Q&& query, TimeConstraint t, CompletionToken&& token) const {
+        return (*this)(std::forward<T>(transaction), std::forward<Q>(query), cursor_config{}, t,
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename T, typename Q, typename CompletionToken>
+    decltype(auto) operator() (T&& transaction, Q&& query, CompletionToken&& token) const {
+        return (*this)(std::forward<T>(transaction), std::forward<Q>(query), cursor_config{}, none,
+            std::forward<CompletionToken>(token));
+    }
+};
+
+template <typename Row>
+constexpr declare_cursor_op<Row> declare_cursor;
+
+struct fetch_op {
+    template <typename Row, typename Transaction, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (const cursor<Row, Transaction>& cursor, TimeConstraint t, CompletionToken&& token) const {
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        using signature_t = void (error_code, __OZO_STD_OPTIONAL<Row>);
+        async_completion<CompletionToken, signature_t> init(token);
+
+        asio::dispatch(cursor.impl_->get_executor(),
+            [state = cursor.impl_, t, handler = std::move(init.completion_handler)] () mutable {
+                state->next(t, std::move(handler));
+            });
+
+        return init.result.get();
+    }
+
+    template <typename Row, typename Transaction, typename CompletionToken>
+    decltype(auto) operator() (const cursor<Row, Transaction>& cursor, CompletionToken&& token) const {
+        return (*this)(cursor, none, std::forward<CompletionToken>(token));
+    }
+};
+
+constexpr fetch_op fetch;
+
+struct close_cursor_op {
+    template <typename Row, typename Transaction, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (const cursor<Row, Transaction>& cursor, TimeConstraint t, CompletionToken&& token) const {
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        using signature_t = void (error_code, Transaction);
+        async_completion<CompletionToken, signature_t> init(token);
+
+        asio::dispatch(cursor.impl_->get_executor(),
+            [state = cursor.impl_, t, handler = std::move(init.completion_handler)] () mutable {
+                state->close(t, std::move(handler));
+            });
+
+        return init.result.get();
+    }
+
+    template <typename Row, typename Transaction, typename CompletionToken>
+    decltype(auto) operator() (const cursor<Row, Transaction>& cursor, CompletionToken&& token) const {
+        return (*this)(cursor, none, std::forward<CompletionToken>(token));
+    }
+};
+
+constexpr close_cursor_op close_cursor;
+#endif
+
+} // namespace ozo
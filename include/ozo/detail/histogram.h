@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace ozo::detail {
+
+/**
+ * Log-linear bucketing of non-negative integer values like HdrHistogram does.
+ * Each power of two range is divided into 2^SubBucketBits linear sub-buckets,
+ * so relative error of the value reported for a bucket is less than
+ * 1 / 2^SubBucketBits. Values greater or equal to 2^MaxBits fall into the last bucket.
+ */
+template <std::size_t SubBucketBits, std::size_t MaxBits>
+struct log_linear_buckets {
+    static_assert(SubBucketBits > 0 && SubBucketBits < MaxBits && MaxBits < 64, "invalid histogram precision");
+
+    static constexpr std::size_t sub_buckets = std::size_t(1) << SubBucketBits;
+    static constexpr std::size_t size = (MaxBits - SubBucketBits + 1) * sub_buckets;
+
+    static constexpr std::size_t index(std::uint64_t v) noexcept {
+        if (v < sub_buckets) {
+            return static_cast<std::size_t>(v);
+        }
+        const auto msb = static_cast<std::size_t>(63 - __builtin_clzll(v));
+        if (msb >= MaxBits) {
+            return size - 1;
+        }
+        const auto shift = msb - SubBucketBits;
+        return (shift + 1) * sub_buckets + static_cast<std::size_t>(v >> shift) - sub_buckets;
+    }
+
+    static constexpr std::uint64_t lowest_value(std::size_t i) noexcept {
+        if (i < sub_buckets) {
+            return i;
+        }
+        const auto shift = i / sub_buckets - 1;
+        return static_cast<std::uint64_t>(i % sub_buckets + sub_buckets) << shift;
+    }
+
+    static constexpr std::uint64_t highest_value(std::size_t i) noexcept {
+        return i + 1 < size ? lowest_value(i + 1) - 1 : ~std::uint64_t(0);
+    }
+};
+
+/**
+ * Plain copy of a histogram state. Used to read, merge and report histograms.
+ */
+template <std::size_t SubBucketBits = 4, std::size_t MaxBits = 40>
+struct histogram_snapshot {
+    using buckets = log_linear_buckets<SubBucketBits, MaxBits>;
+
+    std::vector<std::uint64_t> counts = std::vector<std::uint64_t>(buckets::size);
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    std::uint64_t max = 0;
+
+    void record(std::uint64_t v, std::uint64_t n = 1) noexcept {
+        counts[buckets::index(v)] += n;
+        count += n;
+        sum += v * n;
+        max = std::max(max, v);
+    }
+
+    histogram_snapshot& operator +=(const histogram_snapshot& rhs) noexcept {
+        for (std::size_t i = 0; i < counts.size(); ++i) {
+            counts[i] += rhs.counts[i];
+        }
+        count += rhs.count;
+        sum += rhs.sum;
+        max = std::max(max, rhs.max);
+        return *this;
+    }
+
+    std::uint64_t mean() const noexcept {
+        return count ? sum / count : 0;
+    }
+
+    /**
+     * Value at the given percentile, e.g. 99.9. Returns the highest value
+     * equivalent to the bucket the percentile falls into but not greater
+     * than the maximum value recorded.
+     */
+    std::uint64_t percentile(double p) const noexcept {
+        if (!count) {
+            return 0;
+        }
+        const auto rank = std::max<std::uint64_t>(1,
+            static_cast<std::uint64_t>(static_cast<double>(count) * std::clamp(p, 0.0, 100.0) / 100.0 + 0.5));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return std::min(buckets::highest_value(i), max);
+            }
+        }
+        return max;
+    }
+};
+
+/**
+ * Lock-free histogram. Recording is wait-free except the maximum value
+ * update, all the operations use relaxed memory order, so a snapshot made
+ * concurrently with recording may be slightly inconsistent.
+ */
+template <std::size_t SubBucketBits = 4, std::size_t MaxBits = 40>
+class histogram {
+public:
+    using buckets = log_linear_buckets<SubBucketBits, MaxBits>;
+    using snapshot_type = histogram_snapshot<SubBucketBits, MaxBits>;
+
+    histogram() noexcept {
+        for (auto& v : counts_) {
+            v.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    histogram(const histogram&) = delete;
+    histogram& operator =(const histogram&) = delete;
+
+    void record(std::uint64_t v) noexcept {
+        counts_[buckets::index(v)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(v, std::memory_order_relaxed);
+        auto max = max_.load(std::memory_order_relaxed);
+        while (v > max && !max_.compare_exchange_weak(max, v, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+
+    snapshot_type snapshot() const {
+        snapshot_type retval;
+        for (std::size_t i = 0; i < counts_.size(); ++i) {
+            retval.counts[i] = counts_[i].load(std::memory_order_relaxed);
+        }
+        retval.count = count_.load(std::memory_order_relaxed);
+        retval.sum = sum_.load(std::memory_order_relaxed);
+        retval.max = max_.load(std::memory_order_relaxed);
+        return retval;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, buckets::size> counts_;
+    std::atomic<std::uint64_t> count_ {0};
+    std::atomic<std::uint64_t> sum_ {0};
+    std::atomic<std::uint64_t> max_ {0};
+};
+
+/**
+ * Lock-free fixed capacity table of counters for small integer keys.
+ * Increments for keys which do not fit into the table are accounted
+ * under the `overflow` key.
+ */
+template <std::size_t Capacity>
+class counter_table {
+public:
+    static constexpr std::uint32_t overflow = ~std::uint32_t(0) - 1;
+
+    counter_table() noexcept {
+        for (auto& s : slots_) {
+            s.key.store(empty, std::memory_order_relaxed);
+            s.count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    counter_table(const counter_table&) = delete;
+    counter_table& operator =(const counter_table&) = delete;
+
+    void increment(std::uint32_t key) noexcept {
+        const auto start = key % (Capacity - 1);
+        for (std::size_t i = 0; i < Capacity - 1; ++i) {
+            auto& slot = slots_[(start + i) % (Capacity - 1)];
+            auto current = slot.key.load(std::memory_order_acquire);
+            if (current == empty && slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                current = key;
+            }
+            if (current == key) {
+                slot.count.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        auto& last = slots_[Capacity - 1];
+        last.key.store(overflow, std::memory_order_relaxed);
+        last.count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template <typename Visitor>
+    void for_each(Visitor&& visitor) const {
+        for (const auto& s : slots_) {
+            const auto key = s.key.load(std::memory_order_acquire);
+            const auto count = s.count.load(std::memory_order_relaxed);
+            if (key != empty && count) {
+                visitor(key, count);
+            }
+        }
+    }
+
+private:
+    static constexpr std::uint32_t empty = ~std::uint32_t(0);
+
+    struct slot {
+        std::atomic<std::uint32_t> key;
+        std::atomic<std::uint64_t> count;
+    };
+
+    std::array<slot, Capacity> slots_;
+};
+
+} // namespace ozo::detail
@@ -4,10 +4,6 @@
 
 namespace ozo::detail {
 
-struct istream : std::istream {
-    using std::istream::istream;
-};
-
 class istreambuf_view : public std::streambuf {
 public:
     istreambuf_view(const char* data, size_t len) {
@@ -18,6 +14,19 @@ public:
         setg(buf, buf, buf + len);
     }
 
+    /**
+     * Skips the next n characters and returns pointer to them within the viewed
+     * data, or nullptr if there are not enough characters.
+     */
+    const char* take(std::size_t n) noexcept {
+        if (static_cast<std::size_t>(egptr() - gptr()) < n) {
+            return nullptr;
+        }
+        const char* retval = gptr();
+        gbump(static_cast<int>(n));
+        return retval;
+    }
+
 protected:
     std::streamsize xsgetn(char* s, std::streamsize n) override {
         n = std::min(n, egptr() - gptr());
@@ -27,4 +36,19 @@ protected:
     }
 };
 
+struct istream : std::istream {
+    using std::istream::istream;
+
+    istream(istreambuf_view* buf) : std::istream(buf), view_(buf) {}
+
+    /**
+     * Buffer of the stream if it is a view of the data, e.g. of a result value,
+     * which allows to refer to the data instead of copying it.
+     */
+    istreambuf_view* view() const noexcept { return view_; }
+
+private:
+    istreambuf_view* view_ = nullptr;
+};
+
 } // namespace ozo::detail
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace ozo::detail {
+
+/**
+ * Minimal MD5 (RFC 1321) implementation. It is needed for the PostgreSQL
+ * md5 password authentication only and must not be used for anything else.
+ */
+class md5 {
+public:
+    using digest_type = std::array<std::uint8_t, 16>;
+
+    md5& update(std::string_view data) noexcept {
+        for (const char c : data) {
+            buffer_[buffer_size_++] = static_cast<std::uint8_t>(c);
+            if (buffer_size_ == buffer_.size()) {
+                transform();
+                buffer_size_ = 0;
+            }
+        }
+        length_ += data.size();
+        return *this;
+    }
+
+    digest_type digest() noexcept {
+        const std::uint64_t bits = length_ * 8;
+        const char pad_start = char(0x80);
+        update(std::string_view(&pad_start, 1));
+        const char zero = 0;
+        while (buffer_size_ != 56) {
+            update(std::string_view(&zero, 1));
+        }
+        for (int i = 0; i < 8; ++i) {
+            buffer_[buffer_size_++] = static_cast<std::uint8_t>(bits >> (8 * i));
+        }
+        transform();
+        digest_type result;
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                result[i * 4 + j] = static_cast<std::uint8_t>(state_[i] >> (8 * j));
+            }
+        }
+        return result;
+    }
+
+    std::string hex_digest() noexcept {
+        static constexpr const char* digits = "0123456789abcdef";
+        std::string result;
+        result.reserve(32);
+        for (const auto v : digest()) {
+            result.push_back(digits[v >> 4]);
+            result.push_back(digits[v & 0x0f]);
+        }
+        return result;
+    }
+
+private:
+    static constexpr std::uint32_t rotate_left(std::uint32_t x, int c) noexcept {
+        return (x << c) | (x >> (32 - c));
+    }
+
+    void transform() noexcept {
+        static constexpr std::uint32_t k[64] = {
+            0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+            0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+            0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+            0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+            0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+            0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+            0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+            0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+        };
+        static constexpr int r[64] = {
+            7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+            5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+            4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+            6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
+        };
+
+        std::uint32_t w[16];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = std::uint32_t(buffer_[i * 4])
+                | std::uint32_t(buffer_[i * 4 + 1]) << 8
+                | std::uint32_t(buffer_[i * 4 + 2]) << 16
+                | std::uint32_t(buffer_[i * 4 + 3]) << 24;
+        }
+
+        auto a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+        for (int i = 0; i < 64; ++i) {
+            std::uint32_t f;
+            int g;
+            if (i < 16) {
+                f = (b & c) | (~b & d);
+                g = i;
+            } else if (i < 32) {
+                f = (d & b) | (~d & c);
+                g = (5 * i + 1) % 16;
+            } else if (i < 48) {
+                f = b ^ c ^ d;
+                g = (3 * i + 5) % 16;
+            } else {
+                f = c ^ (b | ~d);
+                g = (7 * i) % 16;
+            }
+            const auto tmp = d;
+            d = c;
+            c = b;
+            b = b + rotate_left(a + f + k[i] + w[g], r[i]);
+            a = tmp;
+        }
+        state_[0] += a;
+        state_[1] += b;
+        state_[2] += c;
+        state_[3] += d;
+    }
+
+    std::array<std::uint32_t, 4> state_ {{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476}};
+    std::array<std::uint8_t, 64> buffer_ {};
+    std::size_t buffer_size_ = 0;
+    std::uint64_t length_ = 0;
+};
+
+inline std::string md5_hex(std::string_view data) {
+    return md5{}.update(data).hex_digest();
+}
+
+} // namespace ozo::detail
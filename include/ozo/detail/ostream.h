@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <ostream>
 
@@ -9,25 +10,101 @@ struct ostream : std::ostream {
     using std::ostream::ostream;
 };
 
+/**
+ * Stream buffer which appends to a vector. It may be positioned over the written data
+ * to overwrite it, e.g. to write a length prefix after the data.
+ */
 class ostreambuf : public std::streambuf {
+    static constexpr std::size_t end_pos = std::size_t(-1);
+
     std::vector<char_type>& buf_;
+    std::size_t pos_ = end_pos;
 
 public:
     ostreambuf(std::vector<char_type>& buf) : buf_(buf) {}
 
 protected:
     std::streamsize xsputn(const char_type* s, std::streamsize n) override {
-        buf_.insert(buf_.end(), s, s + n);
+        if (pos_ == end_pos) {
+            buf_.insert(buf_.end(), s, s + n);
+            return n;
+        }
+        const auto count = static_cast<std::size_t>(n);
+        const auto overwrite = std::min(count, buf_.size() - pos_);
+        std::copy(s, s + overwrite, buf_.begin() + static_cast<std::ptrdiff_t>(pos_));
+        buf_.insert(buf_.end(), s + overwrite, s + count);
+        pos_ += count;
+        if (pos_ >= buf_.size()) {
+            pos_ = end_pos;
+        }
         return n;
     }
 
     int_type overflow(int_type ch) override {
         using traits = std::char_traits<char_type>;
         if (!traits::eq_int_type(ch, traits::eof())) {
-            buf_.push_back(static_cast<char_type>(ch));
+            const auto c = static_cast<char_type>(ch);
+            xsputn(&c, 1);
         }
         return ch;
     }
+
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+        if (!(which & std::ios_base::out)) {
+            return pos_type(off_type(-1));
+        }
+        const auto size = static_cast<off_type>(buf_.size());
+        off_type base = size;
+        if (dir == std::ios_base::beg) {
+            base = 0;
+        } else if (dir == std::ios_base::cur && pos_ != end_pos) {
+            base = static_cast<off_type>(pos_);
+        }
+        const auto pos = base + off;
+        if (pos < 0 || pos > size) {
+            return pos_type(off_type(-1));
+        }
+        pos_ = pos == size ? end_pos : static_cast<std::size_t>(pos);
+        return pos_type(pos);
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+};
+
+/**
+ * Stream buffer over a fixed size memory, the stream fails on overflow.
+ */
+class fixed_ostreambuf : public std::streambuf {
+public:
+    fixed_ostreambuf(char_type* data, std::size_t size) {
+        setp(data, data + size);
+    }
+
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+        if (!(which & std::ios_base::out)) {
+            return pos_type(off_type(-1));
+        }
+        off_type base = epptr() - pbase();
+        if (dir == std::ios_base::beg) {
+            base = 0;
+        } else if (dir == std::ios_base::cur) {
+            base = pptr() - pbase();
+        }
+        const auto pos = base + off;
+        if (pos < 0 || pos > epptr() - pbase()) {
+            return pos_type(off_type(-1));
+        }
+        setp(pbase(), epptr());
+        pbump(static_cast<int>(pos));
+        return pos_type(pos);
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
 };
 
 } // namespace ozo::detail
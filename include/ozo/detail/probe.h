@@ -0,0 +1,80 @@
+#pragma once
+
+#include <ozo/connection.h>
+#include <ozo/time_traits.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * USDT (SystemTap/DTrace compatible) static probes of the `ozo` provider. Probes are
+ * compiled in if `OZO_ENABLE_USDT` is defined, which requires `<sys/sdt.h>`. Otherwise
+ * `OZO_PROBE` arguments are only type checked in an unevaluated context, so a probe which
+ * would not compile with USDT enabled does not compile without it either. A compiled-in probe
+ * is a single `nop` until a tracer attaches to it, but its arguments including the
+ * durations are computed anyway.
+ *
+ * Probes and their arguments (fd is the connection socket descriptor, durations are in nanoseconds):
+ * - `connect__start(fd)`,
+ * - `connect__finish(fd, duration, error)`,
+ * - `pool__acquire(fd, wait_duration)`, fd is -1 if a new connection is needed,
+ * - `pool__release(fd, hold_duration, wasted)`,
+ * - `query__send(fd, query_name, duration)`,
+ * - `query__flush(fd, query_name, duration)`,
+ * - `result__ready(fd, query_name, wait_duration)`,
+ * - `decode__start(fd, query_name, rows)`,
+ * - `decode__finish(fd, query_name, duration)`.
+ *
+ * E.g. `bpftrace -e 'usdt:./app:ozo:result__ready { @[str(arg1)] = hist(arg2); }'`.
+ */
+
+#ifdef OZO_ENABLE_USDT
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#else
+#error "OZO_ENABLE_USDT requires <sys/sdt.h> (systemtap-sdt-dev or systemtap-sdt-devel package)"
+#endif
+#define OZO_PROBE(name, ...) STAP_PROBEV(ozo, name, __VA_ARGS__)
+#else
+#define OZO_PROBE(name, ...) static_cast<void>(sizeof(::ozo::detail::probe_args(__VA_ARGS__)))
+#endif
+
+namespace ozo::detail {
+
+/**
+ * USDT probe arguments are passed in registers, so they must be integers or pointers.
+ */
+template <typename T>
+constexpr bool ProbeArgument = std::is_integral_v<T> || std::is_pointer_v<T>;
+
+template <typename ...Ts>
+struct probe_arguments {
+    static_assert(sizeof...(Ts) <= 12, "USDT probe takes up to 12 arguments");
+    static_assert((ProbeArgument<std::decay_t<Ts>> && ...), "USDT probe argument must be an integer or a pointer");
+};
+
+template <typename ...Ts>
+probe_arguments<Ts...> probe_args(Ts&&...) noexcept;
+
+#ifdef OZO_ENABLE_USDT
+constexpr bool probes_enabled = true;
+#else
+constexpr bool probes_enabled = false;
+#endif
+
+inline std::int64_t probe_ns(time_traits::duration v) noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(v).count();
+}
+
+inline const char* probe_name(std::string_view v) noexcept {
+    return v.empty() ? "" : v.data();
+}
+
+template <typename Connection>
+inline int probe_fd(Connection& conn) noexcept {
+    return static_cast<int>(ozo::get_socket(conn).native_handle());
+}
+
+} // namespace ozo::detail
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace ozo::detail {
+
+/**
+ * Lock-free single producer single consumer ring buffer of a fixed capacity.
+ * The producer never waits: `push()` fails if the buffer is full.
+ * Capacity should be a power of two.
+ */
+template <typename T, std::size_t Capacity>
+class ring_buffer {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity should be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "value type should be trivially copyable");
+
+public:
+    static constexpr std::size_t capacity = Capacity;
+
+    ring_buffer() = default;
+    ring_buffer(const ring_buffer&) = delete;
+    ring_buffer& operator =(const ring_buffer&) = delete;
+
+    bool push(const T& v) noexcept {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        items_[head & (Capacity - 1)] = v;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Passes each available value to the visitor and removes it from the buffer.
+     * Returns the number of values consumed.
+     */
+    template <typename Visitor>
+    std::size_t consume(Visitor&& visitor) {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        const auto head = head_.load(std::memory_order_acquire);
+        const auto retval = head - tail;
+        for (; tail != head; ++tail) {
+            const T v = items_[tail & (Capacity - 1)];
+            tail_.store(tail + 1, std::memory_order_release);
+            visitor(v);
+        }
+        return retval;
+    }
+
+    std::size_t size() const noexcept {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+private:
+    alignas(64) std::atomic<std::size_t> head_ {0};
+    alignas(64) std::atomic<std::size_t> tail_ {0};
+    std::array<T, Capacity> items_;
+};
+
+} // namespace ozo::detail
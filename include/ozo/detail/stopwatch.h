@@ -0,0 +1,28 @@
+#pragma once
+
+#include <ozo/time_traits.h>
+
+namespace ozo::detail {
+
+/**
+ * Measures time elapsed since construction or restart. The disabled
+ * specialization does nothing, so no clock reads are made.
+ */
+template <bool Enabled>
+class stopwatch {
+public:
+    void restart() noexcept { start_ = time_traits::now(); }
+    time_traits::duration elapsed() const noexcept { return time_traits::now() - start_; }
+
+private:
+    time_traits::time_point start_ = time_traits::now();
+};
+
+template <>
+class stopwatch<false> {
+public:
+    void restart() noexcept {}
+    time_traits::duration elapsed() const noexcept { return {}; }
+};
+
+} // namespace ozo::detail
@@ -89,6 +89,8 @@ enum code {
     bad_array_size, //!< an array size received does not equal to the expected or not supported by the type
     bad_array_dimension, //!< an array dimension count received does not equal to the expected or not supported by the type
     bad_composite_size, //!< a composite's fields number received does not equal to the expected or not supported by the type
+    pg_pipeline_mode_failed, //!< libpq PQenterPipelineMode, PQpipelineSync or PQexitPipelineMode function failed
+    notifications_lost, //!< listening connection has been lost, notifications sent until it is reestablished are lost
 };
 
 /**
@@ -451,6 +453,10 @@ public:
                 return "an array dimension count received does not equal to the expected or not supported by the type";
             case bad_composite_size:
                 return "a composite's fields number received does not equal to the expected or not supported by the type";
+            case pg_pipeline_mode_failed:
+                return "pg_pipeline_mode_failed - libpq PQenterPipelineMode, PQpipelineSync or PQexitPipelineMode function failed";
+            case notifications_lost:
+                return "notifications_lost - listening connection has been lost, notifications sent until it is reestablished are lost";
         }
         return "no message for value: " + std::to_string(value);
     }
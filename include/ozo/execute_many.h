@@ -0,0 +1,94 @@
+#pragma once
+
+#include <ozo/impl/async_execute_many.h>
+
+namespace ozo {
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Executes a statement for many sets of parameters
+ *
+ * The function executes a statement like `INSERT` or `UPDATE` with no result data expected
+ * for each element of the range. Parameters are taken from members of a #HanaStruct, elements
+ * of a #FusionSequence (e.g. `std::tuple`) or the element itself and are bound to `$1`, `$2`, ...
+ * placeholders of the statement in order.
+ *
+ * If the statement contains a single `VALUES ($1, $2, ..., $N)` row with all its placeholders
+ * and none of the parameters is an #Array, it is rewritten into `SELECT * FROM UNNEST($1, $2, ..., $N)`
+ * and executed once with arrays of the parameters, so the whole range takes one statement and one
+ * round trip. Mind that rows of a single `INSERT ... ON CONFLICT DO UPDATE` statement must not
+ * conflict with each other.
+ *
+ * Otherwise the statement is executed for each element of the range on the same connection. If
+ * the connection supports pipeline mode, the statements are sent in a single libpq pipeline and
+ * are executed in one implicit transaction, so the first error aborts the rest. If it does not,
+ * e.g. for a shared handle of `ozo::connection_multiplexer`, the statements are executed one by
+ * one and each of them is committed on its own; the execution stops at the first error, but the
+ * statements executed before it are not rolled back. Execute the function via a transaction
+ * to make the whole range atomic.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- #ConnectionProvider object
+ * @param query --- #Query or `ozo::query_builder` object with the statement and no parameters bound.
+ * @param rows --- range of parameters sets; it is copied before the function returns.
+ * @param time_constraint --- request #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ *
+ * ###Example
+ *
+ * @code
+struct user {
+    std::int64_t id;
+    std::string name;
+};
+BOOST_HANA_ADAPT_STRUCT(user, id, name);
+
+std::vector<user> users = ...;
+ozo::execute_many(conn_info[io],
+    "INSERT INTO users (id, name) VALUES ($1, $2) ON CONFLICT (id) DO UPDATE SET name = EXCLUDED.name"_SQL,
+    users, yield);
+ * @endcode
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename Query, typename Range, typename TimeConstraint, typename CompletionToken>
+decltype(auto) execute_many(ConnectionProvider&& provider, Query&& query, const Range& rows,
+        TimeConstraint time_constraint, CompletionToken&& token);
+
+/**
+ * @brief Executes a statement for many sets of parameters
+ *
+ * This function is time constrain free shortcut to `ozo::execute_many()` function.
+ * Its call is equal to `ozo::execute_many(provider, query, rows, ozo::none, token)` call.
+ *
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename Query, typename Range, typename CompletionToken>
+decltype(auto) execute_many(ConnectionProvider&& provider, Query&& query, const Range& rows, CompletionToken&& token);
+#else
+struct execute_many_op {
+    template <typename P, typename Q, typename Range, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Q&& query, const Range& rows, TimeConstraint t,
+            CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        using signature_t = void (error_code, connection_type<P>);
+        async_completion<CompletionToken, signature_t> init(token);
+
+        impl::async_execute_many(std::forward<P>(provider), std::forward<Q>(query), rows,
+            t, init.completion_handler);
+
+        return init.result.get();
+    }
+
+    template <typename P, typename Q, typename Range, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Q&& query, const Range& rows, CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), std::forward<Q>(query), rows, none,
+            std::forward<CompletionToken>(token));
+    }
+};
+
+constexpr execute_many_op execute_many;
+#endif
+} // namespace ozo
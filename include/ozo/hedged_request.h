@@ -0,0 +1,109 @@
+#pragma once
+
+#include <ozo/impl/hedged_request.h>
+
+namespace ozo {
+
+/**
+ * @brief Hedged requests policy
+ * @ingroup group-requests-types
+ *
+ * Keeps the latency histograms of the queries requested via `ozo::hedged_request()` to adapt
+ * the hedge delay of each query to the percentile of its latencies, see `ozo::hedging_config`.
+ * Copies of the policy share the histograms. The policy is thread safe.
+ */
+class hedging_policy {
+public:
+    explicit hedging_policy(io_context& io, const hedging_config& config = {})
+    : impl_(std::make_shared<impl::hedging_state>(io, config)) {}
+
+    /**
+     * Current hedge delay of the query with the given name, or the text for an unnamed query.
+     */
+    time_traits::duration delay(const std::string& query) const { return impl_->delay(query); }
+
+    std::shared_ptr<impl::hedging_state> impl_;
+};
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Makes a request via two connection providers to cut the tail latency
+ *
+ * Makes the request via the primary provider. If it has not completed within the hedge delay of
+ * the query, or has failed, makes the same request via the secondary provider, e.g. a pool of another
+ * replica. The first successful result is provided to the output, the request in progress on the
+ * other connection is cancelled server-side, and its result is discarded. If both requests fail the
+ * error of the last one is provided.
+ *
+ * The query may be executed twice, so use the function for idempotent read-only queries only.
+ * Libpq-based connections are cancelled server-side, other requests are left to complete. The connection
+ * of a cancelled request is not returned to its provider until the cancel request is delivered.
+ * Latencies of the primary requests are recorded whether they win or not, a cancelled one is recorded
+ * with the time it took until the cancel.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param policy --- `ozo::hedging_policy` object.
+ * @param primary --- #ConnectionProvider to make the request via first.
+ * @param secondary --- #ConnectionProvider to make the hedged request via.
+ * @param query --- #Query or `ozo::query_builder` object to request from a database.
+ * @param time_constraint --- #TimeConstraint of the whole operation, including both requests.
+ * @param out --- output object like Iterator, #InsertIterator or `ozo::result`.
+ * @param token --- operation #CompletionToken with `void(ozo::error_code, Connection)` signature, where
+ *        Connection is the connection type of the providers, or `std::variant` of them if they differ.
+ * @return deduced from #CompletionToken.
+ *
+ * ###Example
+ *
+ * @code
+ozo::hedging_policy policy(io);
+ozo::rows_of<std::int64_t, std::string> users;
+ozo::hedged_request(policy, replica1[io], replica2[io], "SELECT id, name FROM users"_SQL, 1s,
+    ozo::into(users), yield);
+ * @endcode
+ * @ingroup group-requests-functions
+ */
+template <typename Primary, typename Secondary, typename Query, typename TimeConstraint, typename Out, typename CompletionToken>
+decltype(auto) hedged_request(const hedging_policy& policy, Primary&& primary, Secondary&& secondary, Query&& query,
+        TimeConstraint time_constraint, Out&& out, CompletionToken&& token);
+
+/**
+ * @brief Makes a request via two connection providers to cut the tail latency
+ *
+ * This function is time constrain free shortcut to `ozo::hedged_request()` function.
+ * Its call is equal to `ozo::hedged_request(policy, primary, secondary, query, ozo::none, out, token)` call.
+ *
+ * @ingroup group-requests-functions
+ */
+template <typename Primary, typename Secondary, typename Query, typename Out, typename CompletionToken>
+decltype(auto) hedged_request(const hedging_policy& policy, Primary&& primary, Secondary&& secondary, Query&& query,
+        Out&& out, CompletionToken&& token);
+#else
+struct hedged_request_op {
+    template <typename P1, typename P2, typename Q, typename TimeConstraint, typename Out, typename CompletionToken>
+    decltype(auto) operator() (const hedging_policy& policy, P1&& primary, P2&& secondary, Q&& query,
+            TimeConstraint t, Out&& out, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P1>, "primary should be a ConnectionProvider");
+        static_assert(ConnectionProvider<P2>, "secondary should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        using signature_t = void (error_code, impl::hedged_connection_type<P1, P2>);
+        async_completion<CompletionToken, signature_t> init(token);
+
+        impl::async_hedged_request(policy.impl_, std::forward<P1>(primary), std::forward<P2>(secondary),
+            std::forward<Q>(query), t, std::forward<Out>(out), init.completion_handler);
+
+        return init.result.get();
+    }
+
+    template <typename P1, typename P2, typename Q, typename Out, typename CompletionToken>
+    decltype(auto) operator() (const hedging_policy& policy, P1&& primary, P2&& secondary, Q&& query,
+            Out&& out, CompletionToken&& token) const {
+        return (*this)(policy, std::forward<P1>(primary), std::forward<P2>(secondary), std::forward<Q>(query),
+            none, std::forward<Out>(out), std::forward<CompletionToken>(token));
+    }
+};
+
+constexpr hedged_request_op hedged_request;
+#endif
+
+} // namespace ozo
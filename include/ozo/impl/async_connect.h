@@ -1,12 +1,14 @@
 #pragma once
 
 #include <ozo/detail/cancel_timer_handler.h>
+#include <ozo/detail/probe.h>
 #include <ozo/detail/post_handler.h>
 #include <ozo/detail/timeout_handler.h>
 #include <ozo/impl/io.h>
 #include <ozo/impl/request_oid_map.h>
 #include <ozo/time_traits.h>
 #include <ozo/connection.h>
+#include <ozo/statistics.h>
 
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/steady_timer.hpp>
@@ -22,6 +24,7 @@ struct connect_operation_context {
 
     ConnectionT connection;
     Handler handler;
+    detail::stopwatch<ConnectionStatisticsEnabled<ConnectionT> || detail::probes_enabled> stopwatch;
 
     connect_operation_context(ConnectionT connection, Handler handler)
             : connection(std::move(connection)),
@@ -72,6 +75,8 @@ struct async_connect_op {
             return done(ec);
         }
 
+        OZO_PROBE(connect__start, detail::probe_fd(get_connection(context)));
+
         detail::set_io_timeout(get_connection(context), get_handler(context), time_constrain);
 
         return write_poll(get_connection(context), *this);
@@ -104,6 +109,9 @@ struct async_connect_op {
     }
 
     void done(error_code ec = error_code {}) {
+        collect_statistics(get_connection(context), event::connect{context->stopwatch.elapsed(), ec});
+        OZO_PROBE(connect__finish, detail::probe_fd(get_connection(context)),
+            detail::probe_ns(context->stopwatch.elapsed()), ec.value());
         std::move(get_handler(context))(std::move(ec), std::move(get_connection(context)));
     }
 
@@ -14,6 +14,9 @@ struct async_end_transaction_op {
     void perform(T&& provider, Query&& query, TimeConstraint t) {
         static_assert(Connection<T>, "T is not a Connection");
         static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        if (provider.is_finished()) {
+            return (*this)(error_code{}, std::forward<T>(provider));
+        }
         async_execute(std::forward<T>(provider), std::forward<Query>(query), t, std::move(*this));
     }
 
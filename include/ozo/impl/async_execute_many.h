@@ -0,0 +1,372 @@
+#pragma once
+
+#include <ozo/impl/async_execute.h>
+#include <ozo/impl/async_multi_request.h>
+#include <ozo/io/array.h>
+
+#include <boost/fusion/include/at_c.hpp>
+#include <boost/fusion/include/size.hpp>
+#include <boost/hana/is_empty.hpp>
+#include <boost/hana/members.hpp>
+#include <boost/hana/range.hpp>
+#include <boost/hana/unpack.hpp>
+
+#include <cctype>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ozo::impl {
+
+template <typename Row, std::size_t ...I>
+inline auto fusion_row_params(const Row& row, std::index_sequence<I...>) {
+    return hana::make_tuple(fusion::at_c<I>(row)...);
+}
+
+/**
+ * Parameters of a statement for a row of `ozo::execute_many()`: members of a
+ * #HanaStruct, elements of a #FusionSequence or a single value otherwise.
+ */
+template <typename Row>
+inline auto row_params(const Row& row) {
+    if constexpr (HanaStruct<Row>) {
+        return hana::members(row);
+    } else if constexpr (FusionSequence<Row>) {
+        using size = typename fusion::result_of::size<Row>::type;
+        return fusion_row_params(row, std::make_index_sequence<size::value>{});
+    } else {
+        return hana::make_tuple(row);
+    }
+}
+
+template <typename Rows>
+using row_params_type = decltype(row_params(*std::begin(std::declval<const Rows&>())));
+
+template <typename Params>
+struct params_arrays;
+
+template <typename ...Ts>
+struct params_arrays<hana::tuple<Ts...>> {
+    using type = hana::tuple<std::vector<Ts>...>;
+};
+
+template <typename Params>
+struct has_array_params;
+
+template <typename ...Ts>
+struct has_array_params<hana::tuple<Ts...>> : std::bool_constant<(Array<unwrap_type<Ts>> || ...)> {};
+
+/**
+ * Indicates that some of the statement parameters are #Array, so the parameters can not be
+ * passed via `UNNEST` arrays: PostgreSQL has no arrays of arrays, multidimensional arrays are
+ * unnested into elements.
+ */
+template <typename Params>
+constexpr bool ArrayParams = has_array_params<Params>::value;
+
+/**
+ * Transposes the rows into a tuple of arrays, one array per statement parameter.
+ */
+template <typename Rows>
+inline auto transpose_rows(const Rows& rows) {
+    using params_type = row_params_type<Rows>;
+    constexpr auto size = decltype(hana::size(std::declval<params_type>())){};
+    typename params_arrays<params_type>::type arrays;
+    if constexpr (ForwardIterator<decltype(std::begin(rows))>) {
+        const auto count = static_cast<std::size_t>(std::distance(std::begin(rows), std::end(rows)));
+        hana::for_each(arrays, [&] (auto& array) { array.reserve(count); });
+    }
+    for (const auto& row : rows) {
+        auto params = row_params(row);
+        hana::for_each(hana::make_range(hana::size_c<0>, size), [&] (auto i) {
+            arrays[i].push_back(std::move(params[i]));
+        });
+    }
+    return arrays;
+}
+
+inline bool is_identifier_char(char c) noexcept {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+inline std::size_t skip_spaces(std::string_view text, std::size_t pos) noexcept {
+    while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+        ++pos;
+    }
+    return pos;
+}
+
+// Parses "($1, $2, ..., $N)" at pos, returns position after the closing parenthesis or npos.
+inline std::size_t parse_placeholders_tuple(std::string_view text, std::size_t pos, std::size_t count) noexcept {
+    if (pos >= text.size() || text[pos] != '(') {
+        return std::string_view::npos;
+    }
+    for (std::size_t n = 1; n <= count; ++n) {
+        pos = skip_spaces(text, pos + 1);
+        const auto placeholder = "$" + std::to_string(n);
+        if (text.substr(pos, placeholder.size()) != placeholder) {
+            return std::string_view::npos;
+        }
+        pos = skip_spaces(text, pos + placeholder.size());
+        if (pos >= text.size() || text[pos] != (n == count ? ')' : ',')) {
+            return std::string_view::npos;
+        }
+    }
+    return pos + 1;
+}
+
+// Returns the position after a string constant, a quoted identifier or a comment which
+// starts at pos, or pos if there is none of them.
+inline std::size_t skip_literal_or_comment(std::string_view text, std::size_t pos) noexcept {
+    const auto find_end = [&] (std::string_view terminator, std::size_t from) {
+        const auto end = text.find(terminator, from);
+        return end == std::string_view::npos ? text.size() : end + terminator.size();
+    };
+    const bool word_start = pos == 0 || !is_identifier_char(text[pos - 1]);
+    switch (text[pos]) {
+        case '\'':
+            if (pos != 0 && (text[pos - 1] == 'E' || text[pos - 1] == 'e')
+                    && (pos == 1 || !is_identifier_char(text[pos - 2]))) {
+                // Escape string constant, quotes may be escaped with backslashes.
+                for (auto i = pos + 1; i < text.size(); ++i) {
+                    if (text[i] == '\\') {
+                        ++i;
+                    } else if (text[i] == '\'') {
+                        return i + 1;
+                    }
+                }
+                return text.size();
+            }
+            // A doubled quote within the constant is handled as two adjacent constants.
+            return find_end("'", pos + 1);
+        case '"':
+            return find_end("\"", pos + 1);
+        case '-':
+            return text.substr(pos, 2) == "--" ? find_end("\n", pos + 2) : pos;
+        case '/': {
+            if (text.substr(pos, 2) != "/*") {
+                return pos;
+            }
+            // Block comments may be nested.
+            std::size_t depth = 0;
+            for (auto i = pos; i + 1 < text.size(); ++i) {
+                if (text[i] == '/' && text[i + 1] == '*') {
+                    ++depth;
+                    ++i;
+                } else if (text[i] == '*' && text[i + 1] == '/') {
+                    ++i;
+                    if (--depth == 0) {
+                        return i + 1;
+                    }
+                }
+            }
+            return text.size();
+        }
+        case '$': {
+            // Dollar-quoted string constant $tag$...$tag$, the tag does not start with a digit
+            // unlike a parameter placeholder.
+            if (!word_start || pos + 1 >= text.size() || std::isdigit(static_cast<unsigned char>(text[pos + 1]))) {
+                return pos;
+            }
+            auto end = pos + 1;
+            while (end < text.size() && text[end] != '$' && is_identifier_char(text[end])) {
+                ++end;
+            }
+            if (end >= text.size() || text[end] != '$') {
+                return pos;
+            }
+            return find_end(text.substr(pos, end - pos + 1), end + 1);
+        }
+    }
+    return pos;
+}
+
+inline std::size_t count_placeholders(std::string_view text) noexcept {
+    std::size_t retval = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (const auto end = skip_literal_or_comment(text, i); end != i) {
+            i = end - 1;
+            continue;
+        }
+        if (text[i] == '$' && i + 1 < text.size() && std::isdigit(static_cast<unsigned char>(text[i + 1]))
+                && (i == 0 || !is_identifier_char(text[i - 1]))) {
+            ++retval;
+        }
+    }
+    return retval;
+}
+
+/**
+ * Rewrites a statement with the single `VALUES ($1, $2, ..., $N)` row which contains
+ * all the statement placeholders into a statement over `SELECT * FROM UNNEST($1, ..., $N)`,
+ * so the statement parameters may be arrays of values for many rows. Returns an empty
+ * optional if the statement does not match.
+ */
+inline __OZO_STD_OPTIONAL<std::string> make_unnest_statement(std::string_view text, std::size_t count) {
+    if (count == 0 || count_placeholders(text) != count) {
+        return {};
+    }
+    constexpr std::string_view keyword = "values";
+    for (std::size_t pos = 0; pos + keyword.size() <= text.size(); ++pos) {
+        if (const auto end = skip_literal_or_comment(text, pos); end != pos) {
+            pos = end - 1;
+            continue;
+        }
+        if (pos != 0 && is_identifier_char(text[pos - 1])) {
+            continue;
+        }
+        bool matches = true;
+        for (std::size_t i = 0; i < keyword.size() && matches; ++i) {
+            matches = std::tolower(static_cast<unsigned char>(text[pos + i])) == keyword[i];
+        }
+        if (!matches || (pos + keyword.size() < text.size() && is_identifier_char(text[pos + keyword.size()]))) {
+            continue;
+        }
+        const auto end = parse_placeholders_tuple(text, skip_spaces(text, pos + keyword.size()), count);
+        if (end == std::string_view::npos) {
+            continue;
+        }
+        std::string retval(text.substr(0, pos));
+        retval += "SELECT * FROM UNNEST(";
+        for (std::size_t n = 1; n <= count; ++n) {
+            retval += (n == 1 ? "$" : ", $") + std::to_string(n);
+        }
+        retval += ')';
+        retval += text.substr(end);
+        return retval;
+    }
+    return {};
+}
+
+/**
+ * Executes the statement for every parameters set on the same connection: in a single
+ * pipeline if the connection supports it, one by one otherwise.
+ */
+template <typename Params, typename TimeConstraint, typename Handler,
+        typename Stopwatch = detail::stopwatch<false>>
+struct async_execute_many_op {
+    std::string text_;
+    std::vector<Params> params_;
+    TimeConstraint time_constraint_;
+    Handler handler_;
+    Stopwatch stopwatch_;
+    std::string_view name_;
+    trace::request<> trace_;
+    std::size_t next_ = 0;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection conn) {
+        if (ec) {
+            return handler_(ec, std::move(conn));
+        }
+
+        if constexpr (PipelineSupported<Connection>) {
+            if constexpr (MultiplexedConnection<Connection>) {
+                if (!conn.pinned()) {
+                    return step(error_code{}, std::move(conn));
+                }
+            }
+#ifdef LIBPQ_HAS_PIPELINING
+            collect_statistics(conn, event::acquire{stopwatch_.elapsed()});
+            trace_.span(trace::phase::acquire, trace_.start());
+            const auto size = params_.size();
+            return async_pipeline_request(std::move(conn), name_, trace_,
+                [&] (const auto& oid_map, const auto& allocator) {
+                    std::vector<decltype(make_query_at(0, oid_map, allocator))> queries;
+                    queries.reserve(params_.size());
+                    for (std::size_t i = 0; i < params_.size(); ++i) {
+                        queries.push_back(make_query_at(i, oid_map, allocator));
+                    }
+                    return queries;
+                },
+                hana::make_tuple(), size, time_constraint_, std::move(handler_));
+#endif
+        }
+        step(error_code{}, std::move(conn));
+    }
+
+    template <typename OidMap, typename Allocator>
+    auto make_query_at(std::size_t i, const OidMap& oid_map, const Allocator& allocator) {
+        return hana::unpack(std::move(params_[i]), [&] (auto&& ...params) {
+            return binary_query(make_query(text_, std::move(params)...), oid_map, allocator);
+        });
+    }
+
+    template <typename Connection>
+    void step(error_code ec, Connection conn) {
+        if (ec || next_ == params_.size()) {
+            return handler_(std::move(ec), std::move(conn));
+        }
+        auto query = hana::unpack(std::move(params_[next_++]), [&] (auto&& ...params) {
+            return make_query(text_, std::move(params)...);
+        });
+        auto executor = asio::get_associated_executor(handler_);
+        async_execute(std::move(conn), std::move(query), time_constraint_,
+            asio::bind_executor(executor, [self = std::move(*this)] (error_code ec, Connection conn) mutable {
+                self.step(std::move(ec), std::move(conn));
+            }));
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename Q>
+inline std::string get_statement_text(const Q& query) {
+    if constexpr (QueryBuilder<Q>) {
+        return get_statement_text(query.build());
+    } else {
+        static_assert(Query<Q>, "is neither Query nor QueryBuilder");
+        static_assert(decltype(hana::is_empty(get_params(query)))::value,
+            "statement for execute_many should have no parameters bound");
+        return to_const_char(get_text(query));
+    }
+}
+
+template <typename P, typename Q, typename Rows, typename TimeConstraint, typename Handler>
+inline void async_execute_many(P&& provider, Q&& query, const Rows& rows, TimeConstraint t, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    using params_type = row_params_type<Rows>;
+    constexpr std::size_t count = decltype(hana::size(std::declval<params_type>()))::value;
+
+    const auto name = trace::query_name(query);
+    auto text = get_statement_text(query);
+    if constexpr (!ArrayParams<params_type>) {
+        if (auto statement = make_unnest_statement(text, count)) {
+            auto unnest = hana::unpack(transpose_rows(rows), [&] (auto&& ...arrays) {
+                return make_query(std::move(*statement), std::move(arrays)...);
+            });
+            return async_execute(std::forward<P>(provider), std::move(unnest), t, std::forward<Handler>(handler));
+        }
+    }
+
+    std::vector<params_type> params;
+    for (const auto& row : rows) {
+        params.push_back(row_params(row));
+    }
+    async_get_connection(std::forward<P>(provider), deadline(t),
+        async_execute_many_op<params_type, decltype(deadline(t)), std::decay_t<Handler>,
+                detail::stopwatch<ProviderStatisticsEnabled<P>>> {
+            std::move(text),
+            std::move(params),
+            deadline(t),
+            std::forward<Handler>(handler),
+            {},
+            name,
+            trace::request<>(name)
+        }
+    );
+}
+
+} // namespace ozo::impl
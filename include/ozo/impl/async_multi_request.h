@@ -0,0 +1,393 @@
+#pragma once
+
+#include <ozo/impl/async_request.h>
+
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/front.hpp>
+#include <boost/hana/is_empty.hpp>
+#include <boost/hana/size.hpp>
+#include <boost/hana/transform.hpp>
+
+#include <string_view>
+
+namespace ozo::impl {
+
+/**
+ * Binary queries which are sent in a single pipeline, either a #HanaSequence
+ * of queries of a multi-result-set request or a range of queries of the same type.
+ */
+template <typename Queries>
+struct query_batch {
+    Queries queries;
+};
+
+template <typename Queries>
+struct is_query_batch<query_batch<Queries>> : std::true_type {};
+
+template <typename Queries, typename Function>
+inline void for_each_query(const query_batch<Queries>& batch, Function&& f) {
+    if constexpr (HanaSequence<Queries>) {
+        hana::for_each(batch.queries, std::forward<Function>(f));
+    } else {
+        for (const auto& query : batch.queries) {
+            f(query);
+        }
+    }
+}
+
+template <typename T, typename Queries>
+inline bool send_pipelined(T& conn, query_batch<Queries>& batch) {
+    bool sent = true;
+    for_each_query(batch, [&] (const auto& query) {
+        sent = sent && send_query_params(conn, query);
+    });
+    return sent;
+}
+
+template <typename Queries>
+inline std::size_t query_size(const query_batch<Queries>& batch) noexcept {
+    std::size_t retval = 0;
+    for_each_query(batch, [&] (const auto& query) { retval += query_size(query); });
+    return retval;
+}
+
+template <typename Tuple, typename Visitor>
+inline void visit_at(Tuple& tuple, std::size_t index, Visitor&& visitor) {
+    std::size_t i = 0;
+    hana::for_each(tuple, [&] (auto& v) {
+        if (i++ == index) {
+            visitor(v);
+        }
+    });
+}
+
+#include <boost/asio/yield.hpp>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+/**
+ * Receives results of a query batch sent in a single pipeline. Each result set is
+ * processed into its own output as soon as it is received, result sets of the queries
+ * which have no output are dropped. The first error of the pipeline is reported when
+ * the synchronization point is reached.
+ */
+template <typename Context, typename ResultProcessors>
+struct async_get_results_op : boost::asio::coroutine {
+    Context ctx_;
+    ResultProcessors process_;
+    std::size_t size_;
+    request_trace_time_point<Context> wait_start_;
+    std::size_t index_ = 0;
+    error_code error_;
+
+    async_get_results_op(Context ctx, ResultProcessors process, std::size_t size)
+    : ctx_(ctx), process_(std::move(process)), size_(size) {}
+
+    void perform() {
+        wait_start_ = ctx_->trace.now();
+        (*this)();
+    }
+
+    void done(error_code ec) {
+        if (std::empty(get_error_context(get_connection(ctx_)))) {
+            set_error_context(get_connection(ctx_), "error while get pipeline results");
+        }
+        return impl::done(ctx_, ec);
+    }
+
+    void operator() (error_code ec = error_code{}, std::size_t = 0) {
+        if (get_query_state(ctx_) == query_state::error) {
+            return;
+        }
+
+        if (ec) {
+            if (ec == asio::error::bad_descriptor) {
+                ec = asio::error::operation_aborted;
+            }
+            return done(ec);
+        }
+
+        reenter(*this) {
+            do {
+                while (is_busy(get_connection(ctx_))) {
+                    yield read_poll(ctx_, *this);
+                    input_received(ctx_);
+                    if (auto err = consume_input(get_connection(ctx_))) {
+                        return done(err);
+                    }
+                }
+            } while (accept(get_result(get_connection(ctx_))));
+
+            ctx_->trace.span(trace::phase::wait, wait_start_);
+
+            if (auto err = exit_pipeline_mode(get_connection(ctx_))) {
+                return done(err);
+            }
+
+            if (error_) {
+                return done(error_);
+            }
+
+            complete_deferred_statements(get_connection(ctx_), ctx_->deferred);
+            impl::done(ctx_);
+        }
+    }
+
+    // Returns false on the pipeline synchronization point which follows the last result.
+    template <typename Result>
+    bool accept(Result&& res) {
+        if (!res) {
+            ++index_;
+            return true;
+        }
+        const auto status = result_status(*res);
+        if (status == PGRES_PIPELINE_SYNC) {
+            return false;
+        }
+        if (status == PGRES_PIPELINE_ABORTED || error_) {
+            return true;
+        }
+        const auto first = ctx_->deferred.prologue ? 1u : 0u;
+        const bool is_query = index_ >= first && index_ - first < size_;
+        switch (status) {
+            case PGRES_TUPLES_OK:
+            case PGRES_SINGLE_TUPLE:
+                if (is_query) {
+                    process(index_ - first, std::forward<Result>(res));
+                    return true;
+                }
+                break;
+            case PGRES_COMMAND_OK:
+                return true;
+            case PGRES_EMPTY_QUERY:
+                error_ = error::result_status_empty_query;
+                return true;
+            case PGRES_BAD_RESPONSE:
+                error_ = error::result_status_bad_response;
+                return true;
+            case PGRES_FATAL_ERROR:
+                error_ = result_error(*res);
+                return true;
+            default:
+                break;
+        }
+        set_error_context(get_connection(ctx_), get_result_status_name(status));
+        error_ = error::result_status_unexpected;
+        return true;
+    }
+
+    template <typename Result>
+    void process(std::size_t index, Result&& res) {
+        const auto decode_start = ctx_->trace.now();
+        try {
+            visit_at(process_, index, [&] (auto& process) {
+                process(std::forward<Result>(res), get_connection(ctx_));
+            });
+        } catch (const std::exception& e) {
+            ctx_->trace.span(trace::phase::decode, decode_start, error::bad_result_process);
+            set_error_context(get_connection(ctx_), e.what());
+            error_ = error::bad_result_process;
+            return;
+        }
+        ctx_->trace.span(trace::phase::decode, decode_start);
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(get_handler(ctx_)))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(get_handler(ctx_));
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(get_handler(ctx_)))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(get_handler(ctx_));
+    }
+};
+
+#endif
+
+#include <boost/asio/unyield.hpp>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+/**
+ * Sends the queries made by `make_queries(oid_map, allocator)` in a single pipeline
+ * with the deferred statements of the connection and receives their results.
+ * The phases of the pipeline are reported to `trace` and collected to the statistics
+ * under `name`, which should refer to a static storage.
+ */
+template <typename Connection, typename MakeQueries, typename ResultProcessors, typename TimeConstraint, typename Handler>
+inline void async_pipeline_request(Connection&& conn, std::string_view name, const trace::request<>& trace,
+        MakeQueries&& make_queries, ResultProcessors process, std::size_t size, TimeConstraint t, Handler&& handler) {
+    const auto deferred = get_deferred_statements(conn);
+    auto strand = ozo::detail::make_strand_executor(ozo::get_executor(conn));
+
+    auto ctx = make_request_operation_context(
+        std::forward<Connection>(conn),
+        asio::bind_executor(strand, detail::bind_cancel_timer<std::decay_t<TimeConstraint>>(
+            detail::post_handler(std::forward<Handler>(handler))
+        ))
+    );
+    ctx->deferred = deferred;
+    ctx->query_name = name;
+    ctx->trace = trace;
+    detail::set_io_timeout(get_connection(ctx), get_handler(ctx), t);
+
+    auto queries = make_queries(get_oid_map(get_connection(ctx)), asio::get_associated_allocator(get_handler(ctx)));
+    query_batch<decltype(queries)> batch {std::move(queries)};
+
+    async_send_query_params_op send_op {ctx, std::move(batch)};
+    send_op.perform();
+    async_get_results_op get_op {std::move(ctx), std::move(process), size};
+    get_op.perform();
+}
+
+#endif
+
+/**
+ * Executes the queries one by one on the same connection. It is used if the connection
+ * does not support pipeline mode or is shared via `ozo::connection_multiplexer`, which
+ * pipelines the requests itself.
+ */
+template <typename Queries, typename Outs, typename TimeConstraint, typename Handler>
+struct async_multi_request_sequence_op {
+    static constexpr std::size_t size = decltype(hana::size(std::declval<Queries>()))::value;
+
+    Queries queries_;
+    Outs outs_;
+    TimeConstraint time_constraint_;
+    Handler handler_;
+
+    template <std::size_t I = 0, typename Connection>
+    void step(error_code ec, Connection conn) {
+        if constexpr (I == size) {
+            handler_(std::move(ec), std::move(conn));
+        } else {
+            if (ec) {
+                return handler_(std::move(ec), std::move(conn));
+            }
+            auto query = std::move(queries_[hana::size_c<I>]);
+            auto out = std::move(outs_[hana::size_c<I>]);
+            auto executor = asio::get_associated_executor(handler_);
+            async_request(std::move(conn), std::move(query), time_constraint_, std::move(out),
+                asio::bind_executor(executor, [self = std::move(*this)] (error_code ec, Connection conn) mutable {
+                    self.template step<I + 1>(std::move(ec), std::move(conn));
+                }));
+        }
+    }
+};
+
+/**
+ * Name of the multi request to tag its spans and statistics with: the name of the first query.
+ */
+template <typename Queries>
+constexpr std::string_view multi_request_name(const Queries& queries) noexcept {
+    if constexpr (decltype(hana::is_empty(queries))::value) {
+        return {};
+    } else {
+        return trace::query_name(hana::front(queries));
+    }
+}
+
+template <typename Queries, typename Outs, typename TimeConstraint, typename Handler,
+        typename Stopwatch = detail::stopwatch<false>>
+struct async_multi_request_op {
+    static constexpr std::size_t size = decltype(hana::size(std::declval<Queries>()))::value;
+
+    Queries queries_;
+    Outs outs_;
+    TimeConstraint time_constraint_;
+    Handler handler_;
+    Stopwatch stopwatch_;
+    trace::request<> trace_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection conn) {
+        if (ec) {
+            return handler_(ec, std::move(conn));
+        }
+
+        if constexpr (!PipelineSupported<Connection>) {
+            return sequence(std::move(conn));
+        } else {
+            if constexpr (MultiplexedConnection<Connection>) {
+                if (!conn.pinned()) {
+                    return sequence(std::move(conn));
+                }
+            }
+            pipeline(std::move(conn));
+        }
+    }
+
+    template <typename Connection>
+    void sequence(Connection&& conn) {
+        async_multi_request_sequence_op<Queries, Outs, TimeConstraint, Handler> op {
+            std::move(queries_), std::move(outs_), time_constraint_, std::move(handler_)
+        };
+        op.step(error_code{}, std::forward<Connection>(conn));
+    }
+
+#ifdef LIBPQ_HAS_PIPELINING
+    template <typename Connection>
+    void pipeline(Connection&& conn) {
+        collect_statistics(conn, event::acquire{stopwatch_.elapsed()});
+        trace_.span(trace::phase::acquire, trace_.start());
+        auto process = hana::transform(std::move(outs_), [] (auto&& out) {
+            return async_request_out_handler{std::move(out)};
+        });
+        const auto name = multi_request_name(queries_);
+        async_pipeline_request(std::forward<Connection>(conn), name, trace_,
+            [&] (const auto& oid_map, const auto& allocator) {
+                return hana::transform(std::move(queries_), [&] (auto&& query) {
+                    return make_binary_query(std::move(query), oid_map, allocator);
+                });
+            },
+            std::move(process), size, time_constraint_, std::move(handler_));
+    }
+#else
+    template <typename Connection>
+    void pipeline(Connection&& conn) {
+        sequence(std::forward<Connection>(conn));
+    }
+#endif
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename P, typename Queries, typename TimeConstraint, typename Outs, typename Handler>
+inline void async_multi_request(P&& provider, Queries&& queries, TimeConstraint t, Outs&& outs, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(HanaSequence<Queries>, "queries should be a HanaSequence");
+    static_assert(HanaSequence<Outs>, "outputs should be a HanaSequence");
+    static_assert(decltype(hana::size(queries))::value == decltype(hana::size(outs))::value,
+        "number of outputs should be equal to number of queries");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    hana::for_each(queries, [] (const auto& query) {
+        static_assert(Query<decltype(query)> || QueryBuilder<decltype(query)>, "is neither Query nor QueryBuilder");
+    });
+    const auto name = multi_request_name(queries);
+    async_get_connection(std::forward<P>(provider), deadline(t),
+        async_multi_request_op<std::decay_t<Queries>, std::decay_t<Outs>, decltype(deadline(t)), std::decay_t<Handler>,
+                detail::stopwatch<ProviderStatisticsEnabled<P>>> {
+            std::forward<Queries>(queries),
+            std::forward<Outs>(outs),
+            deadline(t),
+            std::forward<Handler>(handler),
+            {},
+            trace::request<>(name)
+        }
+    );
+}
+
+} // namespace ozo::impl
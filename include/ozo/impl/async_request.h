@@ -1,13 +1,17 @@
 #pragma once
 
 #include <ozo/detail/cancel_timer_handler.h>
+#include <ozo/detail/probe.h>
 #include <ozo/detail/post_handler.h>
 #include <ozo/detail/timeout_handler.h>
 #include <ozo/impl/io.h>
+#include <ozo/impl/pipeline.h>
 #include <ozo/io/binary_query.h>
 #include <ozo/connection.h>
 #include <ozo/query_builder.h>
 #include <ozo/deadline.h>
+#include <ozo/statistics.h>
+#include <ozo/trace.h>
 
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/coroutine.hpp>
@@ -24,6 +28,13 @@ struct request_operation_context {
     using result_type = std::decay_t<decltype(get_result(conn))>;
     result_type result;
 
+    static constexpr bool statistics_enabled = ConnectionStatisticsEnabled<std::decay_t<Connection>>;
+    detail::stopwatch<statistics_enabled> stopwatch;
+    bool input_received = false;
+    std::string_view query_name;
+    deferred_statements deferred;
+    trace::request<> trace;
+
     request_operation_context(Connection conn, Handler handler)
       : conn(std::forward<Connection>(conn)),
         handler(std::forward<Handler>(handler)) {}
@@ -72,10 +83,15 @@ auto& get_handler(const request_operation_context_ptr<Ts ...>& context) noexcept
     return context->handler;
 }
 
+template <typename Context>
+constexpr bool RequestStatisticsEnabled = std::decay_t<decltype(*std::declval<Context>())>::statistics_enabled;
+
 template <typename ...Ts>
 inline void done(const request_operation_context_ptr<Ts...>& ctx, error_code ec) {
     set_query_state(ctx, query_state::error);
     decltype(auto) conn = get_connection(ctx);
+    collect_statistics(conn, event::query{ctx->stopwatch.elapsed(), ec, ctx->query_name});
+    ctx->trace.span(trace::phase::request, ctx->trace.start(), ec);
     error_code _;
     get_socket(conn).cancel(_);
     std::move(get_handler(ctx))(std::move(ec), conn);
@@ -83,9 +99,44 @@ inline void done(const request_operation_context_ptr<Ts...>& ctx, error_code ec)
 
 template <typename ...Ts>
 inline void done(const request_operation_context_ptr<Ts...>& ctx) {
+    collect_statistics(get_connection(ctx), event::query{ctx->stopwatch.elapsed(), error_code{}, ctx->query_name});
+    ctx->trace.span(trace::phase::request, ctx->trace.start());
     std::move(get_handler(ctx))(error_code {}, get_connection(ctx));
 }
 
+template <typename ...Ts>
+inline void input_received(const request_operation_context_ptr<Ts...>& ctx) {
+    if constexpr (request_operation_context<Ts...>::statistics_enabled) {
+        if (!std::exchange(ctx->input_received, true)) {
+            collect_statistics(get_connection(ctx), event::first_byte{ctx->stopwatch.elapsed()});
+        }
+    } else {
+        (void)ctx;
+    }
+}
+
+template <typename ...Ts>
+inline std::size_t query_size(const binary_query<Ts...>& q) noexcept {
+    std::size_t retval = std::char_traits<char>::length(q.text());
+    for (std::size_t i = 0; i < q.params_count; ++i) {
+        retval += q.values()[i] ? static_cast<std::size_t>(q.lengths()[i]) : 0;
+    }
+    return retval;
+}
+
+template <typename Result>
+inline std::size_t result_size(const Result& res) noexcept {
+    std::size_t retval = 0;
+    const auto nfields = impl::nfields(res);
+    const auto ntuples = impl::ntuples(res);
+    for (int row = 0; row < ntuples; ++row) {
+        for (int column = 0; column < nfields; ++column) {
+            retval += impl::get_length(res, row, column);
+        }
+    }
+    return retval;
+}
+
 template <typename Continuation, typename ...Ts>
 inline void write_poll(const request_operation_context_ptr<Ts...>& ctx, Continuation&& c) {
     write_poll(get_connection(ctx), std::forward<Continuation>(c));
@@ -96,10 +147,30 @@ inline void read_poll(const request_operation_context_ptr<Ts...>& ctx, Continuat
     read_poll(get_connection(ctx), std::forward<Continuation>(c));
 }
 
+/**
+ * Indicates the query is a batch of queries which are sent in a single pipeline,
+ * see `async_pipeline_request()` and `async_get_results_op`.
+ */
+template <typename T>
+struct is_query_batch : std::false_type {};
+
+template <typename T>
+constexpr bool QueryBatch = is_query_batch<std::decay_t<T>>::value;
+
+template <typename T, typename Query>
+inline bool send_pipelined(T& conn, Query&& query) {
+    return send_query_params(conn, std::forward<Query>(query));
+}
+
+template <typename Context>
+using request_trace_time_point = typename decltype(std::declval<Context>()->trace)::time_point;
+
 template <typename Context, typename BinaryQuery>
 struct async_send_query_params_op {
     Context ctx_;
     BinaryQuery query_;
+    request_trace_time_point<Context> flush_start_;
+    detail::stopwatch<detail::probes_enabled> flush_time_;
 
     async_send_query_params_op(Context ctx, BinaryQuery query)
     : ctx_(std::move(ctx)), query_(std::move(query)) {}
@@ -110,13 +181,67 @@ struct async_send_query_params_op {
             return done(ctx_, ec);
         }
 
-        if (!send_query_params(conn, query_)) {
-            return done(ctx_, error::pg_send_query_params_failed);
+        const auto send_start = ctx_->trace.now();
+        [[maybe_unused]] const detail::stopwatch<detail::probes_enabled> send_time;
+        if (auto ec = send(conn)) {
+            ctx_->trace.span(trace::phase::send, send_start, ec);
+            return done(ctx_, ec);
         }
+        ctx_->trace.span(trace::phase::send, send_start);
+        OZO_PROBE(query__send, detail::probe_fd(conn), detail::probe_name(ctx_->query_name),
+            detail::probe_ns(send_time.elapsed()));
 
+        flush_start_ = ctx_->trace.now();
+        flush_time_.restart();
         (*this)();
     }
 
+    template <typename Connection>
+    error_code send(Connection& conn) {
+        if constexpr (QueryBatch<BinaryQuery>) {
+            return send_pipeline(conn, ctx_->deferred);
+        } else {
+            if constexpr (PipelineSupported<Connection>) {
+                if (ctx_->deferred) {
+                    return send_pipeline(conn, ctx_->deferred);
+                }
+            }
+            if (!send_query_params(conn, query_)) {
+                return error::pg_send_query_params_failed;
+            }
+            return {};
+        }
+    }
+
+    // Sends the deferred statements and the query or the batch of queries
+    // in a single pipeline, so all of them take one round trip. The deferred
+    // statements are dropped by the connection only if the pipeline is sent,
+    // otherwise they stay for the next request.
+    template <typename Connection>
+    error_code send_pipeline(Connection& conn, const deferred_statements& deferred) {
+        if (auto ec = enter_pipeline_mode(conn)) {
+            return ec;
+        }
+        const auto send_statement = [&] (const char* text) {
+            return !text || send_query_params(conn,
+                binary_query(ozo::make_query(text), get_oid_map(conn), std::allocator<char>{}));
+        };
+        error_code ec;
+        if (!send_statement(deferred.prologue)
+                || !send_pipelined(conn, query_)
+                || !send_statement(deferred.epilogue)) {
+            ec = error::pg_send_query_params_failed;
+        } else {
+            ec = pipeline_sync(conn);
+        }
+        if (ec) {
+            exit_pipeline_mode(conn);
+            return ec;
+        }
+        take_deferred_statements(conn);
+        return {};
+    }
+
     void operator () (error_code ec = error_code{}, std::size_t = 0) {
         // if data has been flushed or error has been set by
         // read operation no write opertion handling is needed
@@ -128,6 +253,7 @@ struct async_send_query_params_op {
         // In case of write operation error - finish the request
         // with error.
         if (ec) {
+            ctx_->trace.span(trace::phase::flush, flush_start_, ec);
             return done(ctx_, ec);
         }
 
@@ -135,6 +261,7 @@ struct async_send_query_params_op {
         // documentation
         switch (flush_output(get_connection(ctx_))) {
             case query_state::error:
+                ctx_->trace.span(trace::phase::flush, flush_start_, error::pg_flush_failed);
                 done(ctx_, error::pg_flush_failed);
                 break;
             case query_state::send_in_progress:
@@ -142,6 +269,13 @@ struct async_send_query_params_op {
                 break;
             case query_state::send_finish:
                 set_query_state(ctx_, query_state::send_finish);
+                ctx_->trace.span(trace::phase::flush, flush_start_);
+                OZO_PROBE(query__flush, detail::probe_fd(get_connection(ctx_)),
+                    detail::probe_name(ctx_->query_name), detail::probe_ns(flush_time_.elapsed()));
+                if constexpr (RequestStatisticsEnabled<Context>) {
+                    collect_statistics(get_connection(ctx_),
+                        event::send{ctx_->stopwatch.elapsed(), query_size(query_)});
+                }
                 break;
         }
     }
@@ -174,6 +308,39 @@ inline auto make_binary_query(binary_query<Ts...> query, M&&, A&&) {
     return std::move(query);
 }
 
+template <typename Query, typename = std::void_t<>>
+struct encoded_query_name {};
+
+template <typename Query>
+struct encoded_query_name<Query, std::enable_if_t<NamedQuery<Query>>> {
+    static constexpr decltype(get_raw_query_name<Query>()) name {};
+};
+
+/**
+ * Query already encoded into the binary form, so it is sent as is whatever OID map the
+ * connection has. The name of the original #NamedQuery is kept for tracing and statistics.
+ */
+template <typename Query, typename BinaryQuery>
+struct encoded_query : encoded_query_name<Query> {
+    BinaryQuery binary;
+
+    explicit encoded_query(BinaryQuery binary) : binary(std::move(binary)) {}
+};
+
+template <typename Query, typename BinaryQuery, typename M, typename A>
+inline BinaryQuery make_binary_query(encoded_query<Query, BinaryQuery> query, M&&, A&&) {
+    return std::move(query.binary);
+}
+
+template <typename T>
+struct is_encoded_query : std::false_type {};
+
+template <typename Query, typename BinaryQuery>
+struct is_encoded_query<encoded_query<Query, BinaryQuery>> : std::true_type {};
+
+template <typename T>
+constexpr bool EncodedQuery = is_encoded_query<std::decay_t<T>>::value;
+
 template <typename Context, typename Query>
 void async_send_query_params(std::shared_ptr<Context> ctx, Query&& query) {
     auto q = make_binary_query(std::forward<Query>(query),
@@ -190,11 +357,15 @@ template <typename Context, typename ResultProcessor>
 struct async_get_result_op : boost::asio::coroutine {
     Context ctx_;
     ResultProcessor process_;
+    request_trace_time_point<Context> wait_start_;
+    detail::stopwatch<detail::probes_enabled> wait_time_;
 
     async_get_result_op(Context ctx, ResultProcessor process)
     : ctx_(ctx), process_(process) {}
 
     void perform() {
+        wait_start_ = ctx_->trace.now();
+        wait_time_.restart();
         (*this)();
     }
 
@@ -228,11 +399,15 @@ struct async_get_result_op : boost::asio::coroutine {
         reenter(*this) {
             while (is_busy(get_connection(ctx_))) {
                 yield read_poll(ctx_, *this);
+                input_received(ctx_);
                 if (auto err = consume_input(get_connection(ctx_))) {
                     return done(err);
                 }
             }
 
+            ctx_->trace.span(trace::phase::wait, wait_start_);
+            OZO_PROBE(result__ready, detail::probe_fd(get_connection(ctx_)),
+                detail::probe_name(ctx_->query_name), detail::probe_ns(wait_time_.elapsed()));
             set_request_result(ctx_, get_result(get_connection(ctx_)));
 
             if (!get_request_result(ctx_)) {
@@ -288,12 +463,28 @@ struct async_get_result_op : boost::asio::coroutine {
 
     template <typename Result>
     void process_and_done(Result&& res) noexcept {
+        const auto decode_start = ctx_->trace.now();
+        [[maybe_unused]] const detail::stopwatch<detail::probes_enabled> decode_time;
+        OZO_PROBE(decode__start, detail::probe_fd(get_connection(ctx_)),
+            detail::probe_name(ctx_->query_name), impl::ntuples(*res));
         try {
-            process_(std::forward<Result>(res), get_connection(ctx_));
+            if constexpr (RequestStatisticsEnabled<Context>) {
+                const auto rows = static_cast<std::size_t>(impl::ntuples(*res));
+                const auto bytes = result_size(*res);
+                const detail::stopwatch<true> stopwatch;
+                process_(std::forward<Result>(res), get_connection(ctx_));
+                collect_statistics(get_connection(ctx_), event::decode{stopwatch.elapsed(), rows, bytes, ctx_->query_name});
+            } else {
+                process_(std::forward<Result>(res), get_connection(ctx_));
+            }
         } catch (const std::exception& e) {
+            ctx_->trace.span(trace::phase::decode, decode_start, error::bad_result_process);
             set_error_context(get_connection(ctx_), e.what());
             return done(error::bad_result_process);
         }
+        ctx_->trace.span(trace::phase::decode, decode_start);
+        OZO_PROBE(decode__finish, detail::probe_fd(get_connection(ctx_)),
+            detail::probe_name(ctx_->query_name), detail::probe_ns(decode_time.elapsed()));
         done();
     }
 
@@ -310,30 +501,196 @@ struct async_get_result_op : boost::asio::coroutine {
     }
 };
 
+#ifdef LIBPQ_HAS_PIPELINING
+
+/**
+ * Receives results of a pipeline sent by `async_send_query_params_op::send_pipeline()`.
+ * Results of the deferred statements are checked and dropped, the result of the request
+ * query is handled as `async_get_result_op` does.
+ */
+template <typename Context, typename ResultProcessor>
+struct async_get_pipeline_result_op : boost::asio::coroutine {
+    Context ctx_;
+    ResultProcessor process_;
+    request_trace_time_point<Context> wait_start_;
+    detail::stopwatch<detail::probes_enabled> wait_time_;
+    std::size_t index_ = 0;
+    error_code error_;
+
+    async_get_pipeline_result_op(Context ctx, ResultProcessor process)
+    : ctx_(ctx), process_(process) {}
+
+    void perform() {
+        wait_start_ = ctx_->trace.now();
+        wait_time_.restart();
+        (*this)();
+    }
+
+    void done(error_code ec) {
+        if (std::empty(get_error_context(get_connection(ctx_)))) {
+            set_error_context(get_connection(ctx_), "error while get pipeline result");
+        }
+        return impl::done(ctx_, ec);
+    }
+
+    void operator() (error_code ec = error_code{}, std::size_t = 0) {
+        if (get_query_state(ctx_) == query_state::error) {
+            return;
+        }
+
+        if (ec) {
+            if (ec == asio::error::bad_descriptor) {
+                ec = asio::error::operation_aborted;
+            }
+            return done(ec);
+        }
+
+        reenter(*this) {
+            do {
+                while (is_busy(get_connection(ctx_))) {
+                    yield read_poll(ctx_, *this);
+                    input_received(ctx_);
+                    if (auto err = consume_input(get_connection(ctx_))) {
+                        return done(err);
+                    }
+                }
+            } while (accept(get_result(get_connection(ctx_))));
+
+            ctx_->trace.span(trace::phase::wait, wait_start_);
+            OZO_PROBE(result__ready, detail::probe_fd(get_connection(ctx_)),
+                detail::probe_name(ctx_->query_name), detail::probe_ns(wait_time_.elapsed()));
+
+            if (auto err = exit_pipeline_mode(get_connection(ctx_))) {
+                return done(err);
+            }
+
+            if (error_) {
+                return done(error_);
+            }
+
+            if (!get_request_result(ctx_)) {
+                set_error_context(get_connection(ctx_), "no result of the pipelined query");
+                return done(error::result_status_unexpected);
+            }
+
+            const auto status = result_status(*get_request_result(ctx_));
+            if (status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK) {
+                complete_deferred_statements(get_connection(ctx_), ctx_->deferred);
+            }
+
+            async_get_result_op<Context, ResultProcessor>{ctx_, std::move(process_)}.handle_result();
+        }
+    }
+
+    // Returns false on the pipeline synchronization point which follows the last result.
+    template <typename Result>
+    bool accept(Result&& res) {
+        if (!res) {
+            ++index_;
+            return true;
+        }
+        const auto status = result_status(*res);
+        if (status == PGRES_PIPELINE_SYNC) {
+            return false;
+        }
+        if (status == PGRES_PIPELINE_ABORTED) {
+            return true;
+        }
+        if (index_ == query_index()) {
+            if (!get_request_result(ctx_)) {
+                set_request_result(ctx_, std::forward<Result>(res));
+            }
+            return true;
+        }
+        if (!error_ && status != PGRES_COMMAND_OK) {
+            error_ = status == PGRES_FATAL_ERROR
+                ? result_error(*res) : error_code{error::result_status_unexpected};
+        }
+        return true;
+    }
+
+    std::size_t query_index() const noexcept {
+        return ctx_->deferred.prologue ? 1 : 0;
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(get_handler(ctx_)))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(get_handler(ctx_));
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(get_handler(ctx_)))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(get_handler(ctx_));
+    }
+};
+
+#endif
+
 #include <boost/asio/unyield.hpp>
 
 template <typename Context, typename ResultProcessor>
 inline void async_get_result(Context&& ctx, ResultProcessor&& p) {
+#ifdef LIBPQ_HAS_PIPELINING
+    if constexpr (PipelineSupported<std::decay_t<decltype(get_connection(ctx))>>) {
+        if (ctx->deferred) {
+            async_get_pipeline_result_op op{std::forward<Context>(ctx), std::forward<ResultProcessor>(p)};
+            return op.perform();
+        }
+    }
+#endif
     async_get_result_op op{std::forward<Context>(ctx), std::forward<ResultProcessor>(p)};
     op.perform();
 }
 
-template <typename OutHandler, typename Query, typename TimeConstraint, typename Handler>
+/**
+ * Indicates the connection is shared with other requests, so requests are executed by the
+ * connection itself via `async_multiplexed_request()`, see `ozo::connection_multiplexer`.
+ */
+template <typename T>
+struct is_multiplexed_connection : std::false_type {};
+
+template <typename T>
+constexpr bool MultiplexedConnection = is_multiplexed_connection<std::decay_t<T>>::value;
+
+template <typename OutHandler, typename Query, typename TimeConstraint, typename Handler,
+        typename Stopwatch = detail::stopwatch<false>>
 struct async_request_op {
     OutHandler out_;
     Query query_;
     TimeConstraint time_constrain_;
     Handler handler_;
+    Stopwatch stopwatch_;
+    trace::request<> trace_;
 
-    async_request_op(Query query, TimeConstraint time_constrain, OutHandler out, Handler handler)
-    : out_(std::move(out)), query_(std::move(query)), time_constrain_(time_constrain), handler_(std::move(handler)) {}
+    async_request_op(Query query, TimeConstraint time_constrain, OutHandler out, Handler handler,
+            Stopwatch stopwatch = Stopwatch{})
+    : out_(std::move(out)), query_(std::move(query)), time_constrain_(time_constrain),
+      handler_(std::move(handler)), stopwatch_(stopwatch), trace_(trace::query_name(query_)) {}
 
     template <typename Connection>
     void operator() (error_code ec, Connection conn) {
         if (ec) {
+            trace_.span(trace::phase::acquire, trace_.start(), ec);
             return handler_(ec, std::move(conn));
         }
 
+        if constexpr (MultiplexedConnection<Connection>) {
+            if (!conn.pinned()) {
+                return async_multiplexed_request(std::move(conn), std::move(query_),
+                    time_constrain_, std::move(out_), std::move(handler_));
+            }
+        }
+
+        collect_statistics(conn, event::acquire{stopwatch_.elapsed()});
+        trace_.span(trace::phase::acquire, trace_.start());
+
+        deferred_statements deferred;
+        if constexpr (PipelineSupported<Connection>) {
+            deferred = get_deferred_statements(conn);
+        }
+
         auto strand = ozo::detail::make_strand_executor(ozo::get_executor(conn));
 
         auto ctx = make_request_operation_context(
@@ -342,6 +699,9 @@ struct async_request_op {
                 detail::post_handler(std::move(handler_))
             ))
         );
+        ctx->query_name = trace::query_name(query_);
+        ctx->trace = trace_;
+        ctx->deferred = deferred;
         detail::set_io_timeout(get_connection(ctx), get_handler(ctx), time_constrain_);
 
         async_send_query_params(ctx, std::move(query_));
@@ -377,14 +737,15 @@ struct async_request_out_handler {
 template <typename P, typename Q, typename TimeConstraint, typename Out, typename Handler>
 inline void async_request(P&& provider, Q&& query, TimeConstraint t, Out&& out, Handler&& handler) {
     static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
-    static_assert(Query<Q> || QueryBuilder<Q>, "is neither Query nor QueryBuilder");
+    static_assert(Query<Q> || QueryBuilder<Q> || EncodedQuery<Q>, "is neither Query nor QueryBuilder");
     static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
     async_get_connection(std::forward<P>(provider), deadline(t),
         async_request_op{
             std::forward<Q>(query),
             deadline(t),
             async_request_out_handler{std::forward<Out>(out)},
-            std::forward<Handler>(handler)
+            std::forward<Handler>(handler),
+            detail::stopwatch<ProviderStatisticsEnabled<P>>{}
         }
     );
 }
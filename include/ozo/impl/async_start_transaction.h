@@ -6,6 +6,26 @@
 
 namespace ozo::impl {
 
+template <typename T, typename = std::void_t<>>
+struct has_exclusive_provider : std::false_type {};
+
+template <typename T>
+struct has_exclusive_provider<T, std::void_t<decltype(std::declval<T&>().exclusive())>> : std::true_type {};
+
+/**
+ * Provider of connections which are not shared with other requests, so they may hold
+ * a transaction. Providers which share connections, e.g. `ozo::connection_multiplexer`,
+ * give it via the `exclusive()` member function.
+ */
+template <typename T>
+constexpr decltype(auto) get_exclusive_provider(T&& provider) {
+    if constexpr (has_exclusive_provider<std::decay_t<T>>::value) {
+        return provider.exclusive();
+    } else {
+        return std::forward<T>(provider);
+    }
+}
+
 template <typename Handler>
 struct async_start_transaction_op {
     Handler handler;
@@ -14,7 +34,7 @@ struct async_start_transaction_op {
     void perform(T&& provider, Query&& query, TimeConstraint t) {
         static_assert(ConnectionProvider<T>, "T is not a ConnectionProvider");
         static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
-        async_execute(std::forward<T>(provider), std::forward<Query>(query),
+        async_execute(get_exclusive_provider(std::forward<T>(provider)), std::forward<Query>(query),
             t, std::move(*this));
     }
 
@@ -42,4 +62,47 @@ Require<ConnectionProvider<T>> async_start_transaction(T&& provider, Query&& que
         .perform(std::forward<T>(provider), std::forward<Query>(query), t);
 }
 
+template <typename Handler>
+struct async_start_deferred_transaction_op {
+    Handler handler;
+    const char* statement;
+
+    template <typename Connection>
+    void operator ()(error_code ec, Connection&& connection) {
+        auto transaction = make_transaction(std::forward<Connection>(connection));
+        if (!ec) {
+            transaction.defer_begin(statement);
+        }
+        asio::dispatch(detail::bind(std::move(handler), std::move(ec), std::move(transaction)));
+    }
+
+    using executor_type = decltype(asio::get_associated_executor(handler));
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler);
+    }
+
+    using allocator_type = decltype(asio::get_associated_allocator(handler));
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler);
+    }
+};
+
+/**
+ * Gets a connection and makes a transaction with the starting statement deferred
+ * until the first request, see `ozo::impl::transaction::defer_begin()`.
+ */
+template <typename T, typename TimeConstraint, typename Handler>
+Require<ConnectionProvider<T>> async_start_deferred_transaction(T&& provider, const char* statement,
+        TimeConstraint t, Handler&& handler) {
+    static_assert(PipelineSupported<connection_type<T>>, "connection should support pipeline mode");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    async_get_connection(get_exclusive_provider(std::forward<T>(provider)), deadline(t),
+        async_start_deferred_transaction_op<std::decay_t<Handler>> {
+            std::forward<Handler>(handler), statement
+        }
+    );
+}
+
 } // namespace ozo::impl
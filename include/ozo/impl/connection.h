@@ -22,7 +22,7 @@ struct connection_impl {
     native_conn_handle handle_;
     asio::posix::stream_descriptor socket_;
     OidMap oid_map_;
-    Statistics statistics_; // statistics metatypes to be defined - counter, duration, whatever?
+    Statistics statistics_;
     std::string error_context_;
     asio::steady_timer timer_;
 };
@@ -2,6 +2,8 @@
 
 #include <ozo/connection.h>
 #include <ozo/transaction_status.h>
+#include <ozo/detail/probe.h>
+#include <ozo/detail/stopwatch.h>
 #include <yamail/resource_pool/async/pool.hpp>
 #include <ozo/asio.h>
 #include <ozo/ext/std/shared_ptr.h>
@@ -22,6 +24,7 @@ struct pooled_connection {
     using underlying_type = typename handle_type::value_type;
 
     handle_type handle_;
+    detail::stopwatch<detail::probes_enabled> hold_time_;
 
     pooled_connection(handle_type&& handle) : handle_(std::move(handle)) {}
 
@@ -32,8 +35,11 @@ struct pooled_connection {
     }
 
     ~pooled_connection() {
-        if (!empty() && (connection_bad(*this)
-                || get_transaction_status(*this) != transaction_status::idle)) {
+        const bool waste = !empty() && (connection_bad(*this)
+                || get_transaction_status(*this) != transaction_status::idle);
+        OZO_PROBE(pool__release, empty() ? -1 : detail::probe_fd(*this),
+            detail::probe_ns(hold_time_.elapsed()), waste);
+        if (waste) {
             handle_.waste();
         }
     }
@@ -70,6 +76,7 @@ struct pooled_connection_wrapper {
     Source source_;
     Handler handler_;
     TimeConstraint time_constrain_;
+    detail::stopwatch<detail::probes_enabled> wait_time_ {};
 
     using connection = pooled_connection<Source>;
     using connection_ptr = pooled_connection_ptr<Source>;
@@ -110,6 +117,8 @@ struct pooled_connection_wrapper {
         }
 
         auto conn = std::allocate_shared<connection>(get_allocator(), std::forward<Handle>(handle));
+        OZO_PROBE(pool__acquire, connection_good(conn) ? detail::probe_fd(conn) : -1,
+            detail::probe_ns(wait_time_.elapsed()));
         if (connection_good(conn)) {
             ec = rebind_io_context(conn, io_);
             return handler_(std::move(ec), std::move(conn));
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <ozo/impl/async_execute.h>
+#include <ozo/impl/async_request.h>
+#include <ozo/impl/transaction.h>
+#include <ozo/query_builder.h>
+#include <ozo/io/recv.h>
+
+#include <boost/hana/unpack.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace ozo {
+
+/**
+ * @brief Server-side cursor configuration
+ *
+ * Rows are fetched in batches, the next batch is requested as soon as the previous one
+ * is received. The batch size is doubled while the consumer has to wait for a batch and
+ * halved while batches arrive before the consumer has got a half of the previous one.
+ */
+struct cursor_config {
+    std::size_t initial_batch = 128; //!< number of rows requested by the first FETCH
+    std::size_t min_batch = 16; //!< lower bound of the batch size
+    std::size_t max_batch = 8192; //!< upper bound of the batch size
+};
+
+} // namespace ozo
+
+namespace ozo::impl {
+
+inline std::string make_cursor_name() {
+    static std::atomic<std::uint64_t> counter {0};
+    return "ozo_cursor_" + std::to_string(counter.fetch_add(1, std::memory_order_relaxed));
+}
+
+template <typename Q>
+auto make_declare_cursor_query(const std::string& name, const Q& query) {
+    if constexpr (QueryBuilder<Q>) {
+        return make_declare_cursor_query(name, query.build());
+    } else {
+        static_assert(Query<Q>, "is neither Query nor QueryBuilder");
+        std::string text = "DECLARE " + name + " BINARY NO SCROLL CURSOR FOR ";
+        text += to_const_char(get_text(query));
+        return hana::unpack(get_params(query), [&] (const auto& ...params) {
+            return make_query(std::move(text), params...);
+        });
+    }
+}
+
+/**
+ * Continuation of a cursor operation which waits for the FETCH in flight.
+ */
+struct cursor_waiter {
+    virtual ~cursor_waiter() = default;
+    virtual void resume() = 0;
+};
+
+template <typename Continuation>
+struct cursor_waiter_impl : cursor_waiter {
+    Continuation continuation_;
+
+    explicit cursor_waiter_impl(Continuation continuation) : continuation_(std::move(continuation)) {}
+
+    void resume() override { continuation_(); }
+};
+
+/**
+ * Statements a cursor is made of.
+ */
+struct cursor_operations {
+    template <typename Transaction, typename Query, typename TimeConstraint, typename Handler>
+    void request(Transaction&& transaction, Query&& query, TimeConstraint t, result& out, Handler&& handler) const {
+        async_request(std::forward<Transaction>(transaction), std::forward<Query>(query), t, std::ref(out),
+            std::forward<Handler>(handler));
+    }
+
+    template <typename Transaction, typename Query, typename TimeConstraint, typename Handler>
+    void execute(Transaction&& transaction, Query&& query, TimeConstraint t, Handler&& handler) const {
+        async_execute(std::forward<Transaction>(transaction), std::forward<Query>(query), t,
+            std::forward<Handler>(handler));
+    }
+};
+
+/**
+ * State of a declared cursor. The transaction is owned by the state while no FETCH is in
+ * flight, the received batches are decoded by the consumer while the next one is fetched,
+ * so decoding uses a copy of the connection OID map. A FETCH or CLOSE is limited by the
+ * time constraint of the call which issues it. All the operations run on a strand.
+ */
+template <typename Row, typename Transaction, typename Operations = cursor_operations>
+class cursor_state : public std::enable_shared_from_this<cursor_state<Row, Transaction, Operations>> {
+public:
+    using transaction_type = Transaction;
+    using oid_map_type = std::decay_t<decltype(get_oid_map(std::declval<Transaction&>()))>;
+    using executor_type = decltype(detail::make_strand_executor(ozo::get_executor(std::declval<Transaction&>())));
+
+    cursor_state(Transaction& transaction, std::string name, const cursor_config& config,
+            Operations ops = Operations{})
+    : ops_(std::move(ops)),
+      strand_(detail::make_strand_executor(ozo::get_executor(transaction))),
+      name_(std::move(name)),
+      oid_map_(get_oid_map(transaction)),
+      config_(config),
+      batch_size_(std::clamp(config.initial_batch, config.min_batch, config.max_batch)) {}
+
+    executor_type get_executor() const noexcept { return strand_; }
+
+    const std::string& name() const noexcept { return name_; }
+
+    std::size_t batch_size() const noexcept { return batch_size_; }
+
+    template <typename TimeConstraint>
+    void start(error_code ec, Transaction transaction, TimeConstraint t) {
+        constrain(t);
+        transaction_.emplace(std::move(transaction));
+        if (ec) {
+            error_ = ec;
+            exhausted_ = true;
+            return;
+        }
+        prefetch();
+    }
+
+    template <typename TimeConstraint, typename Handler>
+    void next(TimeConstraint t, Handler&& handler) {
+        constrain(t);
+        next(std::forward<Handler>(handler));
+    }
+
+    template <typename TimeConstraint, typename Handler>
+    void close(TimeConstraint t, Handler&& handler) {
+        constrain(t);
+        close(std::forward<Handler>(handler));
+    }
+
+private:
+    template <typename TimeConstraint>
+    void constrain(TimeConstraint t) {
+        if constexpr (std::is_same_v<TimeConstraint, none_t>) {
+            deadline_.reset();
+        } else {
+            deadline_ = deadline(t);
+        }
+    }
+
+    // Calls the statement with the deadline of the current call if any.
+    template <typename Statement>
+    void constrained(Statement&& statement) {
+        if (deadline_) {
+            return statement(*deadline_);
+        }
+        statement(none);
+    }
+
+    template <typename Handler>
+    void next(Handler&& handler) {
+        if (!current_ || position_ == current_->size()) {
+            if (fetching_) {
+                waited_ = current_.has_value();
+                return wait([self = this->shared_from_this(), h = std::forward<Handler>(handler)] () mutable {
+                    self->next(std::move(h));
+                });
+            }
+            if (error_ || !pending_) {
+                current_.reset();
+                return complete(std::forward<Handler>(handler), error_, __OZO_STD_OPTIONAL<Row>{});
+            }
+            current_ = std::move(pending_);
+            pending_.reset();
+            position_ = 0;
+            prefetch();
+            if (current_->empty()) {
+                return next(std::forward<Handler>(handler));
+            }
+        }
+        __OZO_STD_OPTIONAL<Row> row(std::in_place);
+        try {
+            recv_row((*current_)[static_cast<int>(position_)], oid_map_, *row);
+        } catch (const std::exception& e) {
+            if (transaction_) {
+                set_error_context(*transaction_, e.what());
+            }
+            // The row would fail again on the next call, so the cursor fails and ends.
+            error_ = error::bad_result_process;
+            exhausted_ = true;
+            current_.reset();
+            pending_.reset();
+            return complete(std::forward<Handler>(handler), error_, __OZO_STD_OPTIONAL<Row>{});
+        }
+        ++position_;
+        complete(std::forward<Handler>(handler), error_code{}, std::move(row));
+    }
+
+    template <typename Handler>
+    void close(Handler&& handler) {
+        if (fetching_) {
+            return wait([self = this->shared_from_this(), h = std::forward<Handler>(handler)] () mutable {
+                self->close(std::move(h));
+            });
+        }
+        current_.reset();
+        pending_.reset();
+        exhausted_ = true;
+        if (!transaction_) {
+            return complete(std::forward<Handler>(handler), error::bad_result_process, Transaction{});
+        }
+        auto transaction = std::move(*transaction_);
+        transaction_.reset();
+        if (error_) {
+            return complete(std::forward<Handler>(handler), error_, std::move(transaction));
+        }
+        constrained([&] (auto t) {
+            ops_.execute(std::move(transaction), make_query("CLOSE " + name_), t,
+                asio::bind_executor(strand_, [self = this->shared_from_this(), h = std::forward<Handler>(handler)]
+                        (error_code ec, Transaction transaction) mutable {
+                    self->complete(std::move(h), std::move(ec), std::move(transaction));
+                }));
+        });
+    }
+
+    template <typename Continuation>
+    void wait(Continuation&& continuation) {
+        waiter_ = std::make_unique<cursor_waiter_impl<std::decay_t<Continuation>>>(
+            std::forward<Continuation>(continuation));
+    }
+
+    template <typename Handler, typename ...Args>
+    void complete(Handler&& handler, Args&& ...args) {
+        asio::post(strand_, detail::bind(std::forward<Handler>(handler), std::forward<Args>(args)...));
+    }
+
+    void prefetch() {
+        if (exhausted_ || fetching_ || pending_ || !transaction_) {
+            return;
+        }
+        fetching_ = true;
+        requested_ = batch_size_;
+        auto transaction = std::move(*transaction_);
+        transaction_.reset();
+        constrained([&] (auto t) {
+            ops_.request(std::move(transaction),
+                make_query("FETCH " + std::to_string(requested_) + " FROM " + name_), t, fetched_,
+                asio::bind_executor(strand_, [self = this->shared_from_this()] (error_code ec, Transaction transaction) {
+                    self->on_fetch(ec, std::move(transaction));
+                }));
+        });
+    }
+
+    void on_fetch(error_code ec, Transaction transaction) {
+        fetching_ = false;
+        transaction_.emplace(std::move(transaction));
+        if (ec) {
+            error_ = ec;
+            exhausted_ = true;
+        } else {
+            adapt();
+            exhausted_ = fetched_.size() < requested_;
+            pending_.emplace(std::move(fetched_));
+            fetched_ = result{};
+        }
+        if (auto waiter = std::move(waiter_)) {
+            waiter->resume();
+        }
+    }
+
+    void adapt() {
+        if (std::exchange(waited_, false)) {
+            batch_size_ = std::min(batch_size_ * 2, config_.max_batch);
+        } else if (current_ && position_ < current_->size() / 2) {
+            batch_size_ = std::max(batch_size_ / 2, config_.min_batch);
+        }
+    }
+
+    Operations ops_;
+    executor_type strand_;
+    std::string name_;
+    oid_map_type oid_map_;
+    cursor_config config_;
+    std::size_t batch_size_;
+    std::size_t requested_ = 0;
+    __OZO_STD_OPTIONAL<Transaction> transaction_;
+    __OZO_STD_OPTIONAL<result> current_;
+    __OZO_STD_OPTIONAL<result> pending_;
+    result fetched_;
+    std::size_t position_ = 0;
+    bool fetching_ = false;
+    bool exhausted_ = false;
+    bool waited_ = false;
+    __OZO_STD_OPTIONAL<time_traits::time_point> deadline_;
+    error_code error_;
+    std::unique_ptr<cursor_waiter> waiter_;
+};
+
+} // namespace ozo::impl
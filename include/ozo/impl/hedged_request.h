@@ -0,0 +1,353 @@
+#pragma once
+
+#include <ozo/impl/async_request.h>
+#include <ozo/detail/histogram.h>
+
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/system_executor.hpp>
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <variant>
+
+namespace ozo {
+
+/**
+ * @brief Hedged requests configuration
+ *
+ * The hedge delay of a query is the percentile of the latencies of its requests via the primary provider.
+ * The initial delay is used until the number of samples is enough.
+ */
+struct hedging_config {
+    double percentile = 95; //!< percentile of latencies to use as the hedge delay
+    std::size_t min_samples = 32; //!< number of samples required to use the percentile
+    time_traits::duration initial_delay = std::chrono::milliseconds(10); //!< delay until samples are enough
+    time_traits::duration min_delay = std::chrono::milliseconds(1); //!< lower bound of the delay
+};
+
+} // namespace ozo
+
+namespace ozo::impl {
+
+/**
+ * Latencies of requests per query. Queries are identified by their names, or
+ * by their texts if they are not named.
+ */
+class hedging_state {
+public:
+    hedging_state(io_context& io, const hedging_config& config) : io_(io), config_(config) {}
+
+    io_context& get_io_context() const noexcept { return io_; }
+
+    time_traits::duration delay(const std::string& key) const {
+        const std::lock_guard lock(mutex_);
+        const auto i = entries_.find(key);
+        if (i == entries_.end() || i->second->latency.count() < config_.min_samples) {
+            return std::max(config_.initial_delay, config_.min_delay);
+        }
+        return std::max(time_traits::duration(i->second->delay.load(std::memory_order_relaxed)), config_.min_delay);
+    }
+
+    std::size_t samples(const std::string& key) const {
+        const std::lock_guard lock(mutex_);
+        const auto i = entries_.find(key);
+        return i == entries_.end() ? 0 : i->second->latency.count();
+    }
+
+    void record(const std::string& key, time_traits::duration latency) {
+        entry* e = nullptr;
+        {
+            const std::lock_guard lock(mutex_);
+            auto& ptr = entries_[key];
+            if (!ptr) {
+                ptr = std::make_unique<entry>();
+            }
+            e = ptr.get();
+        }
+        e->latency.record(static_cast<std::uint64_t>(std::max(latency.count(), time_traits::duration::rep(0))));
+        // Percentile of the histogram snapshot is relatively expensive, so it is updated periodically.
+        const auto count = e->latency.count();
+        if (count >= config_.min_samples && count % 16 == 0) {
+            const auto value = e->latency.snapshot().percentile(config_.percentile);
+            e->delay.store(static_cast<time_traits::duration::rep>(value), std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct entry {
+        detail::histogram<> latency;
+        std::atomic<time_traits::duration::rep> delay {0};
+    };
+
+    io_context& io_;
+    const hedging_config config_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<entry>> entries_;
+};
+
+template <typename Q>
+inline std::string get_hedging_key(const Q& query) {
+    if constexpr (QueryBuilder<Q>) {
+        return get_hedging_key(query.build());
+    } else {
+        static_assert(Query<Q>, "is neither Query nor QueryBuilder");
+        if (const auto name = trace::query_name(query); !name.empty()) {
+            return std::string(name);
+        }
+        return to_const_char(get_text(query));
+    }
+}
+
+struct pq_cancel_deleter {
+    void operator() (PGcancel* ptr) const noexcept { PQfreeCancel(ptr); }
+};
+
+using native_cancel_handle = std::shared_ptr<PGcancel>;
+
+/**
+ * Handle to cancel the request in progress on the connection server-side, an empty
+ * one for connections which are not based on libpq.
+ */
+template <typename Connection>
+inline native_cancel_handle get_cancel_handle(Connection& conn) {
+    if constexpr (std::is_same_v<std::decay_t<decltype(get_native_handle(conn))>, PGconn*>) {
+        return native_cancel_handle(PQgetCancel(get_native_handle(conn)), pq_cancel_deleter{});
+    } else {
+        return {};
+    }
+}
+
+/**
+ * Requests cancel of the query in progress. PQcancel blocks until the server
+ * receives the request, so it is called within the system executor, the handler
+ * is posted to its associated executor when the request is delivered.
+ */
+template <typename Handler>
+inline void cancel_request(native_cancel_handle handle, Handler&& handler) {
+    asio::post(asio::system_executor(), [handle = std::move(handle), h = std::forward<Handler>(handler)] () mutable {
+        if (handle) {
+            char error[256];
+            PQcancel(handle.get(), error, sizeof(error));
+        }
+        asio::post(std::move(h));
+    });
+}
+
+/**
+ * Operations a hedged request is made of.
+ */
+struct hedged_request_operations {
+    template <typename Provider, typename TimeConstraint, typename Handler>
+    void get_connection(Provider& provider, TimeConstraint t, Handler&& handler) const {
+        ozo::get_connection(provider, t, std::forward<Handler>(handler));
+    }
+
+    template <typename Connection, typename Query, typename TimeConstraint, typename Handler>
+    void request(Connection&& conn, const Query& query, TimeConstraint t, result& res, Handler&& handler) const {
+        async_request(std::forward<Connection>(conn), query, t, std::ref(res), std::forward<Handler>(handler));
+    }
+
+    template <typename Connection>
+    native_cancel_handle get_cancel_handle(Connection& conn) const {
+        return impl::get_cancel_handle(unwrap_connection(conn));
+    }
+
+    template <typename Handler>
+    void cancel(native_cancel_handle handle, Handler&& handler) const {
+        cancel_request(std::move(handle), std::forward<Handler>(handler));
+    }
+};
+
+template <typename P1, typename P2>
+using hedged_connection_type = std::conditional_t<
+    std::is_same_v<connection_type<P1>, connection_type<P2>>,
+    connection_type<P1>,
+    std::variant<connection_type<P1>, connection_type<P2>>
+>;
+
+/**
+ * State of a hedged request. The request is made via the primary provider and, if it is
+ * not completed within the hedge delay or fails, via the secondary one. The first success
+ * is decoded into the output and the other request is cancelled; its connection is kept
+ * until the cancel request is delivered, so the cancel can not hit a query of the next
+ * owner of the connection. All the member functions are called within the strand.
+ */
+template <typename P1, typename P2, typename Query, typename Out, typename TimeConstraint, typename Handler,
+          typename Operations = hedged_request_operations>
+class hedged_request_state
+        : public std::enable_shared_from_this<hedged_request_state<P1, P2, Query, Out, TimeConstraint, Handler, Operations>> {
+public:
+    using connection_type = hedged_connection_type<P1, P2>;
+    using executor_type = decltype(detail::make_strand_executor(std::declval<io_context&>().get_executor()));
+
+    hedged_request_state(std::shared_ptr<hedging_state> policy, P1 primary, P2 secondary, Query query,
+            TimeConstraint t, Out out, Handler handler, Operations ops = Operations{})
+    : ops_(std::move(ops)),
+      policy_(std::move(policy)),
+      providers_(std::move(primary), std::move(secondary)),
+      query_(std::move(query)),
+      time_constraint_(t),
+      out_(std::move(out)),
+      handler_(std::move(handler)),
+      key_(get_hedging_key(query_)),
+      strand_(detail::make_strand_executor(policy_->get_io_context().get_executor())),
+      timer_(policy_->get_io_context()) {}
+
+    void start() {
+        asio::dispatch(strand_, [self = this->shared_from_this()] {
+            self->timer_.expires_after(self->policy_->delay(self->key_));
+            self->timer_.async_wait(asio::bind_executor(self->strand_, [self] (error_code ec) {
+                if (!ec) {
+                    self->hedge();
+                }
+            }));
+            self->template attempt<0>();
+        });
+    }
+
+private:
+    static constexpr std::size_t attempts = 2;
+
+    struct attempt_state {
+        bool started = false;
+        bool finished = false;
+        bool cancelled = false;
+        bool cancelling = false;
+        time_traits::time_point start;
+        native_cancel_handle cancel;
+        std::shared_ptr<void> parked;
+        result res;
+    };
+
+    void hedge() {
+        if (!done_ && !attempts_[1].started) {
+            attempt<1>();
+        }
+    }
+
+    template <std::size_t I>
+    void attempt() {
+        attempts_[I].started = true;
+        attempts_[I].start = time_traits::now();
+        ops_.get_connection(std::get<I>(providers_), time_constraint_, asio::bind_executor(strand_,
+            [self = this->shared_from_this()] (error_code ec, ozo::connection_type<std::tuple_element_t<I, std::tuple<P1, P2>>> conn) {
+                self->template on_connection<I>(std::move(ec), std::move(conn));
+            }));
+    }
+
+    template <std::size_t I, typename Connection>
+    void on_connection(error_code ec, Connection conn) {
+        if (done_) {
+            attempts_[I].finished = true;
+            return;
+        }
+        if (ec) {
+            return finish<I>(std::move(ec), std::move(conn));
+        }
+        attempts_[I].cancel = ops_.get_cancel_handle(conn);
+        ops_.request(std::move(conn), query_, time_constraint_, attempts_[I].res,
+            asio::bind_executor(strand_, [self = this->shared_from_this()] (error_code ec, Connection conn) {
+                self->template finish<I>(std::move(ec), std::move(conn));
+            }));
+    }
+
+    template <std::size_t I, typename Connection>
+    void finish(error_code ec, Connection conn) {
+        auto& current = attempts_[I];
+        current.finished = true;
+        current.cancel.reset();
+        // Latencies of the primary are recorded even if it loses, otherwise only the fast
+        // requests are sampled and the delay shrinks. A cancelled request gives a lower bound.
+        if (I == 0 && (!ec || current.cancelled)) {
+            policy_->record(key_, time_traits::now() - current.start);
+        }
+        if (current.cancelling) {
+            current.parked = std::make_shared<Connection>(std::move(conn));
+        }
+        if (done_) {
+            return;
+        }
+        if (!ec) {
+            try {
+                recv_result(current.res, get_oid_map(conn), out_);
+            } catch (const std::exception& e) {
+                set_error_context(conn, e.what());
+                ec = error::bad_result_process;
+            }
+            return complete<I>(std::move(ec), std::move(conn));
+        }
+        if (I == 0 && !attempts_[1].started) {
+            timer_.cancel();
+            return attempt<1>();
+        }
+        auto& other = attempts_[1 - I];
+        if (other.started && !other.finished) {
+            return;
+        }
+        complete<I>(std::move(ec), std::move(conn));
+    }
+
+    template <std::size_t I, typename Connection>
+    void complete(error_code ec, Connection conn) {
+        done_ = true;
+        timer_.cancel();
+        for (auto& a : attempts_) {
+            cancel(a);
+        }
+        auto executor = asio::get_associated_executor(handler_, strand_);
+        asio::post(executor, detail::bind(std::move(handler_), std::move(ec), make_connection<I>(std::move(conn))));
+    }
+
+    void cancel(attempt_state& a) {
+        if (!a.cancel) {
+            return;
+        }
+        a.cancelled = true;
+        a.cancelling = true;
+        ops_.cancel(std::exchange(a.cancel, {}), asio::bind_executor(strand_, [self = this->shared_from_this(), &a] {
+            a.cancelling = false;
+            a.parked.reset();
+        }));
+    }
+
+    template <std::size_t I, typename Connection>
+    static connection_type make_connection(Connection&& conn) {
+        if constexpr (std::is_same_v<connection_type, std::decay_t<Connection>>) {
+            return std::forward<Connection>(conn);
+        } else {
+            return connection_type(std::in_place_index<I>, std::forward<Connection>(conn));
+        }
+    }
+
+    Operations ops_;
+    std::shared_ptr<hedging_state> policy_;
+    std::tuple<P1, P2> providers_;
+    Query query_;
+    TimeConstraint time_constraint_;
+    Out out_;
+    Handler handler_;
+    std::string key_;
+    executor_type strand_;
+    asio::steady_timer timer_;
+    std::array<attempt_state, attempts> attempts_;
+    bool done_ = false;
+};
+
+template <typename P1, typename P2, typename Q, typename TimeConstraint, typename Out, typename Handler>
+inline void async_hedged_request(std::shared_ptr<hedging_state> policy, P1&& primary, P2&& secondary,
+        Q&& query, TimeConstraint t, Out&& out, Handler&& handler) {
+    static_assert(ConnectionProvider<P1>, "primary is not a ConnectionProvider");
+    static_assert(ConnectionProvider<P2>, "secondary is not a ConnectionProvider");
+    static_assert(Query<Q> || QueryBuilder<Q>, "is neither Query nor QueryBuilder");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    using state_type = hedged_request_state<std::decay_t<P1>, std::decay_t<P2>, std::decay_t<Q>,
+        std::decay_t<Out>, decltype(deadline(t)), std::decay_t<Handler>>;
+    std::make_shared<state_type>(std::move(policy), std::forward<P1>(primary), std::forward<P2>(secondary),
+        std::forward<Q>(query), deadline(t), std::forward<Out>(out), std::forward<Handler>(handler))->start();
+}
+
+} // namespace ozo::impl
@@ -122,6 +122,22 @@ inline error_code pq_result_error(const PGresult& res) noexcept {
     return error::no_sql_state_found;
 }
 
+struct pq_notify_deleter {
+    void operator() (PGnotify* ptr) const noexcept { PQfreemem(ptr); }
+};
+
+using native_notify_handle = std::unique_ptr<PGnotify, pq_notify_deleter>;
+
+template <typename T>
+inline native_notify_handle pq_notifies(T& conn) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    return native_notify_handle(PQnotifies(get_native_handle(conn)));
+}
+
+inline std::size_t pq_result_memory_size(const PGresult& res) noexcept {
+    return PQresultMemorySize(std::addressof(res));
+}
+
 } // namespace pq
 
 template <typename T>
@@ -211,6 +227,19 @@ inline decltype(auto) get_result(T& conn) noexcept {
     return pq_get_result(unwrap_connection(conn));
 }
 
+template <typename T>
+inline decltype(auto) get_notification(T& conn) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    using pq::pq_notifies;
+    return pq_notifies(unwrap_connection(conn));
+}
+
+template <typename T>
+inline std::size_t result_memory_size(T&& res) noexcept {
+    using pq::pq_result_memory_size;
+    return pq_result_memory_size(std::forward<T>(res));
+}
+
 template <typename T>
 inline ExecStatusType result_status(T&& res) noexcept {
     using pq::pq_result_status;
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <ozo/impl/async_execute.h>
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Asynchronous notification
+ * @ingroup group-requests-types
+ *
+ * Notification received by a connection listening to a channel, see `NOTIFY` statement.
+ */
+struct notification {
+    std::string channel; //!< name of the channel
+    std::string payload; //!< payload of the notification, empty if none
+    int backend_pid = 0; //!< process id of the notifying server process
+};
+
+/**
+ * @brief Listener configuration
+ *
+ * The listener reconnects with a delay when the listening connection is lost or can not be
+ * established, see `ozo::listen()`.
+ */
+struct listener_config {
+    time_traits::duration subscribe_timeout = std::chrono::seconds(10); //!< time constraint of getting a connection and `LISTEN` statements
+    time_traits::duration reconnect_delay = std::chrono::seconds(1); //!< delay before the next subscription attempt
+    std::size_t max_queue_size = 65536; //!< number of notifications queued until they are received, 0 means no limit
+};
+
+} // namespace ozo
+
+namespace ozo::impl {
+
+inline std::string quote_identifier(const std::string& name) {
+    std::string retval;
+    retval.reserve(name.size() + 2);
+    retval.push_back('"');
+    for (const char c : name) {
+        if (c == '"') {
+            retval.push_back('"');
+        }
+        retval.push_back(c);
+    }
+    retval.push_back('"');
+    return retval;
+}
+
+inline auto make_listen_query(const std::string& channel) {
+    return make_query("LISTEN " + quote_identifier(channel));
+}
+
+/**
+ * Listens to the channels on the connection: executes `LISTEN` for each channel and then
+ * waits for notifications, each one is provided to `on_notify`. Listening is stopped with
+ * `UNLISTEN *` as soon as `on_notify` returns false, the handler is called with the connection
+ * then. A connection error stops listening too.
+ */
+template <typename OnNotify, typename TimeConstraint, typename Handler>
+struct async_listen_op {
+    std::vector<std::string> channels_;
+    OnNotify on_notify_;
+    TimeConstraint time_constraint_;
+    Handler handler_;
+    std::size_t next_ = 0;
+    bool stopped_ = false;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection conn) {
+        if (ec || stopped_) {
+            return handler_(std::move(ec), std::move(conn));
+        }
+        if (next_ < channels_.size()) {
+            auto query = make_listen_query(channels_[next_++]);
+            return async_execute(std::move(conn), std::move(query), time_constraint_, std::move(*this));
+        }
+        wait(std::move(conn));
+    }
+
+    template <typename Connection>
+    void wait(Connection conn) {
+        while (auto notify = get_notification(conn)) {
+            if (!on_notify_(notification {notify->relname, notify->extra, notify->be_pid})) {
+                stopped_ = true;
+                return async_execute(std::move(conn), make_query("UNLISTEN *"), none, std::move(*this));
+            }
+        }
+        auto& socket = get_socket(unwrap_connection(conn));
+        auto executor = asio::get_associated_executor(handler_, ozo::get_executor(conn));
+        socket.async_read_some(asio::null_buffers(), asio::bind_executor(executor,
+            [self = std::move(*this), conn = std::move(conn)] (error_code ec, std::size_t) mutable {
+                if (!ec) {
+                    ec = consume_input(conn);
+                }
+                if (ec) {
+                    set_error_context(conn, "error while waiting for notifications");
+                    return self.handler_(std::move(ec), std::move(conn));
+                }
+                self.wait(std::move(conn));
+            }));
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename P, typename OnNotify, typename TimeConstraint, typename Handler>
+inline void async_listen(P&& provider, std::vector<std::string> channels, OnNotify&& on_notify,
+        TimeConstraint t, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(!MultiplexedConnection<connection_type<P>>,
+        "shared connection of a multiplexer can not listen to channels");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    async_get_connection(std::forward<P>(provider), deadline(t),
+        async_listen_op<std::decay_t<OnNotify>, decltype(deadline(t)), std::decay_t<Handler>> {
+            std::move(channels),
+            std::forward<OnNotify>(on_notify),
+            deadline(t),
+            std::forward<Handler>(handler)
+        }
+    );
+}
+
+/**
+ * Type-erased handler waiting for a notification.
+ */
+struct notification_waiter {
+    virtual ~notification_waiter() = default;
+    virtual void operator() (error_code ec, notification n) = 0;
+};
+
+template <typename Handler>
+struct notification_waiter_impl : notification_waiter {
+    Handler handler_;
+
+    explicit notification_waiter_impl(Handler handler) : handler_(std::move(handler)) {}
+
+    void operator() (error_code ec, notification n) override {
+        asio::post(detail::bind(std::move(handler_), std::move(ec), std::move(n)));
+    }
+};
+
+/**
+ * Operations a listener is made of.
+ */
+struct listener_operations {
+    template <typename Provider, typename TimeConstraint, typename Handler>
+    void get_connection(Provider& provider, TimeConstraint t, Handler&& handler) const {
+        ozo::get_connection(provider, t, std::forward<Handler>(handler));
+    }
+
+    template <typename Connection, typename OnNotify, typename TimeConstraint, typename Handler>
+    void listen(Connection&& conn, std::vector<std::string> channels, OnNotify&& on_notify,
+            TimeConstraint t, Handler&& handler) const {
+        async_listen(std::forward<Connection>(conn), std::move(channels), std::forward<OnNotify>(on_notify), t,
+            std::forward<Handler>(handler));
+    }
+};
+
+/**
+ * State of `ozo::listener`. Keeps a dedicated connection listening to the channels and
+ * queues the notifications until they are received. The subscription is repeated with
+ * a new connection after the delay when the connection is lost. When the queue is full
+ * the queued notifications are replaced with `error::notifications_lost`. All the member
+ * functions are called within the strand.
+ */
+template <typename Provider, typename Operations = listener_operations>
+class listener_state : public std::enable_shared_from_this<listener_state<Provider, Operations>> {
+public:
+    using connection_type = ozo::connection_type<Provider>;
+    using executor_type = decltype(detail::make_strand_executor(std::declval<io_context&>().get_executor()));
+
+    listener_state(Provider provider, std::vector<std::string> channels, io_context& io,
+            const listener_config& config, Operations ops = Operations{})
+    : ops_(std::move(ops)),
+      provider_(std::move(provider)),
+      channels_(std::move(channels)),
+      config_(config),
+      strand_(detail::make_strand_executor(io.get_executor())),
+      timer_(io) {}
+
+    executor_type get_executor() const noexcept { return strand_; }
+
+    void subscribe() {
+        if (closed_) {
+            return;
+        }
+        ops_.get_connection(provider_, config_.subscribe_timeout, asio::bind_executor(strand_,
+            [self = this->shared_from_this()] (error_code ec, connection_type conn) {
+                self->on_connect(std::move(ec), std::move(conn));
+            }));
+    }
+
+    template <typename Handler>
+    void receive(Handler&& handler) {
+        auto executor = asio::get_associated_executor(handler, strand_);
+        auto bound = asio::bind_executor(executor, std::forward<Handler>(handler));
+        using waiter_type = notification_waiter_impl<decltype(bound)>;
+        if (!queue_.empty()) {
+            auto [ec, n] = std::move(queue_.front());
+            queue_.pop_front();
+            return waiter_type{std::move(bound)}(ec, std::move(n));
+        }
+        if (closed_) {
+            return waiter_type{std::move(bound)}(asio::error::operation_aborted, notification{});
+        }
+        // Receive operations must not be concurrent, the replaced one is not left hanging.
+        if (auto replaced = std::exchange(waiter_, std::make_unique<waiter_type>(std::move(bound)))) {
+            (*replaced)(asio::error::operation_aborted, notification{});
+        }
+    }
+
+    void close() {
+        closed_ = true;
+        timer_.cancel();
+        if (socket_) {
+            error_code ec;
+            socket_->cancel(ec);
+        }
+        push(asio::error::operation_aborted, notification{});
+        queue_.clear();
+    }
+
+    bool closed() const noexcept { return closed_; }
+
+private:
+    void on_connect(error_code ec, connection_type conn) {
+        if (ec) {
+            return retry();
+        }
+        if (closed_) {
+            return close_connection(conn);
+        }
+        connected_ = true;
+        socket_ = std::addressof(get_socket(unwrap_connection(conn)));
+        auto on_notify = [self = this->shared_from_this()] (const notification& n) {
+            if (self->closed_) {
+                return false;
+            }
+            self->push(error_code{}, n);
+            return true;
+        };
+        ops_.listen(std::move(conn), channels_, std::move(on_notify), config_.subscribe_timeout,
+            asio::bind_executor(strand_, [self = this->shared_from_this()] (error_code, connection_type conn) {
+                self->on_done(std::move(conn));
+            }));
+    }
+
+    void on_done(connection_type conn) {
+        socket_ = nullptr;
+        close_connection(conn);
+        if (std::exchange(connected_, false) && !closed_) {
+            push(error::notifications_lost, notification{});
+        }
+        retry();
+    }
+
+    void retry() {
+        if (closed_) {
+            return;
+        }
+        timer_.expires_after(config_.reconnect_delay);
+        timer_.async_wait(asio::bind_executor(strand_, [self = this->shared_from_this()] (error_code ec) {
+            if (!ec) {
+                self->subscribe();
+            }
+        }));
+    }
+
+    void push(error_code ec, notification n) {
+        if (auto waiter = std::move(waiter_)) {
+            return (*waiter)(std::move(ec), std::move(n));
+        }
+        if (closed_) {
+            return;
+        }
+        if (config_.max_queue_size != 0 && queue_.size() >= config_.max_queue_size) {
+            queue_.clear();
+            queue_.emplace_back(error::notifications_lost, notification{});
+        }
+        queue_.emplace_back(std::move(ec), std::move(n));
+    }
+
+    using socket_type = std::decay_t<decltype(get_socket(unwrap_connection(std::declval<connection_type&>())))>;
+
+    Operations ops_;
+    Provider provider_;
+    std::vector<std::string> channels_;
+    const listener_config config_;
+    executor_type strand_;
+    asio::steady_timer timer_;
+    std::deque<std::pair<error_code, notification>> queue_;
+    std::unique_ptr<notification_waiter> waiter_;
+    socket_type* socket_ = nullptr;
+    bool connected_ = false;
+    bool closed_ = false;
+};
+
+} // namespace ozo::impl
@@ -0,0 +1,742 @@
+#pragma once
+
+#include <ozo/impl/async_request.h>
+#include <ozo/impl/pipeline.h>
+#include <ozo/transaction_status.h>
+
+#include <boost/asio/steady_timer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ozo {
+
+struct connection_multiplexer_config {
+    std::size_t capacity = 10; //!< maximum number of physical connections
+    time_traits::duration connect_timeout = std::chrono::seconds(10); //!< time limit to establish a physical connection
+    __OZO_STD_OPTIONAL<time_traits::duration> batch_window; //!< time to collect requests into a single flush, zero collects requests of the current reactor tick, no batching if empty
+    std::size_t batch_size = 0; //!< number of collected requests which are flushed before the window ends, 0 means no limit
+};
+
+} // namespace ozo
+
+namespace ozo::impl {
+
+template <typename Source>
+class multiplex_channel;
+
+/**
+ * Connection handle of `ozo::connection_multiplexer`. Requests made via a shared handle are
+ * pipelined with requests of other callers on the same physical connection. An exclusive
+ * handle pins the physical connection, so it may be used for a transaction; the connection
+ * is shared again when the last copy of the exclusive handle is destroyed.
+ */
+template <typename Source>
+struct multiplexed_connection {
+    using channel_type = multiplex_channel<Source>;
+
+    std::shared_ptr<channel_type> channel_;
+    std::shared_ptr<const void> pin_;
+
+    bool pinned() const noexcept { return pin_ != nullptr; }
+
+    /**
+     * Provider of an exclusive handle to the same physical connection.
+     */
+    auto exclusive() const;
+};
+
+template <typename Source>
+struct is_multiplexed_connection<multiplexed_connection<Source>> : std::true_type {};
+
+/**
+ * Request queued to a multiplexed connection. All the member functions are called
+ * within the channel strand.
+ */
+template <typename Source>
+struct multiplexed_request {
+    using connection_type = ozo::connection_type<Source>;
+    using result_type = std::decay_t<decltype(get_result(std::declval<connection_type&>()))>;
+
+    bool done = false;
+
+    virtual ~multiplexed_request() = default;
+    virtual void start() = 0;
+    virtual bool send(connection_type& conn) = 0;
+    virtual void complete(error_code ec) = 0;
+    virtual void complete(result_type result) = 0;
+};
+
+/**
+ * Type-erased handler waiting for a connection of the channel. All the member functions
+ * are called within the channel strand.
+ */
+template <typename Source>
+struct multiplexed_waiter {
+    bool done = false;
+    bool exclusive = false;
+
+    virtual ~multiplexed_waiter() = default;
+    virtual void operator() (error_code ec, multiplexed_connection<Source> conn) = 0;
+};
+
+template <typename Source, typename Handler>
+struct multiplexed_waiter_impl : multiplexed_waiter<Source> {
+    Handler handler_;
+    asio::steady_timer timer_;
+
+    template <typename Executor>
+    multiplexed_waiter_impl(Handler handler, bool exclusive, const Executor& ex)
+    : handler_(std::move(handler)), timer_(ex) {
+        this->exclusive = exclusive;
+    }
+
+    void operator() (error_code ec, multiplexed_connection<Source> conn) override {
+        if (std::exchange(this->done, true)) {
+            return;
+        }
+        error_code _;
+        timer_.cancel(_);
+        auto ex = conn.channel_->get_executor();
+        asio::post(ex, detail::bind(std::move(handler_), std::move(ec), std::move(conn)));
+    }
+};
+
+/**
+ * Single physical connection shared by many requests. Requests are sent in libpq
+ * pipeline mode as soon as they arrive, each one followed by a synchronization point,
+ * so a failed request does not affect the others. Results are read in order and
+ * dispatched to the requests' handlers. With a batch window requests are collected
+ * and sent with a single flush when the window ends or the batch size is reached.
+ */
+template <typename Source>
+class multiplex_channel : public std::enable_shared_from_this<multiplex_channel<Source>> {
+public:
+    using connection_type = ozo::connection_type<Source>;
+    using handle_type = multiplexed_connection<Source>;
+    using request_ptr = std::shared_ptr<multiplexed_request<Source>>;
+    using waiter_ptr = std::shared_ptr<multiplexed_waiter<Source>>;
+    using result_type = typename multiplexed_request<Source>::result_type;
+    using executor_type = detail::strand<io_context::executor_type>;
+
+    static_assert(PipelineSupported<connection_type>,
+        "connection multiplexing requires libpq pipeline mode support");
+
+    multiplex_channel(io_context& io, std::shared_ptr<Source> source, const connection_multiplexer_config& config)
+    : io_(io), strand_(detail::make_strand_executor(io.get_executor())),
+      source_(std::move(source)), connect_timeout_(config.connect_timeout),
+      batch_window_(config.batch_window), batch_size_(config.batch_size), batch_timer_(strand_) {}
+
+    executor_type get_executor() const noexcept { return strand_; }
+
+    connection_type& connection() noexcept { return *conn_; }
+
+    bool connected() const noexcept { return conn_.has_value(); }
+
+    /**
+     * Number of requests queued or in flight, used to balance the load.
+     */
+    std::size_t load() const noexcept { return load_.load(std::memory_order_relaxed); }
+
+    /**
+     * Indicates the channel is pinned or will be pinned, so it should get no new requests.
+     */
+    bool reserved() const noexcept { return reserved_.load(std::memory_order_relaxed) != 0; }
+
+    /**
+     * Indicates the channel collects requests into a batch which is not flushed yet.
+     */
+    bool batch_open() const noexcept { return batch_pending_.load(std::memory_order_relaxed); }
+
+    /**
+     * Provides a shared handle when the connection is established. The handler is called
+     * with `boost::asio::error::operation_aborted` if the time constraint expires first.
+     */
+    template <typename TimeConstraint, typename Handler>
+    void async_acquire(TimeConstraint t, Handler&& handler) {
+        post(waiter(t, false, std::forward<Handler>(handler)), [] (auto& self, waiter_ptr w) {
+            if (w->done) {
+                return;
+            }
+            if (self.state_ == state::ready) {
+                return (*w)(error_code{}, self.handle());
+            }
+            self.connect_waiters_.push_back(std::move(w));
+            self.connect();
+        });
+    }
+
+    /**
+     * Provides an exclusive handle when the requests sent via the connection are completed.
+     * The handler is called with `boost::asio::error::operation_aborted` if the time constraint
+     * expires first.
+     */
+    template <typename TimeConstraint, typename Handler>
+    void async_pin(TimeConstraint t, Handler&& handler) {
+        reserved_.fetch_add(1, std::memory_order_relaxed);
+        post(waiter(t, true, std::forward<Handler>(handler)), [] (auto& self, waiter_ptr w) {
+            if (w->done) {
+                return;
+            }
+            self.pin_waiters_.push_back(std::move(w));
+            self.pump();
+        });
+    }
+
+    void enqueue(request_ptr request) {
+        load_.fetch_add(1, std::memory_order_relaxed);
+        post(std::move(request), [] (auto& self, request_ptr r) {
+            r->start();
+            self.queue_.push_back(std::move(r));
+            self.pump();
+        });
+    }
+
+private:
+    enum class state {disconnected, connecting, ready};
+
+    struct pin_guard {
+        std::shared_ptr<multiplex_channel> channel;
+
+        explicit pin_guard(std::shared_ptr<multiplex_channel> channel) : channel(std::move(channel)) {}
+
+        pin_guard(const pin_guard&) = delete;
+        pin_guard& operator =(const pin_guard&) = delete;
+
+        ~pin_guard() {
+            channel->post(0, [] (auto& self, int) { self.unpin(); });
+        }
+    };
+
+    template <typename TimeConstraint, typename Handler>
+    waiter_ptr waiter(TimeConstraint t, bool exclusive, Handler&& handler) {
+        using waiter_type = multiplexed_waiter_impl<Source, std::decay_t<Handler>>;
+        auto retval = std::make_shared<waiter_type>(std::forward<Handler>(handler), exclusive, strand_);
+        if constexpr (std::is_same_v<TimeConstraint, time_traits::time_point>) {
+            retval->timer_.expires_at(t);
+            retval->timer_.async_wait(asio::bind_executor(strand_,
+                [self = this->shared_from_this(), w = std::weak_ptr<waiter_type>(retval)] (error_code ec) {
+                    if (ec != asio::error::operation_aborted) {
+                        if (auto waiter = w.lock()) {
+                            self->expire(std::move(waiter));
+                        }
+                    }
+                }));
+        }
+        return retval;
+    }
+
+    void expire(waiter_ptr w) {
+        if (w->done) {
+            return;
+        }
+        const auto erase = [&] (std::deque<waiter_ptr>& waiters) {
+            waiters.erase(std::remove(waiters.begin(), waiters.end(), w), waiters.end());
+        };
+        erase(connect_waiters_);
+        erase(pin_waiters_);
+        if (w->exclusive) {
+            reserved_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        (*w)(asio::error::operation_aborted, handle());
+    }
+
+    template <typename T, typename Operation>
+    void post(T&& arg, Operation op) {
+        asio::dispatch(strand_, [self = this->shared_from_this(), arg = std::forward<T>(arg), op] () mutable {
+            op(*self, std::move(arg));
+        });
+    }
+
+    template <typename Operation>
+    auto bind(Operation op) {
+        return asio::bind_executor(strand_,
+            [self = this->shared_from_this(), generation = generation_, op] (error_code ec, auto&&...) {
+                if (generation == self->generation_) {
+                    op(*self, ec);
+                }
+            });
+    }
+
+    handle_type handle(std::shared_ptr<const void> pin = nullptr) {
+        return handle_type {this->shared_from_this(), std::move(pin)};
+    }
+
+    void connect() {
+        if (state_ != state::disconnected) {
+            return;
+        }
+        state_ = state::connecting;
+        (*source_)(io_, connect_timeout_, asio::bind_executor(strand_,
+            [self = this->shared_from_this()] (error_code ec, connection_type conn) {
+                self->on_connect(std::move(ec), std::move(conn));
+            }));
+    }
+
+    void on_connect(error_code ec, connection_type conn) {
+        if (!ec) {
+            ec = set_nonblocking(conn);
+        }
+        if (ec) {
+            state_ = state::disconnected;
+            return fail_all(ec);
+        }
+        conn_.emplace(std::move(conn));
+        state_ = state::ready;
+        pipeline_mode_ = false;
+        for (auto& w : std::exchange(connect_waiters_, {})) {
+            (*w)(error_code{}, handle());
+        }
+        pump();
+    }
+
+    void pump() {
+        if (state_ != state::ready) {
+            if (!queue_.empty() || !pin_waiters_.empty()) {
+                connect();
+            }
+            return;
+        }
+        if (pinned_) {
+            return;
+        }
+        if (!queue_.empty()) {
+            return batch();
+        }
+        while (!pin_waiters_.empty() && pin_waiters_.front()->done) {
+            pin_waiters_.pop_front();
+        }
+        if (in_flight_.empty() && !writing_ && !pin_waiters_.empty()) {
+            pin();
+        }
+    }
+
+    void batch() {
+        if (!batch_window_ || (batch_size_ != 0 && queue_.size() >= batch_size_)) {
+            if (batch_pending_.exchange(false, std::memory_order_relaxed)) {
+                error_code _;
+                batch_timer_.cancel(_);
+            }
+            return send();
+        }
+        if (batch_pending_.exchange(true, std::memory_order_relaxed)) {
+            return;
+        }
+        if (*batch_window_ == time_traits::duration::zero()) {
+            return asio::post(strand_, [self = this->shared_from_this()] {
+                self->on_batch_window_end(error_code{});
+            });
+        }
+        batch_timer_.expires_after(*batch_window_);
+        batch_timer_.async_wait(bind([] (auto& self, auto ec) { self.on_batch_window_end(ec); }));
+    }
+
+    void on_batch_window_end(error_code ec) {
+        if (ec == asio::error::operation_aborted || !batch_pending_.exchange(false, std::memory_order_relaxed)) {
+            return;
+        }
+        if (state_ == state::ready && !pinned_ && !queue_.empty()) {
+            send();
+        }
+    }
+
+    void send() {
+        if (!pipeline_mode_) {
+            if (auto ec = enter_pipeline_mode(connection())) {
+                return fail(ec);
+            }
+            pipeline_mode_ = true;
+        }
+        while (!queue_.empty()) {
+            auto request = std::move(queue_.front());
+            queue_.pop_front();
+            if (request->done) {
+                load_.fetch_sub(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (!request->send(connection())) {
+                load_.fetch_sub(1, std::memory_order_relaxed);
+                request->complete(error::pg_send_query_params_failed);
+                continue;
+            }
+            in_flight_.push_back(std::move(request));
+            if (auto ec = pipeline_sync(connection())) {
+                return fail(ec);
+            }
+        }
+        flush();
+        read();
+    }
+
+    void flush() {
+        if (writing_) {
+            return;
+        }
+        switch (flush_output(connection())) {
+            case query_state::error:
+                return fail(error::pg_flush_failed);
+            case query_state::send_in_progress:
+                writing_ = true;
+                return write_poll(connection(), bind([] (auto& self, error_code ec) {
+                    self.writing_ = false;
+                    if (ec) {
+                        return self.fail(ec);
+                    }
+                    self.flush();
+                }));
+            case query_state::send_finish:
+                return pump();
+        }
+    }
+
+    void read() {
+        if (reading_) {
+            return;
+        }
+        receive();
+        if (in_flight_.empty()) {
+            return;
+        }
+        reading_ = true;
+        read_poll(connection(), bind([] (auto& self, error_code ec) {
+            self.reading_ = false;
+            if (ec) {
+                return self.fail(ec);
+            }
+            if (auto err = consume_input(self.connection())) {
+                return self.fail(err);
+            }
+            self.read();
+            self.pump();
+        }));
+    }
+
+    // Takes all the results available without blocking. The first result of a request
+    // is kept, the synchronization point completes the request.
+    void receive() {
+        while (!in_flight_.empty() && !is_busy(connection())) {
+            auto res = get_result(connection());
+            if (!res) {
+                continue;
+            }
+            if (result_status(*res) == PGRES_PIPELINE_SYNC) {
+                auto request = std::move(in_flight_.front());
+                in_flight_.pop_front();
+                load_.fetch_sub(1, std::memory_order_relaxed);
+                request->complete(std::exchange(result_, result_type{}));
+                continue;
+            }
+            if (!result_) {
+                result_ = std::move(res);
+            }
+        }
+    }
+
+    void pin() {
+        if (pipeline_mode_) {
+            if (auto ec = exit_pipeline_mode(connection())) {
+                return fail(ec);
+            }
+            pipeline_mode_ = false;
+        }
+        pinned_ = true;
+        auto w = std::move(pin_waiters_.front());
+        pin_waiters_.pop_front();
+        (*w)(error_code{}, handle(std::make_shared<pin_guard>(this->shared_from_this())));
+    }
+
+    void unpin() {
+        pinned_ = false;
+        reserved_.fetch_sub(1, std::memory_order_relaxed);
+        if (conn_ && (connection_bad(connection())
+                || get_transaction_status(connection()) != transaction_status::idle)) {
+            close();
+        }
+        pump();
+    }
+
+    // Completes requests which are sent already since their results are lost
+    // with the connection, queued requests are sent via the next connection.
+    void fail(error_code ec) {
+        for (auto& request : std::exchange(in_flight_, {})) {
+            load_.fetch_sub(1, std::memory_order_relaxed);
+            request->complete(ec);
+        }
+        result_ = result_type{};
+        close();
+        pump();
+    }
+
+    void fail_all(error_code ec) {
+        for (auto& request : std::exchange(queue_, {})) {
+            load_.fetch_sub(1, std::memory_order_relaxed);
+            request->complete(ec);
+        }
+        for (auto& w : std::exchange(connect_waiters_, {})) {
+            (*w)(ec, handle());
+        }
+        for (auto& w : std::exchange(pin_waiters_, {})) {
+            if (!w->done) {
+                reserved_.fetch_sub(1, std::memory_order_relaxed);
+                (*w)(ec, handle());
+            }
+        }
+    }
+
+    void close() {
+        ++generation_;
+        if (conn_) {
+            error_code _;
+            get_socket(connection()).close(_);
+            conn_.reset();
+        }
+        if (batch_pending_.exchange(false, std::memory_order_relaxed)) {
+            error_code _;
+            batch_timer_.cancel(_);
+        }
+        state_ = state::disconnected;
+        pipeline_mode_ = writing_ = reading_ = false;
+    }
+
+    io_context& io_;
+    executor_type strand_;
+    std::shared_ptr<Source> source_;
+    time_traits::duration connect_timeout_;
+    __OZO_STD_OPTIONAL<time_traits::duration> batch_window_;
+    std::size_t batch_size_;
+    asio::steady_timer batch_timer_;
+    std::atomic<bool> batch_pending_ {false};
+    __OZO_STD_OPTIONAL<connection_type> conn_;
+    state state_ = state::disconnected;
+    std::deque<request_ptr> queue_;
+    std::deque<request_ptr> in_flight_;
+    std::deque<waiter_ptr> connect_waiters_;
+    std::deque<waiter_ptr> pin_waiters_;
+    result_type result_ {};
+    std::size_t generation_ = 0;
+    bool pipeline_mode_ = false;
+    bool writing_ = false;
+    bool reading_ = false;
+    bool pinned_ = false;
+    std::atomic<std::size_t> load_ {0};
+    std::atomic<std::size_t> reserved_ {0};
+};
+
+template <typename Source, typename Query, typename TimeConstraint, typename Out, typename Handler>
+class multiplexed_request_impl : public multiplexed_request<Source>,
+        public std::enable_shared_from_this<multiplexed_request_impl<Source, Query, TimeConstraint, Out, Handler>> {
+public:
+    using base = multiplexed_request<Source>;
+    using typename base::connection_type;
+    using typename base::result_type;
+    using handle_type = multiplexed_connection<Source>;
+
+    multiplexed_request_impl(handle_type conn, Query query, TimeConstraint t, Out out, Handler handler)
+    : conn_(std::move(conn)), query_(std::move(query)), time_constraint_(t), out_(std::move(out)), handler_(std::move(handler)),
+      timer_(conn_.channel_->get_executor()) {}
+
+    void start() override {
+        if constexpr (std::is_same_v<TimeConstraint, time_traits::time_point>) {
+            timer_.expires_at(time_constraint_);
+            timer_.async_wait([self = this->shared_from_this()] (error_code ec) {
+                if (ec != asio::error::operation_aborted) {
+                    self->complete(asio::error::operation_aborted);
+                }
+            });
+        }
+    }
+
+    bool send(connection_type& conn) override {
+        if (!binary_query_) {
+            binary_query_.emplace(make_binary_query(query_, get_oid_map(conn),
+                asio::get_associated_allocator(handler_)));
+        }
+        return send_query_params(conn, *binary_query_);
+    }
+
+    void complete(result_type res) override {
+        if (!res) {
+            return complete(error_code{});
+        }
+        switch (result_status(*res)) {
+            case PGRES_SINGLE_TUPLE:
+            case PGRES_TUPLES_OK:
+                return process(std::move(res));
+            case PGRES_COMMAND_OK:
+                return complete(error_code{});
+            case PGRES_BAD_RESPONSE:
+                return complete(error::result_status_bad_response);
+            case PGRES_EMPTY_QUERY:
+                return complete(error::result_status_empty_query);
+            case PGRES_FATAL_ERROR:
+                return complete(result_error(*res));
+        }
+        complete(error::result_status_unexpected);
+    }
+
+    void complete(error_code ec) override {
+        if (std::exchange(this->done, true)) {
+            return;
+        }
+        error_code _;
+        timer_.cancel(_);
+        if (conn_.channel_->connected()) {
+            collect_statistics(conn_, event::query{stopwatch_.elapsed(), ec, trace::query_name(query_)});
+        }
+        auto ex = conn_.channel_->get_executor();
+        asio::post(ex, detail::bind(std::move(handler_), std::move(ec), std::move(conn_)));
+    }
+
+private:
+    void process(result_type res) {
+        if (this->done) {
+            return;
+        }
+        try {
+            out_(std::move(res), conn_);
+        } catch (const std::exception& e) {
+            set_error_context(conn_, e.what());
+            return complete(error::bad_result_process);
+        }
+        complete(error_code{});
+    }
+
+    handle_type conn_;
+    Query query_;
+    __OZO_STD_OPTIONAL<std::decay_t<decltype(make_binary_query(std::declval<const Query&>(),
+        get_oid_map(std::declval<connection_type&>()),
+        asio::get_associated_allocator(std::declval<Handler&>())))>> binary_query_;
+    TimeConstraint time_constraint_;
+    Out out_;
+    Handler handler_;
+    asio::steady_timer timer_;
+    detail::stopwatch<ConnectionStatisticsEnabled<connection_type>> stopwatch_;
+};
+
+template <typename Source, typename Query, typename TimeConstraint, typename Out, typename Handler>
+inline void async_multiplexed_request(multiplexed_connection<Source> conn, Query&& query,
+        TimeConstraint t, Out&& out, Handler&& handler) {
+    using request = multiplexed_request_impl<Source, std::decay_t<Query>, TimeConstraint,
+        std::decay_t<Out>, std::decay_t<Handler>>;
+    auto channel = conn.channel_;
+    auto allocator = asio::get_associated_allocator(handler);
+    channel->enqueue(std::allocate_shared<request>(allocator, std::move(conn),
+        std::forward<Query>(query), t, std::forward<Out>(out), std::forward<Handler>(handler)));
+}
+
+/**
+ * Provider of the exclusive handle to the physical connection of a multiplexed connection.
+ */
+template <typename Source>
+struct exclusive_multiplexed_connection_provider {
+    using connection_type = multiplexed_connection<Source>;
+
+    connection_type conn_;
+
+    template <typename TimeConstraint, typename Handler>
+    void async_get_connection(TimeConstraint t, Handler&& handler) const {
+        if (conn_.pinned()) {
+            auto ex = conn_.channel_->get_executor();
+            return asio::dispatch(ex, detail::bind(std::forward<Handler>(handler), error_code{}, conn_));
+        }
+        conn_.channel_->async_pin(t, std::forward<Handler>(handler));
+    }
+};
+
+template <typename Source>
+inline auto multiplexed_connection<Source>::exclusive() const {
+    return exclusive_multiplexed_connection_provider<Source> {*this};
+}
+
+/**
+ * Shared state of `ozo::connection_multiplexer` copies.
+ */
+template <typename Source>
+class multiplexer_state {
+public:
+    using channel_type = multiplex_channel<Source>;
+    using channel_ptr = std::shared_ptr<channel_type>;
+
+    multiplexer_state(Source source, io_context& io, const connection_multiplexer_config& config)
+    : source_(std::make_shared<Source>(std::move(source))), io_(io), config_(config) {
+        channels_.reserve(config_.capacity);
+    }
+
+    /**
+     * Chooses the least loaded channel which is not reserved for a transaction, a new
+     * channel is opened while the capacity allows if all the channels are busy. Balancing
+     * by load spreads requests across the channels, so with a batch window a channel which
+     * collects a batch is preferred, otherwise batches would rarely form.
+     */
+    channel_ptr select() {
+        const std::lock_guard lock(mutex_);
+        channel_ptr retval;
+        std::size_t load = 0;
+        if (config_.batch_window) {
+            for (const auto& channel : channels_) {
+                if (!channel->reserved() && channel->batch_open() && (!retval || channel->load() < load)) {
+                    retval = channel;
+                    load = channel->load();
+                }
+            }
+            if (retval) {
+                return retval;
+            }
+        }
+        for (const auto& channel : channels_) {
+            if (!channel->reserved() && (!retval || channel->load() < load)) {
+                retval = channel;
+                load = channel->load();
+            }
+        }
+        if ((!retval || load != 0) && channels_.size() < std::max<std::size_t>(config_.capacity, 1)) {
+            retval = channels_.emplace_back(
+                std::make_shared<channel_type>(io_, source_, config_));
+        }
+        if (!retval) {
+            retval = *std::min_element(channels_.begin(), channels_.end(),
+                [] (const auto& lhs, const auto& rhs) { return lhs->load() < rhs->load(); });
+        }
+        return retval;
+    }
+
+    std::size_t size() const {
+        const std::lock_guard lock(mutex_);
+        return channels_.size();
+    }
+
+private:
+    std::shared_ptr<Source> source_;
+    io_context& io_;
+    const connection_multiplexer_config config_;
+    mutable std::mutex mutex_;
+    std::vector<channel_ptr> channels_;
+};
+
+} // namespace ozo::impl
+
+namespace ozo {
+
+template <typename Source>
+struct unwrap_impl<impl::multiplexed_connection<Source>> {
+    template <typename Conn>
+    static constexpr decltype(auto) apply(Conn&& conn) noexcept {
+        return unwrap(conn.channel_->connection());
+    }
+};
+
+template <typename Source>
+struct is_nullable<impl::multiplexed_connection<Source>> : std::true_type {};
+
+template <typename Source>
+struct is_null_impl<impl::multiplexed_connection<Source>> {
+    static bool apply(const impl::multiplexed_connection<Source>& conn) {
+        return !conn.channel_ || !conn.channel_->connected() || is_null(conn.channel_->connection());
+    }
+};
+
+} // namespace ozo
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <ozo/impl/io.h>
+
+namespace ozo::impl {
+
+namespace pq {
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+template <typename T>
+inline auto pq_enter_pipeline_mode(T& conn) noexcept
+        -> decltype(PQenterPipelineMode(get_native_handle(conn))) {
+    return PQenterPipelineMode(get_native_handle(conn));
+}
+
+template <typename T>
+inline auto pq_exit_pipeline_mode(T& conn) noexcept
+        -> decltype(PQexitPipelineMode(get_native_handle(conn))) {
+    return PQexitPipelineMode(get_native_handle(conn));
+}
+
+template <typename T>
+inline auto pq_pipeline_sync(T& conn) noexcept
+        -> decltype(PQpipelineSync(get_native_handle(conn))) {
+    return PQpipelineSync(get_native_handle(conn));
+}
+
+#endif
+
+template <typename T, typename = std::void_t<>>
+struct has_pipeline_mode : std::false_type {};
+
+template <typename T>
+struct has_pipeline_mode<T, std::void_t<
+    decltype(pq_enter_pipeline_mode(std::declval<T&>())),
+    decltype(pq_exit_pipeline_mode(std::declval<T&>())),
+    decltype(pq_pipeline_sync(std::declval<T&>()))
+>> : std::true_type {};
+
+} // namespace pq
+
+/**
+ * Indicates if the connection supports libpq pipeline mode, i.e. several
+ * queries may be sent before their results are received.
+ */
+#ifdef LIBPQ_HAS_PIPELINING
+template <typename T>
+constexpr bool PipelineSupported = pq::has_pipeline_mode<
+    std::decay_t<decltype(unwrap_connection(std::declval<T&>()))>>::value;
+#else
+template <typename T>
+constexpr bool PipelineSupported = false;
+#endif
+
+template <typename T>
+inline error_code enter_pipeline_mode(T& conn) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    using pq::pq_enter_pipeline_mode;
+    if (!pq_enter_pipeline_mode(unwrap_connection(conn))) {
+        return error::pg_pipeline_mode_failed;
+    }
+    return {};
+}
+
+template <typename T>
+inline error_code exit_pipeline_mode(T& conn) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    using pq::pq_exit_pipeline_mode;
+    if (!pq_exit_pipeline_mode(unwrap_connection(conn))) {
+        return error::pg_pipeline_mode_failed;
+    }
+    return {};
+}
+
+template <typename T>
+inline error_code pipeline_sync(T& conn) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    using pq::pq_pipeline_sync;
+    if (!pq_pipeline_sync(unwrap_connection(conn))) {
+        return error::pg_pipeline_mode_failed;
+    }
+    return {};
+}
+
+/**
+ * Statements without parameters which are sent in the same pipeline before
+ * and after a request query, e.g. deferred BEGIN and COMMIT of a transaction.
+ */
+struct deferred_statements {
+    const char* prologue = nullptr;
+    const char* epilogue = nullptr;
+
+    explicit operator bool () const noexcept {
+        return prologue != nullptr || epilogue != nullptr;
+    }
+};
+
+/**
+ * Gives statements the connection wants to be pipelined with the next request.
+ * Connections have none by default, see `ozo::impl::transaction`.
+ */
+template <typename T>
+constexpr deferred_statements get_deferred_statements(const T&) noexcept {
+    return {};
+}
+
+/**
+ * Drops the deferred statements of the connection once they have been sent,
+ * so they are kept for the next request if sending fails.
+ */
+template <typename T>
+constexpr void take_deferred_statements(T&) noexcept {}
+
+/**
+ * Notifies the connection that the deferred statements taken before
+ * have been executed successfully.
+ */
+template <typename T>
+constexpr void complete_deferred_statements(T&, const deferred_statements&) noexcept {}
+
+} // namespace ozo::impl
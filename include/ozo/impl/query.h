@@ -14,6 +14,11 @@ struct query {
     hana::tuple<ParamsT ...> params;
 };
 
+template <class Name, class Text, class ... ParamsT>
+struct named_query : query<Text, ParamsT ...> {
+    static constexpr Name name {};
+};
+
 } // namespace ozo::impl
 
 namespace ozo {
@@ -31,6 +36,12 @@ struct get_query_params_impl<impl::query<Ts...>> {
     }
 };
 
+template <class Name, class ...Ts>
+struct get_query_text_impl<impl::named_query<Name, Ts...>> : get_query_text_impl<impl::query<Ts...>> {};
+
+template <class Name, class ...Ts>
+struct get_query_params_impl<impl::named_query<Name, Ts...>> : get_query_params_impl<impl::query<Ts...>> {};
+
 template <class Text, class ...ParamsT>
 inline constexpr auto make_query(Text&& text, ParamsT&& ...params) {
     static_assert(QueryText<Text>, "text must be QueryText concept");
@@ -38,4 +49,12 @@ inline constexpr auto make_query(Text&& text, ParamsT&& ...params) {
     return query {std::forward<Text>(text), hana::make_tuple(std::forward<ParamsT>(params)...)};
 }
 
+namespace impl {
+
+template <class Name, class Text, class ...ParamsT>
+inline constexpr auto make_named_query(Name, query<Text, ParamsT...> q) {
+    return named_query<Name, Text, ParamsT...> {std::move(q)};
+}
+
+} // namespace impl
 } // namespace ozo
@@ -60,9 +60,11 @@ struct request_oid_map_op {
 
     template <typename Connection>
     void perform(Connection&& conn) {
-        const auto oid_map = get_oid_map(conn);
+        auto query = make_oids_query(get_oid_map(conn));
         auto ctx = make_request_operation_context(std::forward<Connection>(conn), *this);
-        async_send_query_params(ctx, make_oids_query(oid_map));
+        ctx->query_name = trace::query_name(query);
+        ctx->trace = trace::request<>(ctx->query_name);
+        async_send_query_params(ctx, std::move(query));
         async_get_result(std::move(ctx), async_request_out_handler{std::back_inserter(*res_)});
     }
 
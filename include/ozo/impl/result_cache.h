@@ -0,0 +1,236 @@
+#pragma once
+
+#include <ozo/impl/single_flight.h>
+#include <ozo/impl/listen.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+
+namespace ozo {
+
+/**
+ * @brief Client-side result cache configuration
+ *
+ * Entries are evicted when they expire or, least recently used first, when a shard
+ * exceeds its part of the memory budget. The memory of an entry is estimated as the
+ * size of its key plus the size of the `PGresult`.
+ */
+struct result_cache_config {
+    std::chrono::steady_clock::duration ttl = std::chrono::seconds(60); //!< time to live of an entry
+    std::size_t memory_budget = 64 * 1024 * 1024; //!< upper bound of the cache memory in bytes
+    std::size_t shards = 16; //!< number of independently locked shards
+};
+
+} // namespace ozo
+
+namespace ozo::impl {
+
+/**
+ * Part of the cache with its own lock and LRU order.
+ */
+class result_cache_shard {
+public:
+    using clock = std::chrono::steady_clock;
+
+    __OZO_STD_OPTIONAL<shared_result> find(const std::string& key, clock::time_point now) {
+        const std::lock_guard lock(mutex_);
+        const auto i = entries_.find(key);
+        if (i == entries_.end()) {
+            return {};
+        }
+        if (i->second.expires <= now) {
+            erase(i);
+            return {};
+        }
+        lru_.splice(lru_.begin(), lru_, i->second.lru);
+        return i->second.result;
+    }
+
+    void insert(const std::string& key, const shared_result& result, std::size_t size,
+            clock::time_point expires, std::size_t budget) {
+        const std::lock_guard lock(mutex_);
+        if (const auto i = entries_.find(key); i != entries_.end()) {
+            if (i->second.result.handle() == result.handle()) {
+                return;
+            }
+            erase(i);
+        }
+        if (size > budget) {
+            return;
+        }
+        while (memory_ + size > budget) {
+            erase(entries_.find(lru_.back()));
+        }
+        lru_.push_front(key);
+        entries_.emplace(key, entry {result, size, expires, lru_.begin()});
+        memory_ += size;
+    }
+
+    void clear() {
+        const std::lock_guard lock(mutex_);
+        entries_.clear();
+        lru_.clear();
+        memory_ = 0;
+    }
+
+    std::size_t size() const {
+        const std::lock_guard lock(mutex_);
+        return entries_.size();
+    }
+
+    std::size_t memory() const {
+        const std::lock_guard lock(mutex_);
+        return memory_;
+    }
+
+private:
+    struct entry {
+        shared_result result;
+        std::size_t size;
+        clock::time_point expires;
+        std::list<std::string>::iterator lru;
+    };
+
+    using entries_type = std::unordered_map<std::string, entry>;
+
+    void erase(entries_type::iterator i) {
+        memory_ -= i->second.size;
+        lru_.erase(i->second.lru);
+        entries_.erase(i);
+    }
+
+    mutable std::mutex mutex_;
+    entries_type entries_;
+    std::list<std::string> lru_;
+    std::size_t memory_ = 0;
+};
+
+/**
+ * Shared state of `ozo::result_cache` copies. Concurrent misses of the same request
+ * are coalesced, a result is not stored if the cache has been invalidated while it
+ * was requested.
+ */
+class result_cache_state {
+public:
+    using clock = result_cache_shard::clock;
+
+    explicit result_cache_state(const result_cache_config& config)
+    : config_(config),
+      shards_count_(std::max<std::size_t>(config.shards, 1)),
+      shards_(std::make_unique<result_cache_shard[]>(shards_count_)),
+      flights_(std::make_shared<single_flight_state>()) {}
+
+    __OZO_STD_OPTIONAL<shared_result> find(const std::string& key) {
+        return shard(key).find(key, clock::now());
+    }
+
+    void insert(const std::string& key, const shared_result& result, std::uint64_t generation) {
+        if (!result.handle() || generation != generation_.load(std::memory_order_acquire)) {
+            return;
+        }
+        const auto size = key.size() + result_memory_size(*result.handle());
+        shard(key).insert(key, result, size, clock::now() + config_.ttl, config_.memory_budget / shards_count_);
+    }
+
+    void invalidate() {
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+        for (std::size_t i = 0; i < shards_count_; ++i) {
+            shards_[i].clear();
+        }
+    }
+
+    std::uint64_t generation() const noexcept {
+        return generation_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Key of the coalesced request for the cache key. Requests started after an invalidation
+     * are not coalesced with the ones started before it, so the result of a request is stored
+     * only if it has been requested after the last invalidation.
+     */
+    static std::string flight_key(const std::string& key, std::uint64_t generation) {
+        std::string retval(key);
+        retval.append(reinterpret_cast<const char*>(std::addressof(generation)), sizeof(generation));
+        return retval;
+    }
+
+    const std::shared_ptr<single_flight_state>& flights() const noexcept { return flights_; }
+
+    std::size_t size() const {
+        std::size_t retval = 0;
+        for (std::size_t i = 0; i < shards_count_; ++i) {
+            retval += shards_[i].size();
+        }
+        return retval;
+    }
+
+    std::size_t memory() const {
+        std::size_t retval = 0;
+        for (std::size_t i = 0; i < shards_count_; ++i) {
+            retval += shards_[i].memory();
+        }
+        return retval;
+    }
+
+private:
+    result_cache_shard& shard(const std::string& key) {
+        return shards_[std::hash<std::string>{}(key) % shards_count_];
+    }
+
+    const result_cache_config config_;
+    const std::size_t shards_count_;
+    std::unique_ptr<result_cache_shard[]> shards_;
+    std::shared_ptr<single_flight_state> flights_;
+    std::atomic<std::uint64_t> generation_ {0};
+};
+
+template <typename P, typename Q, typename TimeConstraint, typename Handler>
+inline void async_cached_request(const std::shared_ptr<result_cache_state>& state, P&& provider,
+        Q&& query, TimeConstraint t, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    auto executor = asio::get_associated_executor(handler, get_provider_executor(provider));
+    auto request = make_keyed_request<P>(std::forward<Q>(query));
+    if (auto result = state->find(request.key)) {
+        return asio::post(executor, detail::bind(std::forward<Handler>(handler), error_code{}, std::move(*result)));
+    }
+    const auto generation = state->generation();
+    auto flight_key = result_cache_state::flight_key(request.key, generation);
+    auto on_complete = asio::bind_executor(executor,
+        [state, key = std::move(request.key), generation, handler = std::forward<Handler>(handler)]
+                (error_code ec, shared_result result) mutable {
+            if (!ec) {
+                state->insert(key, result, generation);
+            }
+            handler(std::move(ec), std::move(result));
+        });
+    async_single_flight_request(state->flights(), std::move(flight_key), std::forward<P>(provider),
+        std::move(request.query), t, std::move(on_complete));
+}
+
+template <typename P, typename TimeConstraint, typename Handler>
+inline void async_invalidate_on_notify(const std::shared_ptr<result_cache_state>& state, P&& provider,
+        std::vector<std::string> channels, TimeConstraint t, Handler&& handler) {
+    std::weak_ptr<result_cache_state> cache = state;
+    auto executor = asio::get_associated_executor(handler);
+    auto on_notify = [cache] (const notification&) {
+        if (auto state = cache.lock()) {
+            state->invalidate();
+            return true;
+        }
+        return false;
+    };
+    auto on_complete = [cache, handler = std::forward<Handler>(handler)] (error_code ec, auto conn) mutable {
+        // Notifications are not received any more, so cached results may become stale.
+        if (auto state = cache.lock()) {
+            state->invalidate();
+        }
+        handler(std::move(ec), std::move(conn));
+    };
+    async_listen(std::forward<P>(provider), std::move(channels), std::move(on_notify), t,
+        asio::bind_executor(executor, std::move(on_complete)));
+}
+
+} // namespace ozo::impl
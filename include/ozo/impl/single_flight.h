@@ -0,0 +1,228 @@
+#pragma once
+
+#include <ozo/impl/async_request.h>
+#include <ozo/detail/bind.h>
+#include <ozo/result.h>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ozo::impl {
+
+/**
+ * Identity of a request for coalescing and caching: the query text followed by the type,
+ * length and binary representation of each parameter.
+ */
+template <typename ...Ts>
+inline std::string make_request_key(const binary_query<Ts...>& query) {
+    using query_type = binary_query<Ts...>;
+    std::string retval(query.text());
+    retval.push_back('\0');
+    for (std::size_t i = 0; i < query_type::params_count; ++i) {
+        const auto type = query.types()[i];
+        const auto length = query.lengths()[i];
+        retval.append(reinterpret_cast<const char*>(std::addressof(type)), sizeof(type));
+        retval.append(reinterpret_cast<const char*>(std::addressof(length)), sizeof(length));
+        if (length > 0) {
+            retval.append(query.values()[i], static_cast<std::size_t>(length));
+        }
+    }
+    return retval;
+}
+
+/**
+ * Type-erased handler waiting for a coalesced request.
+ */
+struct single_flight_waiter {
+    virtual ~single_flight_waiter() = default;
+    virtual void operator() (error_code ec, shared_result result) = 0;
+};
+
+/**
+ * Shared state of `ozo::single_flight` copies: handlers waiting for each request in flight.
+ */
+class single_flight_state {
+public:
+    using waiter_ptr = std::shared_ptr<single_flight_waiter>;
+
+    /**
+     * Adds the waiter for the request, returns true if no such request is in flight
+     * so the caller should make it.
+     */
+    bool join(const std::string& key, waiter_ptr waiter) {
+        const std::lock_guard lock(mutex_);
+        const auto [i, inserted] = requests_.try_emplace(key);
+        i->second.push_back(std::move(waiter));
+        return inserted;
+    }
+
+    /**
+     * Removes the waiter of the request, e.g. on its own time constraint expiration.
+     * Returns false if the waiter is not waiting any more, so it is completed already.
+     * The request stays in flight for the other waiters.
+     */
+    bool leave(const std::string& key, const waiter_ptr& waiter) {
+        const std::lock_guard lock(mutex_);
+        const auto i = requests_.find(key);
+        if (i == requests_.end()) {
+            return false;
+        }
+        auto& waiters = i->second;
+        const auto w = std::find(waiters.begin(), waiters.end(), waiter);
+        if (w == waiters.end()) {
+            return false;
+        }
+        waiters.erase(w);
+        return true;
+    }
+
+    /**
+     * Completes all the waiters of the request with the same result.
+     */
+    void complete(const std::string& key, error_code ec, const shared_result& result) {
+        std::vector<waiter_ptr> waiters;
+        {
+            const std::lock_guard lock(mutex_);
+            const auto i = requests_.find(key);
+            if (i == requests_.end()) {
+                return;
+            }
+            waiters = std::move(i->second);
+            requests_.erase(i);
+        }
+        for (auto& waiter : waiters) {
+            (*waiter)(ec, result);
+        }
+    }
+
+    std::size_t size() const {
+        const std::lock_guard lock(mutex_);
+        return requests_.size();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::vector<waiter_ptr>> requests_;
+};
+
+/**
+ * Waiter which completes the handler on the executor associated with the handler,
+ * which defaults to the executor of the connection provider.
+ */
+template <typename Handler, typename Executor>
+struct single_flight_waiter_impl : single_flight_waiter,
+        std::enable_shared_from_this<single_flight_waiter_impl<Handler, Executor>> {
+    Handler handler_;
+    Executor executor_;
+    __OZO_STD_OPTIONAL<asio::steady_timer> timer_;
+
+    single_flight_waiter_impl(Handler handler, const Executor& executor)
+    : handler_(std::move(handler)), executor_(executor) {}
+
+    /**
+     * Makes the waiter leave the request with `boost::asio::error::operation_aborted` at
+     * the deadline. The timer runs on the waiter executor.
+     */
+    void expires_at(time_traits::time_point t, std::weak_ptr<single_flight_state> state, std::string key) {
+        timer_.emplace(executor_);
+        timer_->expires_at(t);
+        timer_->async_wait([state = std::move(state), key = std::move(key), w = this->weak_from_this()] (error_code ec) {
+            if (ec == asio::error::operation_aborted) {
+                return;
+            }
+            const auto self = w.lock();
+            const auto flights = state.lock();
+            if (self && flights && flights->leave(key, self)) {
+                (*self)(asio::error::operation_aborted, shared_result{});
+            }
+        });
+    }
+
+    void operator() (error_code ec, shared_result result) override {
+        if (!timer_) {
+            return asio::post(executor_, detail::bind(std::move(handler_), std::move(ec), std::move(result)));
+        }
+        // The timer is cancelled on its executor, not on the thread completing the request.
+        asio::post(executor_, [self = this->shared_from_this(), ec, result = std::move(result)] () mutable {
+            error_code _;
+            self->timer_->cancel(_);
+            std::move(self->handler_)(std::move(ec), std::move(result));
+        });
+    }
+};
+
+template <typename Handler, typename Executor>
+inline auto make_single_flight_waiter(Handler&& handler, const Executor& executor) {
+    return std::make_shared<single_flight_waiter_impl<std::decay_t<Handler>, Executor>>(
+        std::forward<Handler>(handler), executor);
+}
+
+/**
+ * Key of the request along with the query to make the request with.
+ */
+template <typename Query>
+struct keyed_request {
+    std::string key;
+    Query query;
+};
+
+/**
+ * Encodes the query to make the request key. The key is made without a connection, so OIDs
+ * of custom types are not known yet, which does not matter for the identity of the request.
+ * If the connections of the provider have no custom types, i.e. use `ozo::empty_oid_map`,
+ * the encoding does not depend on a connection, so the encoded query is reused for the request
+ * and the parameters are encoded once. Otherwise the query is encoded again with the OID map
+ * of the connection.
+ */
+template <typename P, typename Q>
+inline auto make_keyed_request(Q&& query) {
+    using oid_map_type = std::decay_t<decltype(get_oid_map(std::declval<connection_type<P>&>()))>;
+    auto binary = make_binary_query(query, oid_map_type{}, std::allocator<char>{});
+    auto key = make_request_key(binary);
+    if constexpr (std::is_same_v<oid_map_type, empty_oid_map>) {
+        using query_type = encoded_query<std::decay_t<Q>, decltype(binary)>;
+        return keyed_request<query_type> {std::move(key), query_type {std::move(binary)}};
+    } else {
+        return keyed_request<std::decay_t<Q>> {std::move(key), std::forward<Q>(query)};
+    }
+}
+
+template <typename P, typename Q, typename TimeConstraint, typename Handler>
+inline void async_single_flight_request(const std::shared_ptr<single_flight_state>& state, std::string key,
+        P&& provider, Q&& query, TimeConstraint t, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    auto executor = asio::get_associated_executor(handler, get_provider_executor(provider));
+
+    auto waiter = make_single_flight_waiter(std::forward<Handler>(handler), executor);
+    if constexpr (!std::is_same_v<TimeConstraint, none_t>) {
+        waiter->expires_at(deadline(t), state, key);
+    }
+    if (!state->join(key, std::move(waiter))) {
+        return;
+    }
+
+    auto out = std::make_shared<result>();
+    auto on_complete = asio::bind_executor(executor,
+        [state, key = std::move(key), out] (error_code ec, auto&&) {
+            state->complete(key, ec, shared_result(std::shared_ptr<PGresult>(std::move(out->handle()))));
+        });
+    async_request(std::forward<P>(provider), std::forward<Q>(query), t, std::ref(*out), std::move(on_complete));
+}
+
+template <typename P, typename Q, typename TimeConstraint, typename Handler>
+inline void async_single_flight_request(const std::shared_ptr<single_flight_state>& state, P&& provider,
+        Q&& query, TimeConstraint t, Handler&& handler) {
+    auto request = make_keyed_request<P>(std::forward<Q>(query));
+    async_single_flight_request(state, std::move(request.key), std::forward<P>(provider), std::move(request.query),
+        t, std::forward<Handler>(handler));
+}
+
+} // namespace ozo::impl
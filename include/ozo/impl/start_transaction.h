@@ -22,4 +22,22 @@ auto start_transaction(T&& provider, Query&& query,
     return init.result.get();
 }
 
+template <typename T, typename TimeConstrain,
+        typename CompletionToken, typename = Require<ConnectionProvider<T>>>
+auto start_deferred_transaction(T&& provider, const char* statement,
+        TimeConstrain t, CompletionToken&& token) {
+    using signature = void (error_code, transaction<connection_type<T>>);
+
+    async_completion<CompletionToken, signature> init(token);
+
+    async_start_deferred_transaction(
+        std::forward<T>(provider),
+        statement,
+        t,
+        init.completion_handler
+    );
+
+    return init.result.get();
+}
+
 } // namespace ozo::impl
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ozo/connection.h>
+#include <ozo/impl/pipeline.h>
 
 namespace ozo::impl {
 
@@ -37,9 +38,55 @@ public:
         return has_connection();
     }
 
+    /**
+     * Defers the statement which starts the transaction until the first
+     * request, so it is pipelined with the request query.
+     */
+    void defer_begin(const char* statement) noexcept {
+        impl->begin = statement;
+    }
+
+    /**
+     * Makes the COMMIT pipelined behind the query of the next request.
+     */
+    void defer_commit() noexcept {
+        impl->commit = true;
+    }
+
+    /**
+     * Indicates that the transaction needs no round trip to be finished: nothing has been
+     * executed since the deferred BEGIN or the deferred COMMIT has been already executed.
+     */
+    bool is_finished() const noexcept {
+        return impl != nullptr && (impl->begin != nullptr || impl->committed);
+    }
+
+    deferred_statements get_deferred_statements() const noexcept {
+        if (impl == nullptr) {
+            return {};
+        }
+        return {impl->begin, impl->commit ? "COMMIT" : nullptr};
+    }
+
+    void take_deferred_statements() noexcept {
+        if (impl != nullptr) {
+            impl->begin = nullptr;
+            impl->commit = false;
+        }
+    }
+
+    void complete_deferred_statements(const deferred_statements& statements) noexcept {
+        if (impl != nullptr && statements.epilogue != nullptr) {
+            impl->committed = true;
+        }
+    }
+
 private:
     struct impl_type {
         __OZO_STD_OPTIONAL<T> connection;
+        const char* begin = nullptr;
+        bool commit = false;
+        bool committed = false;
 
         impl_type(T&& connection) : connection(std::move(connection)) {}
 
@@ -56,6 +103,22 @@ auto make_transaction(T&& conn) {
     return transaction<std::decay_t<T>> {std::forward<T>(conn)};
 }
 
+template <typename T>
+inline deferred_statements get_deferred_statements(const transaction<T>& transaction) noexcept {
+    return transaction.get_deferred_statements();
+}
+
+template <typename T>
+inline void take_deferred_statements(transaction<T>& transaction) noexcept {
+    transaction.take_deferred_statements();
+}
+
+template <typename T>
+inline void complete_deferred_statements(transaction<T>& transaction,
+        const deferred_statements& statements) noexcept {
+    transaction.complete_deferred_statements(statements);
+}
+
 } // namespace ozo::impl
 
 namespace ozo {
@@ -5,6 +5,7 @@
 #include <ozo/io/send.h>
 #include <ozo/io/array.h>
 #include <ozo/io/composite.h>
+#include <ozo/io/param_ref.h>
 #include <ozo/core/concept.h>
 #include <ozo/query.h>
 #include <ozo/type_traits.h>
@@ -23,6 +24,72 @@
 
 namespace ozo {
 
+namespace detail {
+
+/**
+ * Parameters metadata known at compile time. Types of all the parameters are known if
+ * all of them are #BuiltIn, lengths are known if all of them are #StaticSize and not #Nullable.
+ */
+template <class Params, class = std::make_index_sequence<decltype(hana::length(std::declval<Params>()))::value>>
+struct binary_query_params_meta;
+
+template <class Params, std::size_t ... I>
+struct binary_query_params_meta<Params, std::index_sequence<I...>> {
+    template <std::size_t i>
+    using param_type = std::decay_t<decltype(hana::at_c<i>(std::declval<const Params&>()))>;
+
+    template <class T>
+    static constexpr bool static_length = !Nullable<T> && StaticSize<T>;
+
+    template <class T>
+    static constexpr oid_t type() noexcept {
+        if constexpr (BuiltIn<T>) {
+            return typename type_traits<T>::oid();
+        } else {
+            return null_oid;
+        }
+    }
+
+    template <class T>
+    static constexpr int length() noexcept {
+        if constexpr (static_length<T>) {
+            return typename type_traits<T>::size();
+        } else {
+            return 0;
+        }
+    }
+
+    static constexpr bool static_types = (true && ... && BuiltIn<param_type<I>>);
+    static constexpr bool static_lengths = (true && ... && static_length<param_type<I>>);
+
+    static constexpr std::array<oid_t, sizeof...(I)> types {{type<param_type<I>>()...}};
+    static constexpr std::array<int, sizeof...(I)> formats {{(void(I), 1)...}};
+    static constexpr std::array<int, sizeof...(I)> lengths {{length<param_type<I>>()...}};
+    static constexpr std::size_t buffer_size = (std::size_t(0) + ... + static_cast<std::size_t>(length<param_type<I>>()));
+
+    static constexpr std::array<std::size_t, sizeof...(I)> make_offsets() noexcept {
+        std::array<std::size_t, sizeof...(I)> retval {};
+        std::size_t offset = 0;
+        for (std::size_t i = 0; i < retval.size(); ++i) {
+            retval[i] = offset;
+            offset += static_cast<std::size_t>(lengths[i]);
+        }
+        return retval;
+    }
+
+    static constexpr std::array<std::size_t, sizeof...(I)> offsets = make_offsets();
+};
+
+} // namespace detail
+
+/**
+ * Query with parameters in the binary format, i.e. the arguments of `PQsendQueryParams`.
+ * Formats and, when the parameter types allow, types and lengths of the parameters are
+ * static arrays computed at compile time, so only the values and the variable lengths are
+ * written for a query. Values of parameters which lengths are all static are written into
+ * a fixed size buffer which is a part of the query object. Values of `ozo::param_ref`
+ * parameters are not copied, they point to the referenced data.
+ */
 template <class Text, class Params, class OidMap, class Allocator = std::allocator<char>>
 class binary_query {
 public:
@@ -54,15 +121,23 @@ public:
     }
 
     constexpr const oid_t* types() const noexcept {
-        return std::data(impl->types);
+        if constexpr (meta::static_types) {
+            return std::data(meta::types);
+        } else {
+            return std::data(impl->types);
+        }
     }
 
     constexpr const int* formats() const noexcept {
-        return std::data(impl->formats);
+        return std::data(meta::formats);
     }
 
     constexpr const int* lengths() const noexcept {
-        return std::data(impl->lengths);
+        if constexpr (meta::static_lengths) {
+            return std::data(meta::lengths);
+        } else {
+            return std::data(impl->lengths);
+        }
     }
 
     constexpr const char* const* values() const noexcept {
@@ -70,20 +145,29 @@ public:
     }
 
 private:
-    static constexpr auto binary_format = 1;
+    using meta = detail::binary_query_params_meta<params_type>;
 
-    using buffer_type = std::vector<char, allocator_type>;
+    using buffer_type = std::conditional_t<meta::static_lengths,
+        std::array<char, meta::buffer_size>,
+        std::vector<char, allocator_type>>;
 
     struct impl_type {
         text_type text;
         buffer_type buffer;
-        std::array<oid_t, params_count> types;
-        std::array<int, params_count> formats;
-        std::array<int, params_count> lengths;
+        std::array<oid_t, meta::static_types ? 0 : params_count> types;
+        std::array<int, meta::static_lengths ? 0 : params_count> lengths;
         std::array<const char*, params_count> values;
 
-        impl_type(text_type text, const allocator_type& allocator)
-            : text(std::move(text)), buffer(allocator) {}
+        impl_type(text_type text, [[maybe_unused]] const allocator_type& allocator)
+            : text(std::move(text)), buffer(make_buffer(allocator)) {}
+
+        static buffer_type make_buffer([[maybe_unused]] const allocator_type& allocator) {
+            if constexpr (meta::static_lengths) {
+                return {};
+            } else {
+                return buffer_type(allocator);
+            }
+        }
 
         impl_type(const impl_type&) = delete;
         impl_type(impl_type&&) = delete;
@@ -98,10 +182,6 @@ private:
             result.types[field] = value;
         }
 
-        constexpr void set_format(int value) noexcept {
-            result.formats[field] = value;
-        }
-
         constexpr void set_length(int value) noexcept {
             result.lengths[field] = value;
         }
@@ -122,38 +202,57 @@ private:
 
         auto result = std::make_shared<impl_type>(std::move(text), allocator);
 
-        ozo::detail::ostreambuf osbuf(result->buffer);
-        ozo::ostream os(&osbuf);
-
         const auto range = hana::to<hana::tuple_tag>(
             hana::make_range(hana::size_c<0>, hana::size_c<params_count>));
 
-        hana::for_each(range, [&] (auto field) {
-            write_meta(oid_map, params[field], field_proxy<field>(*result, os));
-        });
-
-        std::size_t offset = 0;
-        hana::for_each(range, [&] (auto field) {
-                const auto size = result->lengths[field];
-                if (size && size != null_state_size) {
-                    result->values[field] = std::data(result->buffer) + offset;
-                    offset += size;
-                } else {
-                    result->values[field] = nullptr;
+        if constexpr (meta::static_lengths) {
+            ozo::detail::fixed_ostreambuf osbuf(std::data(result->buffer), std::size(result->buffer));
+            ozo::ostream os(&osbuf);
+            hana::for_each(range, [&] (auto field) {
+                write_meta(oid_map, params[field], field_proxy<field>(*result, os));
+                result->values[field] = std::data(result->buffer) + meta::offsets[field];
+            });
+        } else {
+            ozo::detail::ostreambuf osbuf(result->buffer);
+            ozo::ostream os(&osbuf);
+
+            hana::for_each(range, [&] (auto field) {
+                write_meta(oid_map, params[field], field_proxy<field>(*result, os));
+            });
+
+            std::size_t offset = 0;
+            hana::for_each(range, [&] (auto field) {
+                    const auto size = result->lengths[field];
+                    if constexpr (ParamRef<decltype(params[field])>) {
+                        result->values[field] = std::data(detail::param_ref_data(params[field]));
+                    } else if (size && size != null_state_size) {
+                        result->values[field] = std::data(result->buffer) + offset;
+                        offset += size;
+                    } else {
+                        result->values[field] = nullptr;
+                    }
                 }
-            }
-        );
+            );
+        }
         return result;
     }
 
     template <class T, std::size_t field>
     static void write_meta(const oid_map_type& oid_map, const T& value, field_proxy<field> result) {
         using ozo::send;
-        using ozo::size_of;
-        result.set_type(type_oid(oid_map, value));
-        result.set_format(binary_format);
-        send(result.stream(), oid_map, value);
-        result.set_length(size_of(value));
+        if constexpr (!meta::static_types) {
+            result.set_type(type_oid(oid_map, value));
+        }
+        if constexpr (ParamRef<T>) {
+            result.set_length(static_cast<int>(std::size(detail::param_ref_data(value))));
+        } else if constexpr (meta::static_lengths) {
+            send(result.stream(), oid_map, value);
+        } else {
+            const auto begin = result.stream().tellp();
+            send(result.stream(), oid_map, value);
+            result.set_length(is_null(value) ? null_state_size
+                : static_cast<int>(result.stream().tellp() - begin));
+        }
     }
 };
 
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <ozo/core/concept.h>
+#include <ozo/core/strong_typedef.h>
+#include <ozo/core/unwrap.h>
+#include <ozo/type_traits.h>
+
+#include <memory>
+#include <string_view>
+
+namespace ozo {
+
+/**
+ * @brief Query parameter which refers to caller-owned data
+ * @ingroup group-io-types
+ *
+ * The value of the parameter is not copied into the query parameters buffer, the query
+ * points to the data of the referenced object, so large text or binary data does not double
+ * memory consumption and is not copied. The referenced object must stay alive and unchanged
+ * until the request is completed. The parameter is sent in the binary format as is, that is
+ * why only #DynamicSize types which binary representation is their raw data are allowed:
+ * `std::string`, `std::string_view`, `ozo::pg::bytea`, `ozo::pg::text` and so on.
+ *
+ * Within arrays and composites the parameter is serialized as the referenced object.
+ *
+ * @tparam T --- type of the referenced object
+ * @sa ozo::ref()
+ */
+template <typename T>
+class param_ref {
+public:
+    static_assert(!Nullable<T> && !Array<T> && !Composite<T> && DynamicSize<T>,
+        "T should be a dynamic size type which is sent as raw data");
+
+    constexpr explicit param_ref(const T& v) noexcept : v_(std::addressof(v)) {}
+
+    constexpr const T& get() const noexcept { return *v_; }
+
+private:
+    const T* v_;
+};
+
+template <typename T>
+struct is_param_ref : std::false_type {};
+
+template <typename T>
+struct is_param_ref<param_ref<T>> : std::true_type {};
+
+/**
+ * @brief Indicates if type is `ozo::param_ref`
+ * @ingroup group-io-types
+ * @hideinitializer
+ */
+template <typename T>
+constexpr auto ParamRef = is_param_ref<std::decay_t<T>>::value;
+
+template <typename T>
+struct unwrap_impl<param_ref<T>> {
+    template <typename Ref>
+    constexpr static decltype(auto) apply(Ref&& v) noexcept {
+        return v.get();
+    }
+};
+
+/**
+ * @brief Passes the object as a query parameter by reference
+ * @ingroup group-io-functions
+ *
+ * @param v --- object to refer to, it must outlive the request.
+ * @return `ozo::param_ref` to the object.
+ *
+ * ### Example
+ *
+ * @code
+const ozo::pg::bytea document = load_document();
+ozo::request(conn_info[io], "INSERT INTO documents VALUES("_SQL + ozo::ref(document) + ")"_SQL,
+    std::chrono::seconds(1), ozo::into(result), yield);
+ * @endcode
+ */
+template <typename T>
+constexpr param_ref<T> ref(const T& v) noexcept {
+    return param_ref<T>(v);
+}
+
+template <typename T>
+void ref(const T&&) = delete;
+
+namespace detail {
+
+template <typename T>
+inline std::string_view param_ref_data(const param_ref<T>& v) noexcept {
+    const auto& value = v.get();
+    if constexpr (StrongTypedef<T>) {
+        static_assert(RawDataReadable<typename T::base_type>, "T should be sent as raw data");
+        return std::string_view(std::data(value.get()), std::size(value.get()));
+    } else {
+        static_assert(RawDataReadable<T>, "T should be sent as raw data");
+        return std::string_view(std::data(value), std::size(value));
+    }
+}
+
+} // namespace detail
+} // namespace ozo
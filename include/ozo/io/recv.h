@@ -14,6 +14,8 @@
 #include <boost/hana/members.hpp>
 #include <boost/hana/size.hpp>
 
+#include <string_view>
+
 namespace ozo {
 template <int... I>
 constexpr std::tuple<boost::mpl::int_<I>...>
@@ -118,6 +120,44 @@ struct recv_impl {
 
 namespace detail {
 
+/**
+ * Returns view of the next size bytes of the data the stream reads, the view
+ * refers to the data and is valid as long as the data, e.g. the result, exists.
+ */
+inline std::string_view read_view(istream& in, size_type size) {
+    const auto view = in.view();
+    if (!view) {
+        throw std::invalid_argument("a view can be received from a result value only");
+    }
+    const auto data = view->take(static_cast<std::size_t>(size));
+    if (!data) {
+        throw system_error(error::unexpected_eof);
+    }
+    return std::string_view(data, static_cast<std::size_t>(size));
+}
+
+} // namespace detail
+
+/**
+ * @brief Receives `std::string_view` which refers to the result data.
+ * @ingroup group-io-types
+ *
+ * The text is not copied, the view points into the result value, so it is
+ * valid as long as the result exists. Use `ozo::borrowed_rows` to keep the
+ * result together with the rows which refer to it; receiving such rows into
+ * any other container is rejected at compile time, see `ozo::is_borrowed_view`.
+ */
+template <>
+struct recv_impl<std::string_view> {
+    template <typename M>
+    static istream& apply(istream& in, size_type size, const oid_map_t<M>&, std::string_view& out) {
+        out = detail::read_view(in, size);
+        return in;
+    }
+};
+
+namespace detail {
+
 template <typename T, typename = std::void_t<>>
 struct recv_impl_dispatcher { using type = recv_impl<std::decay_t<T>>; };
 
@@ -325,9 +365,43 @@ recv_row(const row<T>& in, const oid_map_t<M>& oid_map, Out& out) {
     });
 }
 
+namespace detail {
+
+template <typename T>
+constexpr bool has_borrowed_views();
+
+template <typename T, std::size_t ...I>
+constexpr bool fusion_has_borrowed_views(std::index_sequence<I...>) {
+    return (false || ... || has_borrowed_views<typename fusion::result_of::value_at_c<T, I>::type>());
+}
+
+template <typename ...Ts>
+constexpr bool hana_has_borrowed_views(hana::basic_type<hana::tuple<Ts...>>) {
+    return (false || ... || has_borrowed_views<Ts>());
+}
+
+template <typename T>
+constexpr bool has_borrowed_views() {
+    using type = std::decay_t<T>;
+    if constexpr (is_borrowed_view<type>::value) {
+        return true;
+    } else if constexpr (Nullable<type>) {
+        return has_borrowed_views<unwrap_type<type>>();
+    } else if constexpr (Array<type>) {
+        return has_borrowed_views<typename type::value_type>();
+    } else if constexpr (HanaStruct<type>) {
+        return hana_has_borrowed_views(hana::type_c<decltype(hana::members(std::declval<type>()))>);
+    } else if constexpr (FusionSequence<type> || FusionAdaptedStruct<type>) {
+        return fusion_has_borrowed_views<type>(
+            std::make_index_sequence<fusion::result_of::size<type>::value>{});
+    } else {
+        return false;
+    }
+}
+
 template <typename T, typename M, typename Out>
 Require<ForwardIterator<Out>, Out>
-recv_result(const basic_result<T>& in, const oid_map_t<M>& oid_map, Out out) {
+recv_rows(const basic_result<T>& in, const oid_map_t<M>& oid_map, Out out) {
     for (auto row : in) {
         recv_row(row, oid_map, *out++);
     }
@@ -336,7 +410,7 @@ recv_result(const basic_result<T>& in, const oid_map_t<M>& oid_map, Out out) {
 
 template <typename T, typename M, typename Out>
 Require<InsertIterator<Out>, Out>
-recv_result(const basic_result<T>& in, const oid_map_t<M>& oid_map, Out out) {
+recv_rows(const basic_result<T>& in, const oid_map_t<M>& oid_map, Out out) {
     for (auto row : in) {
         typename Out::container_type::value_type v{};
         recv_row(row, oid_map, v);
@@ -345,6 +419,24 @@ recv_result(const basic_result<T>& in, const oid_map_t<M>& oid_map, Out out) {
     return out;
 }
 
+} // namespace detail
+
+template <typename T, typename M, typename Out>
+Require<ForwardIterator<Out>, Out>
+recv_result(const basic_result<T>& in, const oid_map_t<M>& oid_map, Out out) {
+    static_assert(!detail::has_borrowed_views<decltype(*out)>(),
+        "rows refer to the result data, receive them into ozo::borrowed_rows or ozo::basic_typed_result");
+    return detail::recv_rows(in, oid_map, std::move(out));
+}
+
+template <typename T, typename M, typename Out>
+Require<InsertIterator<Out>, Out>
+recv_result(const basic_result<T>& in, const oid_map_t<M>& oid_map, Out out) {
+    static_assert(!detail::has_borrowed_views<typename Out::container_type::value_type>(),
+        "rows refer to the result data, receive them into ozo::borrowed_rows or ozo::basic_typed_result");
+    return detail::recv_rows(in, oid_map, std::move(out));
+}
+
 template <typename T, typename M>
 basic_result<T>& recv_result(basic_result<T>& in, const oid_map_t<M>&, basic_result<T>& out) {
     out = std::move(in);
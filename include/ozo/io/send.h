@@ -100,7 +100,8 @@ inline ostream& send(ostream& out, const oid_map_t<M>& oid_map, const In& in) {
  *
  * This function is used to write into stream object's data frame. E.g. it is used
  * for array items serialization. Data frame contains object's size and object's data.
- * See `ozo::data_frame_size()` for more details about data frame.
+ * See `ozo::data_frame_size()` for more details about data frame. The size of an object
+ * of #DynamicSize type is written after its data, if the stream supports positioning.
  *
  * @param out --- output stream
  * @param oid_map --- #OidMap to determine object's oid
@@ -109,8 +110,29 @@ inline ostream& send(ostream& out, const oid_map_t<M>& oid_map, const In& in) {
  */
 template <class M, class In>
 inline ostream& send_data_frame(ostream& out, const oid_map_t<M>& oid_map, const In& in) {
-    write(out, size_of(in));
-    return send(out, oid_map, in);
+    if constexpr (StaticSize<In>) {
+        write(out, size_of(in));
+        return send(out, oid_map, in);
+    } else {
+        if (is_null(in)) {
+            return write(out, size_type(null_state_size));
+        }
+        // The size of the data is written after the data itself, so nested arrays and
+        // composites are serialized in a single pass instead of calculating size_of for
+        // every level of nesting. Streams without positioning support fall back to size_of.
+        const auto begin = out.tellp();
+        if (begin == ostream::pos_type(ostream::off_type(-1))) {
+            write(out, size_of(in));
+            return send(out, oid_map, in);
+        }
+        write(out, size_type(0));
+        send(out, oid_map, in);
+        const auto end = out.tellp();
+        out.seekp(begin);
+        write(out, static_cast<size_type>(end - begin) - size_type(sizeof(size_type)));
+        out.seekp(end);
+        return out;
+    }
 }
 
 /**
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <ozo/impl/listen.h>
+
+namespace ozo {
+
+/**
+ * @brief Stream of notifications
+ * @ingroup group-requests-types
+ *
+ * Handle to a dedicated connection listening to channels, created by `ozo::listen()`.
+ * Notifications are queued until they are received by `ozo::receive()`. When the connection
+ * is lost `ozo::receive()` provides `ozo::error::notifications_lost` once and the listener gets
+ * a new connection and executes `LISTEN` again after `ozo::listener_config::reconnect_delay`,
+ * so the notifications sent meanwhile are lost, e.g. a consumer should reload the data then.
+ *
+ * Up to `ozo::listener_config::max_queue_size` notifications are queued; on overflow the queued
+ * ones are dropped and `ozo::receive()` provides `ozo::error::notifications_lost` instead of them.
+ *
+ * The listener listens until `close()`. Copies of the listener refer to the same stream.
+ * Receive operations on a listener must not be concurrent: a pending receive operation
+ * completes with `boost::asio::error::operation_aborted` when the next one starts.
+ *
+ * @tparam Provider --- #ConnectionProvider of the listening connection.
+ */
+template <typename Provider>
+class listener {
+public:
+    using connection_type = ozo::connection_type<Provider>;
+
+    explicit listener(std::shared_ptr<impl::listener_state<Provider>> impl)
+    : impl_(std::move(impl)) {}
+
+    /**
+     * Stops listening and closes the connection. The pending and the following receive
+     * operations complete with `boost::asio::error::operation_aborted`.
+     */
+    void close() const {
+        asio::dispatch(impl_->get_executor(), [state = impl_] { state->close(); });
+    }
+
+    std::shared_ptr<impl::listener_state<Provider>> impl_;
+};
+
+/**
+ * @brief Listens to notifications of channels
+ * @ingroup group-requests-functions
+ *
+ * Gets a dedicated connection from the provider, executes `LISTEN` for each channel and waits for
+ * notifications on the connection socket. It replaces polling of tables for changes by an event
+ * driven approach, e.g. with a trigger which executes `NOTIFY` on a data change. Mind that
+ * notifications are delivered on transaction commit only.
+ *
+ * @code
+auto listener = ozo::listen(conn_info[io], {"users_changed"}, io);
+boost::asio::spawn(io, [listener] (auto yield) {
+    for (;;) {
+        ozo::error_code ec;
+        auto notification = ozo::receive(listener, yield[ec]);
+        if (ec == boost::asio::error::operation_aborted) {
+            break;
+        }
+        // reload users on ec == ozo::error::notifications_lost, or the changed one otherwise
+    }
+});
+ * @endcode
+ *
+ * @param provider --- #ConnectionProvider to get a connection from; a shared connection of
+ *        `ozo::connection_multiplexer` can not listen.
+ * @param channels --- names of the channels to listen to.
+ * @param io --- `ozo::io_context` of the listener.
+ * @param config --- `ozo::listener_config` object.
+ * @return `ozo::listener` object.
+ */
+template <typename Provider>
+auto listen(Provider&& provider, std::vector<std::string> channels, io_context& io,
+        const listener_config& config = {}) {
+    static_assert(ConnectionProvider<Provider>, "provider should be a ConnectionProvider");
+    using provider_type = std::decay_t<Provider>;
+    auto state = std::make_shared<impl::listener_state<provider_type>>(
+        std::forward<Provider>(provider), std::move(channels), io, config);
+    asio::dispatch(state->get_executor(), [state] { state->subscribe(); });
+    return listener<provider_type>{std::move(state)};
+}
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Receives the next notification of the listener
+ *
+ * Completes as soon as a notification is received or with the queued one. Completes with
+ * `ozo::error::notifications_lost` after the listening connection has been lost, and with
+ * `boost::asio::error::operation_aborted` when the listener is closed.
+ *
+ * @param listener --- `ozo::listener` object.
+ * @param token --- operation #CompletionToken with `void(ozo::error_code, ozo::notification)` signature.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename Provider, typename CompletionToken>
+decltype(auto) receive(const listener<Provider>& listener, CompletionToken&& token);
+#else
+struct receive_op {
+    template <typename Provider, typename CompletionToken>
+    decltype(auto) operator() (const listener<Provider>& listener, CompletionToken&& token) const {
+        using signature_t = void (error_code, notification);
+        async_completion<CompletionToken, signature_t> init(token);
+
+        asio::dispatch(listener.impl_->get_executor(),
+            [state = listener.impl_, handler = std::move(init.completion_handler)] () mutable {
+                state->receive(std::move(handler));
+            });
+
+        return init.result.get();
+    }
+};
+
+constexpr receive_op receive;
+#endif
+
+} // namespace ozo
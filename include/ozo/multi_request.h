@@ -0,0 +1,85 @@
+#pragma once
+
+#include <ozo/impl/async_multi_request.h>
+
+namespace ozo {
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Requests several result sets from a database in one round trip
+ *
+ * The function sends all the queries at once and fills one output per query result set,
+ * e.g. a header and its detail rows. The queries are sent in a single libpq pipeline with
+ * one synchronization point, so like statements of a multi-statement query they are executed
+ * in an implicit transaction unless they are requested via a transaction: the first error
+ * aborts the rest of the queries and is provided to the completion handler. Outputs of the
+ * queries which produce no rows are left untouched.
+ *
+ * If the connection does not support pipeline mode, or is shared via `ozo::connection_multiplexer`
+ * which pipelines requests itself, the queries are requested one by one on the same connection.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- #ConnectionProvider to get connection from.
+ * @param queries --- `boost::hana::tuple` of #Query or `ozo::query_builder` objects.
+ * @param time_constraint --- request #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+ * @param outs --- `boost::hana::tuple` of outputs like Iterator, #InsertIterator or `ozo::result`, one per query.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ *
+ * ###Example
+ *
+ * @code
+ozo::rows_of<std::int64_t, std::string> header;
+ozo::rows_of<std::int64_t, std::int64_t> items;
+ozo::multi_request(conn_info[io],
+    hana::make_tuple("SELECT id, name FROM orders WHERE id = "_SQL + id,
+                     "SELECT item, amount FROM order_items WHERE order_id = "_SQL + id),
+    500ms,
+    hana::make_tuple(ozo::into(header), ozo::into(items)),
+    yield);
+ * @endcode
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename Queries, typename TimeConstraint, typename Outs, typename CompletionToken>
+decltype(auto) multi_request(ConnectionProvider&& provider, Queries&& queries, TimeConstraint time_constraint,
+        Outs outs, CompletionToken&& token);
+
+/**
+ * @brief Requests several result sets from a database in one round trip
+ *
+ * This function is time constrain free shortcut to `ozo::multi_request()` function.
+ * Its call is equal to `ozo::multi_request(provider, queries, ozo::none, outs, token)` call.
+ *
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename Queries, typename Outs, typename CompletionToken>
+decltype(auto) multi_request(ConnectionProvider&& provider, Queries&& queries, Outs outs, CompletionToken&& token);
+#else
+
+struct multi_request_op {
+    template <typename P, typename Q, typename TimeConstraint, typename Outs, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Q&& queries, TimeConstraint t,
+            Outs outs, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        using signature_t = void (error_code, connection_type<P>);
+        async_completion<CompletionToken, signature_t> init(token);
+
+        impl::async_multi_request(std::forward<P>(provider), std::forward<Q>(queries),
+                t, std::move(outs), init.completion_handler);
+
+        return init.result.get();
+    }
+
+    template <typename P, typename Q, typename Outs, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Q&& queries, Outs outs, CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), std::forward<Q>(queries), none, std::move(outs),
+            std::forward<CompletionToken>(token));
+    }
+};
+
+constexpr multi_request_op multi_request;
+
+#endif
+
+} // namespace ozo
@@ -5,6 +5,7 @@
 #include <ozo/io/recv.h>
 
 #include <string>
+#include <string_view>
 
 namespace ozo::pg {
 
@@ -31,10 +32,36 @@ private:
     std::string value;
 };
 
+/**
+ * jsonb which refers to the data instead of owning it, e.g. received from a result
+ * it points into the result and is valid as long as the result exists.
+ */
+class jsonb_view {
+    friend send_impl<jsonb_view>;
+    friend recv_impl<jsonb_view>;
+    friend size_of_impl<jsonb_view>;
+
+public:
+    constexpr jsonb_view() = default;
+
+    constexpr jsonb_view(std::string_view raw_string) noexcept
+        : value(raw_string) {}
+
+    constexpr std::string_view raw_string() const noexcept {
+        return value;
+    }
+
+private:
+    std::string_view value;
+};
+
 } // namespace ozo::pg
 
 namespace ozo {
 
+template <>
+struct is_borrowed_view<pg::jsonb_view> : std::true_type {};
+
 template <>
 struct size_of_impl<pg::jsonb> {
     static auto apply(const pg::jsonb& v) noexcept {
@@ -66,6 +93,38 @@ struct recv_impl<pg::jsonb> {
     }
 };
 
+template <>
+struct size_of_impl<pg::jsonb_view> {
+    static auto apply(const pg::jsonb_view& v) noexcept {
+        return std::size(v.value) + 1;
+    }
+};
+
+template <>
+struct send_impl<pg::jsonb_view> {
+    template <typename M>
+    static ostream& apply(ostream& out, const oid_map_t<M>&, const pg::jsonb_view& in) {
+        const std::int8_t version = 1;
+        write(out, version);
+        return write(out, in.value);
+    }
+};
+
+template <>
+struct recv_impl<pg::jsonb_view> {
+    template <typename M>
+    static istream& apply(istream& in, size_type size, const oid_map_t<M>&, pg::jsonb_view& out) {
+        if (size < 1) {
+            throw std::range_error("data size " + std::to_string(size) + " is too small to read jsonb");
+        }
+        std::int8_t version;
+        read(in, version);
+        out.value = detail::read_view(in, size - 1);
+        return in;
+    }
+};
+
 } // namespace ozo
 
 OZO_PG_DEFINE_TYPE_AND_ARRAY(ozo::pg::jsonb, "jsonb", JSONBOID, 3807, dynamic_size)
+OZO_PG_DEFINE_TYPE_AND_ARRAY(ozo::pg::jsonb_view, "jsonb", JSONBOID, 3807, dynamic_size)
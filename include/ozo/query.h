@@ -4,6 +4,8 @@
 #include <ozo/core/concept.h>
 #include <ozo/type_traits.h>
 
+#include <string_view>
+
 /**
  * @defgroup group-query Queries
  * @brief Database queries related concepts, types and functions.
@@ -292,6 +294,44 @@ decltype(auto) get_params(const T& query) {
     return get_query_params(query);
 }
 
+template <class QueryT>
+constexpr auto get_raw_query_name(const QueryT&) noexcept {
+    return QueryT::name;
+}
+
+template <class QueryT>
+constexpr auto get_raw_query_name() noexcept {
+    return decltype(get_raw_query_name(std::declval<QueryT>())) {};
+}
+
+template <class QueryT>
+constexpr std::string_view get_query_name(const QueryT& query) noexcept {
+    return hana::to<const char*>(get_raw_query_name(query));
+}
+
+template <class QueryT>
+constexpr std::string_view get_query_name() noexcept {
+    return hana::to<const char*>(get_raw_query_name<QueryT>());
+}
+
+template <class, class = std::void_t<>>
+struct is_named_query : std::false_type {};
+
+template <class T>
+struct is_named_query<T, std::void_t<decltype(T::name)>>
+    : std::bool_constant<HanaString<decltype(T::name)>> {};
+
+/**
+ * @brief Indicates if the query type has a compile-time name
+ *
+ * Query types declared for `ozo::query_repository` and queries made by
+ * `ozo::query_repository::make_query()` have a `name` static member which
+ * is a `boost::hana::string`, so `ozo::get_query_name()` is applicable to them.
+ * @ingroup group-query-concepts
+ */
+template <class T>
+constexpr auto NamedQuery = is_named_query<std::decay_t<T>>::value;
+
 } // namespace ozo
 
 #include <ozo/impl/query.h>
@@ -26,26 +26,6 @@
 
 namespace ozo {
 
-template <class QueryT>
-constexpr auto get_raw_query_name(const QueryT&) noexcept {
-    return QueryT::name;
-}
-
-template <class QueryT>
-constexpr auto get_raw_query_name() noexcept {
-    return decltype(get_raw_query_name(std::declval<QueryT>())) {};
-}
-
-template <class QueryT>
-constexpr std::string_view get_query_name(const QueryT& query) noexcept {
-    return hana::to<const char*>(get_raw_query_name(query));
-}
-
-template <class QueryT>
-constexpr std::string_view get_query_name() noexcept {
-    return hana::to<const char*>(get_raw_query_name<QueryT>());
-}
-
 namespace detail {
 
 namespace x3 = boost::spirit::x3;
@@ -436,9 +416,20 @@ public:
         return is_initialized();
     }
 
+    /**
+     * Makes a query declared as `QueryT` with the parameters given.
+     *
+     * @note The result type is `ozo::impl::named_query<Name, Text, Params...>`, not
+     * `ozo::impl::query<Text, Params...>` as before, so `ozo::get_query_name()` and tracers
+     * can get the query name. `named_query` is derived from `query`, so the result still
+     * converts to the old type, but the name is lost then. Code which names the old type
+     * exactly (e.g. `std::is_same_v` checks or specializations for `impl::query`) has to
+     * be updated. `ozo::get_query_name()` is now declared in `<ozo/query.h>`, which this
+     * header includes.
+     */
     template <class QueryT>
     auto make_query() const {
-        return ozo::make_query(get_description<QueryT>());
+        return make_named_query<QueryT>(get_description<QueryT>());
     }
 
     template <class QueryT, class ... ParametersT,
@@ -457,11 +448,11 @@ public:
         if constexpr (detail::HasMembers<typename QueryT::parameters_type>) {
             return hana::unpack(
                 hana::members(parameters),
-                [&] (const auto& ... parameters) { return ozo::make_query(description, parameters ...); }
+                [&] (const auto& ... parameters) { return make_named_query<QueryT>(description, parameters ...); }
             );
         } else {
             return std::apply(
-                [&] (const auto& ... parameters) { return ozo::make_query(description, parameters ...); },
+                [&] (const auto& ... parameters) { return make_named_query<QueryT>(description, parameters ...); },
                 parameters
             );
         }
@@ -473,11 +464,11 @@ public:
         if constexpr (detail::HasMembers<typename QueryT::parameters_type>) {
             return hana::unpack(
                 hana::members(std::move(parameters)),
-                [&] (auto&& ... parameters) { return ozo::make_query(description, std::move(parameters) ...); }
+                [&] (auto&& ... parameters) { return make_named_query<QueryT>(description, std::move(parameters) ...); }
             );
         } else {
             return std::apply(
-                [&] (auto&& ... parameters) { return ozo::make_query(description, std::move(parameters) ...); },
+                [&] (auto&& ... parameters) { return make_named_query<QueryT>(description, std::move(parameters) ...); },
                 std::move(parameters)
             );
         }
@@ -486,6 +477,12 @@ public:
 private:
     std::shared_ptr<detail::query_conf> query_conf;
 
+    template <class QueryT, class ... ParametersT>
+    static auto make_named_query(std::string_view description, ParametersT&& ... parameters) {
+        return impl::make_named_query(get_raw_query_name<QueryT>(),
+            ozo::make_query(description, std::forward<ParametersT>(parameters) ...));
+    }
+
     template <class QueryT>
     decltype(auto) get_description() const {
         return query_conf->queries.at(get_query_name(std::get<QueryT>(std::tuple<QueriesT ...>())));
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <ozo/statistics.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Plain copy of a query statistics
+ * @ingroup group-statistics
+ *
+ * Snapshots can be aggregated with `operator +=`. All durations are in
+ * `ozo::time_traits::duration` ticks.
+ */
+struct query_statistics_snapshot {
+    using histogram = detail::histogram_snapshot<>;
+
+    std::uint64_t queries = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t rows = 0;
+    std::uint64_t bytes = 0; //!< result values size
+    histogram query_time;
+    histogram decode_time;
+
+    query_statistics_snapshot& operator +=(const query_statistics_snapshot& rhs) {
+        queries += rhs.queries;
+        errors += rhs.errors;
+        rows += rhs.rows;
+        bytes += rhs.bytes;
+        query_time += rhs.query_time;
+        decode_time += rhs.decode_time;
+        return *this;
+    }
+};
+
+inline query_statistics_snapshot operator +(query_statistics_snapshot lhs, const query_statistics_snapshot& rhs) {
+    return lhs += rhs;
+}
+
+/**
+ * @brief Per query name statistics registry
+ * @ingroup group-statistics
+ *
+ * Statistics type which aggregates request latency, rows and result size by the query name
+ * (see `ozo::get_query_name()`), requests with unnamed queries are accounted under the empty name.
+ * Each thread records into its own shard, so the recording does not contend with other
+ * threads; shards are merged on `snapshot()`. Copies of the object share the registry, so
+ * it may be used as a #ConnectionSource statistics prototype directly or with other statistics
+ * via `boost::hana::map`.
+ *
+ * @code
+ozo::query_statistics by_query;
+auto source = ozo::make_connection_info(conn_str, ozo::empty_oid_map{}, by_query);
+// ...
+for (const auto& [name, stats] : by_query.snapshot()) {
+    std::cout << name << " p99=" << stats.query_time.percentile(99) << " rows=" << stats.rows << '\n';
+}
+ * @endcode
+ */
+class query_statistics {
+public:
+    using snapshot_type = std::map<std::string, query_statistics_snapshot, std::less<>>;
+
+    query_statistics() : registry_(std::make_shared<registry>()) {}
+
+    void collect(const event::query& e) noexcept {
+        if (const auto entry = local_entry(e.query)) {
+            entry->queries.fetch_add(1, std::memory_order_relaxed);
+            if (e.error) {
+                entry->errors.fetch_add(1, std::memory_order_relaxed);
+            }
+            entry->query_time.record(ticks(e.duration));
+        }
+    }
+
+    void collect(const event::decode& e) noexcept {
+        if (const auto entry = local_entry(e.query)) {
+            entry->rows.fetch_add(e.rows, std::memory_order_relaxed);
+            entry->bytes.fetch_add(e.bytes, std::memory_order_relaxed);
+            entry->decode_time.record(ticks(e.duration));
+        }
+    }
+
+    template <typename Event>
+    void collect(const Event&) noexcept {}
+
+    /**
+     * Statistics of all the queries merged over all the threads.
+     */
+    snapshot_type snapshot() const {
+        snapshot_type retval;
+        for_each_entry([&] (const entry& e) { retval[e.name] += e.snapshot(); });
+        return retval;
+    }
+
+    /**
+     * Statistics of the query with the given name merged over all the threads.
+     */
+    query_statistics_snapshot snapshot(std::string_view name) const {
+        query_statistics_snapshot retval;
+        for_each_entry([&] (const entry& e) {
+            if (e.name == name) {
+                retval += e.snapshot();
+            }
+        });
+        return retval;
+    }
+
+private:
+    struct entry {
+        const std::string name;
+        std::atomic<std::uint64_t> queries {0};
+        std::atomic<std::uint64_t> errors {0};
+        std::atomic<std::uint64_t> rows {0};
+        std::atomic<std::uint64_t> bytes {0};
+        detail::histogram<> query_time;
+        detail::histogram<> decode_time;
+
+        explicit entry(std::string_view name) : name(name) {}
+
+        query_statistics_snapshot snapshot() const {
+            query_statistics_snapshot retval;
+            retval.queries = queries.load(std::memory_order_relaxed);
+            retval.errors = errors.load(std::memory_order_relaxed);
+            retval.rows = rows.load(std::memory_order_relaxed);
+            retval.bytes = bytes.load(std::memory_order_relaxed);
+            retval.query_time = query_time.snapshot();
+            retval.decode_time = decode_time.snapshot();
+            return retval;
+        }
+    };
+
+    // Entries of a single thread; the mutex guards the container only
+    // and is taken by the owner thread when a new query name appears.
+    struct shard {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<entry>> entries;
+    };
+
+    struct registry {
+        const std::uint64_t id = next_id();
+        std::mutex mutex;
+        std::vector<std::shared_ptr<shard>> shards;
+    };
+
+    // Thread own view of a registry shard with an index which is
+    // accessed by the thread only, so the lookup needs no locking.
+    struct local_shard {
+        std::weak_ptr<registry> owner;
+        std::shared_ptr<shard> data;
+        std::unordered_map<std::string_view, entry*> index;
+    };
+
+    static std::uint64_t next_id() noexcept {
+        static std::atomic<std::uint64_t> counter {0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static std::unordered_map<std::uint64_t, local_shard>& local_shards() noexcept {
+        thread_local std::unordered_map<std::uint64_t, local_shard> retval;
+        return retval;
+    }
+
+    static std::uint64_t ticks(time_traits::duration v) noexcept {
+        return v.count() < 0 ? 0 : static_cast<std::uint64_t>(v.count());
+    }
+
+    // Returns nullptr if memory allocation fails, so the event is lost.
+    entry* local_entry(std::string_view name) const noexcept try {
+        auto& shards = local_shards();
+        auto it = shards.find(registry_->id);
+        if (it == shards.end()) {
+            for (auto i = shards.begin(); i != shards.end();) {
+                i = i->second.owner.expired() ? shards.erase(i) : std::next(i);
+            }
+            auto data = std::make_shared<shard>();
+            {
+                const std::lock_guard lock(registry_->mutex);
+                registry_->shards.push_back(data);
+            }
+            it = shards.emplace(registry_->id, local_shard {registry_, std::move(data), {}}).first;
+        }
+
+        auto& local = it->second;
+        if (const auto found = local.index.find(name); found != local.index.end()) {
+            return found->second;
+        }
+
+        auto added = std::make_unique<entry>(name);
+        const auto retval = added.get();
+        {
+            const std::lock_guard lock(local.data->mutex);
+            local.data->entries.push_back(std::move(added));
+        }
+        local.index.emplace(retval->name, retval);
+        return retval;
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+
+    template <typename Visitor>
+    void for_each_entry(Visitor&& visitor) const {
+        std::vector<std::shared_ptr<shard>> shards;
+        {
+            const std::lock_guard lock(registry_->mutex);
+            shards = registry_->shards;
+        }
+        for (const auto& s : shards) {
+            const std::lock_guard lock(s->mutex);
+            for (const auto& e : s->entries) {
+                visitor(*e);
+            }
+        }
+    }
+
+    std::shared_ptr<registry> registry_;
+};
+
+} // namespace ozo
@@ -381,6 +381,14 @@ private:
 
 using result = basic_result<native_result_handle>;
 
+/**
+ * @brief Database raw result which shares ownership of the native result
+ * @ingroup group-requests-types
+ *
+ * Copies of the result refer to the same `PGresult`, see `ozo::single_flight_request()`.
+ */
+using shared_result = basic_result<std::shared_ptr<PGresult>>;
+
 template <typename T>
 auto make_result(T&& handle) {
     return ozo::basic_result<std::decay_t<T>>(std::forward<T>(handle));
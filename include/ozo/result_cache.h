@@ -0,0 +1,164 @@
+#pragma once
+
+#include <ozo/impl/result_cache.h>
+
+namespace ozo {
+
+/**
+ * @brief Client-side result cache
+ * @ingroup group-requests-types
+ *
+ * Cache of raw results of read requests made via `ozo::cached_request()` for queries which
+ * return the same result for a long time, e.g. reference data. Results are keyed by the query
+ * text and the binary representation of parameters, stored as `ozo::shared_result` for
+ * `ozo::result_cache_config::ttl` within the memory budget. A cache hit provides the result
+ * without getting a connection; concurrent misses of the same request make a single request,
+ * see `ozo::single_flight_request()`. Entries are kept in shards with their own locks to reduce
+ * contention of threads.
+ *
+ * The cache can be invalidated explicitly or by `ozo::invalidate_on_notify()` when a notification
+ * is received on any of the channels, e.g. sent by a trigger on the tables the results depend on.
+ * For a finer invalidation use a cache per channel. Copies of the cache share the entries.
+ *
+ * @code
+ozo::result_cache cache({.ttl = std::chrono::minutes(5)});
+ozo::invalidate_on_notify(cache, conn_info[io], {"currencies_changed"}, [] (auto ec, auto) { ... });
+// ...
+auto res = ozo::cached_request(cache, conn_info[io], "SELECT code, name FROM currencies"_SQL, yield);
+ozo::rows_of<std::string, std::string> currencies;
+ozo::recv_result(res, ozo::empty_oid_map{}, ozo::into(currencies));
+ * @endcode
+ */
+class result_cache {
+public:
+    explicit result_cache(const result_cache_config& config = {})
+    : impl_(std::make_shared<impl::result_cache_state>(config)) {}
+
+    /**
+     * Drops all the entries. Results of requests in flight are not stored.
+     */
+    void invalidate() const { impl_->invalidate(); }
+
+    /**
+     * Number of entries in the cache including the expired ones which are not evicted yet.
+     */
+    std::size_t size() const { return impl_->size(); }
+
+    /**
+     * Estimated memory of the entries in bytes.
+     */
+    std::size_t memory() const { return impl_->memory(); }
+
+    std::shared_ptr<impl::result_cache_state> impl_;
+};
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Requests a database via a client-side result cache
+ *
+ * Provides the cached result of the identical request if it has not expired, otherwise
+ * makes the request like `ozo::single_flight_request()` and stores the result. Errors are
+ * not cached. The result is decoded by a caller with `ozo::recv_result()` and the OID map
+ * of its connection type. A handler without an associated executor is called via
+ * `ozo::get_provider_executor()` of the provider, also for a cached result.
+ *
+ * Use it for read-only queries only.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param cache --- `ozo::result_cache` object.
+ * @param provider --- #ConnectionProvider to get connection from on a cache miss.
+ * @param query --- #Query or `ozo::query_builder` object to request from a database.
+ * @param time_constraint --- request #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+ * @param token --- operation #CompletionToken with `void(ozo::error_code, ozo::shared_result)` signature.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename Query, typename TimeConstraint, typename CompletionToken>
+decltype(auto) cached_request(const result_cache& cache, ConnectionProvider&& provider, Query&& query,
+        TimeConstraint time_constraint, CompletionToken&& token);
+
+/**
+ * @brief Requests a database via a client-side result cache
+ *
+ * This function is time constrain free shortcut to `ozo::cached_request()` function.
+ * Its call is equal to `ozo::cached_request(cache, provider, query, ozo::none, token)` call.
+ *
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename Query, typename CompletionToken>
+decltype(auto) cached_request(const result_cache& cache, ConnectionProvider&& provider, Query&& query,
+        CompletionToken&& token);
+
+/**
+ * @brief Invalidates a result cache on notifications
+ *
+ * Gets a connection, executes `LISTEN` for each channel and drops all the entries of the cache
+ * on every notification received. The operation completes when the connection fails or
+ * with a notification received after the cache is destroyed; the cache is invalidated then
+ * since the following notifications would be lost, so the operation is usually restarted.
+ * Mind that notifications are delivered on transaction commit only.
+ *
+ * @param cache --- `ozo::result_cache` object.
+ * @param provider --- #ConnectionProvider to get a dedicated connection from.
+ * @param channels --- names of the channels to listen to.
+ * @param time_constraint --- #TimeConstraint of getting the connection and `LISTEN` statements.
+ * @param token --- operation #CompletionToken with `void(ozo::error_code, ozo::connection_type<ConnectionProvider>)` signature.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename TimeConstraint, typename CompletionToken>
+decltype(auto) invalidate_on_notify(const result_cache& cache, ConnectionProvider&& provider,
+        std::vector<std::string> channels, TimeConstraint time_constraint, CompletionToken&& token);
+#else
+struct cached_request_op {
+    template <typename P, typename Q, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (const result_cache& cache, P&& provider, Q&& query, TimeConstraint t,
+            CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        using signature_t = void (error_code, shared_result);
+        async_completion<CompletionToken, signature_t> init(token);
+
+        impl::async_cached_request(cache.impl_, std::forward<P>(provider), std::forward<Q>(query),
+            t, init.completion_handler);
+
+        return init.result.get();
+    }
+
+    template <typename P, typename Q, typename CompletionToken>
+    decltype(auto) operator() (const result_cache& cache, P&& provider, Q&& query, CompletionToken&& token) const {
+        return (*this)(cache, std::forward<P>(provider), std::forward<Q>(query), none,
+            std::forward<CompletionToken>(token));
+    }
+};
+
+constexpr cached_request_op cached_request;
+
+struct invalidate_on_notify_op {
+    template <typename P, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (const result_cache& cache, P&& provider, std::vector<std::string> channels,
+            TimeConstraint t, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        using signature_t = void (error_code, connection_type<P>);
+        async_completion<CompletionToken, signature_t> init(token);
+
+        impl::async_invalidate_on_notify(cache.impl_, std::forward<P>(provider), std::move(channels),
+            t, init.completion_handler);
+
+        return init.result.get();
+    }
+
+    template <typename P, typename CompletionToken>
+    decltype(auto) operator() (const result_cache& cache, P&& provider, std::vector<std::string> channels,
+            CompletionToken&& token) const {
+        return (*this)(cache, std::forward<P>(provider), std::move(channels), none,
+            std::forward<CompletionToken>(token));
+    }
+};
+
+constexpr invalidate_on_notify_op invalidate_on_notify;
+#endif
+
+} // namespace ozo
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <ozo/impl/single_flight.h>
+
+namespace ozo {
+
+/**
+ * @brief Group of coalesced requests
+ * @ingroup group-requests-types
+ *
+ * Identical read requests made via `ozo::single_flight_request()` with the same group while one of
+ * them is in flight are coalesced: only the first caller requests the database, every concurrent
+ * caller gets the same `ozo::shared_result`. Requests are identical if they have the same query
+ * text and the same binary representation of parameters. This protects the database from storms
+ * of the same query on hot keys, e.g. on a cache miss.
+ *
+ * Copies of the group share the requests in flight. The group is thread safe.
+ *
+ * @code
+ozo::single_flight group;
+for (int i = 0; i < 100; ++i) {
+    boost::asio::spawn(io, [&] (auto yield) {
+        auto res = ozo::single_flight_request(group, conn_info[io],
+            "SELECT name FROM users WHERE id = "_SQL + std::int64_t(42), yield); // one query for all
+        ozo::rows_of<std::string> rows;
+        ozo::recv_result(res, ozo::empty_oid_map{}, ozo::into(rows));
+    });
+}
+ * @endcode
+ */
+class single_flight {
+public:
+    single_flight() : impl_(std::make_shared<impl::single_flight_state>()) {}
+
+    /**
+     * Number of distinct requests in flight.
+     */
+    std::size_t size() const { return impl_->size(); }
+
+    std::shared_ptr<impl::single_flight_state> impl_;
+};
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Requests a database coalescing identical concurrent requests
+ *
+ * If an identical request is in flight within the group, waits for its result instead of
+ * making a new one, otherwise makes the request via `ozo::request()`. All the waiters get a copy
+ * of the same `ozo::shared_result`, or the same error. The first caller's time constraint limits
+ * the request for all of them. Every caller waits no longer than its own time constraint:
+ * when it expires the caller is completed with `boost::asio::error::operation_aborted` and the
+ * request goes on for the rest. The result is decoded by a caller with `ozo::recv_result()` and
+ * the OID map of its connection type. A handler without an associated executor is called via
+ * `ozo::get_provider_executor()` of the provider.
+ *
+ * Use it for read-only queries only: the waiters do not get a connection and a statement with
+ * side effects would be executed once for all of them.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param group --- `ozo::single_flight` group of coalesced requests.
+ * @param provider --- #ConnectionProvider to get connection from.
+ * @param query --- #Query or `ozo::query_builder` object to request from a database.
+ * @param time_constraint --- request #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+ * @param token --- operation #CompletionToken with `void(ozo::error_code, ozo::shared_result)` signature.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename Query, typename TimeConstraint, typename CompletionToken>
+decltype(auto) single_flight_request(const single_flight& group, ConnectionProvider&& provider, Query&& query,
+        TimeConstraint time_constraint, CompletionToken&& token);
+
+/**
+ * @brief Requests a database coalescing identical concurrent requests
+ *
+ * This function is time constrain free shortcut to `ozo::single_flight_request()` function.
+ * Its call is equal to `ozo::single_flight_request(group, provider, query, ozo::none, token)` call.
+ *
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename Query, typename CompletionToken>
+decltype(auto) single_flight_request(const single_flight& group, ConnectionProvider&& provider, Query&& query,
+        CompletionToken&& token);
+#else
+struct single_flight_request_op {
+    template <typename P, typename Q, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (const single_flight& group, P&& provider, Q&& query, TimeConstraint t,
+            CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        using signature_t = void (error_code, shared_result);
+        async_completion<CompletionToken, signature_t> init(token);
+
+        impl::async_single_flight_request(group.impl_, std::forward<P>(provider), std::forward<Q>(query),
+            t, init.completion_handler);
+
+        return init.result.get();
+    }
+
+    template <typename P, typename Q, typename CompletionToken>
+    decltype(auto) operator() (const single_flight& group, P&& provider, Q&& query, CompletionToken&& token) const {
+        return (*this)(group, std::forward<P>(provider), std::forward<Q>(query), none,
+            std::forward<CompletionToken>(token));
+    }
+};
+
+constexpr single_flight_request_op single_flight_request;
+#endif
+
+} // namespace ozo
@@ -0,0 +1,419 @@
+#pragma once
+
+#include <ozo/connection.h>
+#include <ozo/error.h>
+#include <ozo/time_traits.h>
+#include <ozo/detail/base36.h>
+#include <ozo/detail/histogram.h>
+#include <ozo/detail/stopwatch.h>
+
+#include <boost/hana/core/is_a.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/length.hpp>
+#include <boost/hana/map.hpp>
+#include <boost/hana/second.hpp>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/**
+ * @defgroup group-statistics Statistics
+ * @brief Connection statistics collection.
+ *
+ * The `Statistics` parameter of a #ConnectionSource defines the object which collects
+ * statistics of each connection made by the source. The library reports events of the
+ * connection and request operations phases to the object via the `ozo::collect_statistics_impl`
+ * customization point. The default `ozo::no_statistics` collects nothing and all the
+ * statistics related code including time measurement is eliminated at compile time.
+ */
+
+namespace ozo {
+
+/**
+ * @brief Statistics events
+ * @ingroup group-statistics
+ *
+ * Events reported to a connection statistics object.
+ */
+namespace event {
+
+/**
+ * Connection establishment is finished, successfully or not.
+ */
+struct connect {
+    time_traits::duration duration;
+    error_code error;
+};
+
+/**
+ * Connection for a request has been obtained from a #ConnectionProvider. The duration
+ * includes a connection pool wait time and a connection establishment time if any.
+ */
+struct acquire {
+    time_traits::duration duration;
+};
+
+/**
+ * Request has been sent and the output has been flushed.
+ */
+struct send {
+    time_traits::duration duration;
+    std::size_t bytes; //!< query text and parameters size
+};
+
+/**
+ * First input for a request has been received. The duration is measured from the
+ * start of the request sending.
+ */
+struct first_byte {
+    time_traits::duration duration;
+};
+
+/**
+ * Request result has been received and decoded into the user output.
+ */
+struct decode {
+    time_traits::duration duration;
+    std::size_t rows;
+    std::size_t bytes; //!< result values size
+    std::string_view query = {}; //!< query name, see `ozo::get_query_name()`; empty for unnamed queries
+};
+
+/**
+ * Request is finished, successfully or not. The duration is measured from the start of
+ * the request sending.
+ */
+struct query {
+    time_traits::duration duration;
+    error_code error;
+    std::string_view query = {}; //!< query name, see `ozo::get_query_name()`; empty for unnamed queries
+};
+
+} // namespace event
+
+/**
+ * @brief Statistics collection customization point
+ * @ingroup group-statistics
+ *
+ * Defines how an event is reported to a statistics object. By default calls
+ * `statistics.collect(event)` if such a member function exists and does nothing
+ * otherwise. There are specializations for `boost::hana::map` which reports an
+ * event to every value of the map and for `std::shared_ptr` which reports an
+ * event to the pointee if it is not null.
+ */
+template <typename T, typename = std::void_t<>>
+struct collect_statistics_impl {
+    template <typename Event>
+    static constexpr void apply(T&, const Event&) noexcept {}
+};
+
+template <typename T>
+struct collect_statistics_impl<T, std::void_t<decltype(std::declval<T&>().collect(std::declval<const event::query&>()))>> {
+    template <typename Event>
+    static void apply(T& statistics, const Event& e) {
+        statistics.collect(e);
+    }
+};
+
+template <typename T>
+struct collect_statistics_impl<T, std::enable_if_t<decltype(hana::is_a<hana::map_tag, T>)::value>> {
+    template <typename Event>
+    static void apply(T& statistics, const Event& e) {
+        hana::for_each(statistics, [&](auto& pair) {
+            auto& value = hana::second(pair);
+            collect_statistics_impl<std::decay_t<decltype(value)>>::apply(value, e);
+        });
+    }
+};
+
+template <typename T>
+struct collect_statistics_impl<std::shared_ptr<T>> {
+    template <typename Event>
+    static void apply(const std::shared_ptr<T>& statistics, const Event& e) {
+        if (statistics) {
+            collect_statistics_impl<T>::apply(*statistics, e);
+        }
+    }
+};
+
+/**
+ * @brief Statistics collection activity indicator
+ * @ingroup group-statistics
+ *
+ * Indicates if a statistics type collects anything. For disabled statistics
+ * no time measurements are made. All types except empty `boost::hana::map`
+ * (`ozo::no_statistics`) are treated as enabled by default.
+ */
+template <typename T, typename = std::void_t<>>
+struct is_statistics_enabled : std::true_type {};
+
+template <typename T>
+struct is_statistics_enabled<T, std::enable_if_t<decltype(hana::is_a<hana::map_tag, T>)::value>>
+    : std::bool_constant<decltype(hana::length(std::declval<T>()))::value != 0> {};
+
+template <typename T>
+constexpr bool StatisticsEnabled = is_statistics_enabled<std::decay_t<T>>::value;
+
+/**
+ * @brief Indicates if the #Connection collects statistics
+ * @ingroup group-statistics
+ */
+template <typename Connection>
+constexpr bool ConnectionStatisticsEnabled = StatisticsEnabled<
+    decltype(get_statistics(std::declval<Connection&>()))>;
+
+namespace detail {
+
+template <typename Provider, typename = std::void_t<>>
+struct provider_statistics_enabled : std::false_type {};
+
+template <typename Provider>
+struct provider_statistics_enabled<Provider, std::void_t<connection_type<Provider>>>
+    : std::bool_constant<ConnectionStatisticsEnabled<connection_type<Provider>>> {};
+
+} // namespace detail
+
+/**
+ * @brief Indicates if connections of the #ConnectionProvider collect statistics
+ * @ingroup group-statistics
+ */
+template <typename Provider>
+constexpr bool ProviderStatisticsEnabled = detail::provider_statistics_enabled<std::decay_t<Provider>>::value;
+
+/**
+ * @brief Reports an event to statistics of the #Connection
+ * @ingroup group-statistics
+ *
+ * @param conn --- #Connection.
+ * @param e --- event to report.
+ */
+template <typename T, typename Event>
+inline void collect_statistics(T& conn, const Event& e) {
+    if constexpr (ConnectionStatisticsEnabled<T>) {
+        decltype(auto) statistics = get_statistics(conn);
+        collect_statistics_impl<std::decay_t<decltype(statistics)>>::apply(statistics, e);
+    } else {
+        (void)conn;
+        (void)e;
+    }
+}
+
+/**
+ * @brief Plain copy of statistics counters
+ * @ingroup group-statistics
+ *
+ * Snapshots can be aggregated with `operator +=`. All durations are in
+ * `ozo::time_traits::duration` ticks.
+ */
+struct statistics_snapshot {
+    using histogram = detail::histogram_snapshot<>;
+
+    std::uint64_t connects = 0;
+    std::uint64_t queries = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t rows = 0;
+    std::uint64_t bytes_sent = 0;
+    std::uint64_t bytes_received = 0;
+    std::map<std::string, std::uint64_t> errors_by_class; //!< SQLSTATE class, e.g. "08"; non-SQL errors are under "other" key
+
+    histogram connect_time;
+    histogram acquire_time;
+    histogram send_time;
+    histogram first_byte_time;
+    histogram decode_time;
+    histogram query_time;
+
+    statistics_snapshot& operator +=(const statistics_snapshot& rhs) {
+        connects += rhs.connects;
+        queries += rhs.queries;
+        errors += rhs.errors;
+        rows += rhs.rows;
+        bytes_sent += rhs.bytes_sent;
+        bytes_received += rhs.bytes_received;
+        for (const auto& [k, v] : rhs.errors_by_class) {
+            errors_by_class[k] += v;
+        }
+        connect_time += rhs.connect_time;
+        acquire_time += rhs.acquire_time;
+        send_time += rhs.send_time;
+        first_byte_time += rhs.first_byte_time;
+        decode_time += rhs.decode_time;
+        query_time += rhs.query_time;
+        return *this;
+    }
+};
+
+inline statistics_snapshot operator +(statistics_snapshot lhs, const statistics_snapshot& rhs) {
+    return lhs += rhs;
+}
+
+/**
+ * @brief Lock-free statistics counters
+ * @ingroup group-statistics
+ *
+ * Counters and latency histograms which may be updated concurrently.
+ */
+class statistics_counters {
+public:
+    static constexpr std::uint32_t sqlstate_class_divider = 36 * 36 * 36;
+
+    void collect(const event::connect& e) noexcept {
+        connects_.fetch_add(1, std::memory_order_relaxed);
+        connect_time_.record(ticks(e.duration));
+        count_error(e.error);
+    }
+
+    void collect(const event::acquire& e) noexcept {
+        acquire_time_.record(ticks(e.duration));
+    }
+
+    void collect(const event::send& e) noexcept {
+        bytes_sent_.fetch_add(e.bytes, std::memory_order_relaxed);
+        send_time_.record(ticks(e.duration));
+    }
+
+    void collect(const event::first_byte& e) noexcept {
+        first_byte_time_.record(ticks(e.duration));
+    }
+
+    void collect(const event::decode& e) noexcept {
+        rows_.fetch_add(e.rows, std::memory_order_relaxed);
+        bytes_received_.fetch_add(e.bytes, std::memory_order_relaxed);
+        decode_time_.record(ticks(e.duration));
+    }
+
+    void collect(const event::query& e) noexcept {
+        queries_.fetch_add(1, std::memory_order_relaxed);
+        query_time_.record(ticks(e.duration));
+        count_error(e.error);
+    }
+
+    statistics_snapshot snapshot() const {
+        statistics_snapshot retval;
+        retval.connects = connects_.load(std::memory_order_relaxed);
+        retval.queries = queries_.load(std::memory_order_relaxed);
+        retval.errors = errors_.load(std::memory_order_relaxed);
+        retval.rows = rows_.load(std::memory_order_relaxed);
+        retval.bytes_sent = bytes_sent_.load(std::memory_order_relaxed);
+        retval.bytes_received = bytes_received_.load(std::memory_order_relaxed);
+        errors_by_class_.for_each([&](std::uint32_t key, std::uint64_t count) {
+            retval.errors_by_class[error_class_name(key)] += count;
+        });
+        retval.connect_time = connect_time_.snapshot();
+        retval.acquire_time = acquire_time_.snapshot();
+        retval.send_time = send_time_.snapshot();
+        retval.first_byte_time = first_byte_time_.snapshot();
+        retval.decode_time = decode_time_.snapshot();
+        retval.query_time = query_time_.snapshot();
+        return retval;
+    }
+
+private:
+    static constexpr std::uint32_t other_error = sqlstate_class_divider;
+
+    static std::uint64_t ticks(time_traits::duration v) noexcept {
+        return v.count() < 0 ? 0 : static_cast<std::uint64_t>(v.count());
+    }
+
+    static std::string error_class_name(std::uint32_t key) {
+        if (key >= other_error) {
+            return "other";
+        }
+        auto retval = detail::ltob36(key);
+        return retval.size() < 2 ? "0" + retval : retval;
+    }
+
+    void count_error(const error_code& ec) noexcept {
+        if (!ec) {
+            return;
+        }
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        if (ec.category() == sqlstate::category()) {
+            errors_by_class_.increment(static_cast<std::uint32_t>(ec.value()) / sqlstate_class_divider);
+        } else {
+            errors_by_class_.increment(other_error);
+        }
+    }
+
+    std::atomic<std::uint64_t> connects_ {0};
+    std::atomic<std::uint64_t> queries_ {0};
+    std::atomic<std::uint64_t> errors_ {0};
+    std::atomic<std::uint64_t> rows_ {0};
+    std::atomic<std::uint64_t> bytes_sent_ {0};
+    std::atomic<std::uint64_t> bytes_received_ {0};
+    detail::counter_table<32> errors_by_class_;
+    detail::histogram<> connect_time_;
+    detail::histogram<> acquire_time_;
+    detail::histogram<> send_time_;
+    detail::histogram<> first_byte_time_;
+    detail::histogram<> decode_time_;
+    detail::histogram<> query_time_;
+};
+
+/**
+ * @brief Per connection and per source statistics
+ * @ingroup group-statistics
+ *
+ * Statistics type for a #ConnectionSource like `ozo::connection_info`. The source keeps
+ * a prototype object and copies it into each connection it makes. Every copy gets its own
+ * fresh per-connection counters and shares the per-source counters with the prototype, so
+ * the prototype gives access to the aggregated statistics of all the source connections.
+ *
+ * @code
+ozo::connection_statistics stats;
+auto source = ozo::make_connection_info(conn_str, ozo::empty_oid_map{}, stats);
+// ...
+const auto all = stats.source().snapshot();
+const auto one = ozo::get_statistics(conn).connection().snapshot();
+ * @endcode
+ */
+class connection_statistics {
+public:
+    connection_statistics()
+    : source_(std::make_shared<statistics_counters>()),
+      connection_(std::make_unique<statistics_counters>()) {}
+
+    connection_statistics(const connection_statistics& other)
+    : source_(other.source_),
+      connection_(std::make_unique<statistics_counters>()) {}
+
+    // A moved-from object gets fresh per-connection counters and keeps sharing the
+    // per-source ones, so it stays usable like a copy.
+    connection_statistics(connection_statistics&& other)
+    : source_(other.source_),
+      connection_(std::exchange(other.connection_, std::make_unique<statistics_counters>())) {}
+
+    connection_statistics& operator =(const connection_statistics& other) {
+        source_ = other.source_;
+        connection_ = std::make_unique<statistics_counters>();
+        return *this;
+    }
+
+    connection_statistics& operator =(connection_statistics&& other) {
+        if (this != &other) {
+            source_ = other.source_;
+            connection_ = std::exchange(other.connection_, std::make_unique<statistics_counters>());
+        }
+        return *this;
+    }
+
+    template <typename Event>
+    void collect(const Event& e) noexcept {
+        connection_->collect(e);
+        source_->collect(e);
+    }
+
+    const statistics_counters& connection() const noexcept { return *connection_; }
+
+    const statistics_counters& source() const noexcept { return *source_; }
+
+private:
+    std::shared_ptr<statistics_counters> source_;
+    std::unique_ptr<statistics_counters> connection_;
+};
+
+} // namespace ozo
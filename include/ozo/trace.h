@@ -0,0 +1,292 @@
+#pragma once
+
+#include <ozo/error.h>
+#include <ozo/query.h>
+#include <ozo/time_traits.h>
+#include <ozo/detail/ring_buffer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+/**
+ * @defgroup group-trace Tracing
+ * @brief Per-phase request latency tracing.
+ *
+ * Request operations report the time spent in each phase of a request to a tracer selected
+ * at compile time via the `OZO_TRACER` macro, which should name the tracer type and be defined
+ * before any of the library headers is included. If `OZO_TRACER` is not defined and `OZO_ENABLE_TRACE`
+ * is defined `ozo::trace::ring_buffer_tracer` is used, otherwise `ozo::trace::no_tracer` is used and all
+ * the tracing code including time measurement is eliminated at compile time.
+ *
+ * `OZO_TRACER`, `OZO_ENABLE_TRACE` and `OZO_TRACE_BUFFER_CAPACITY` must have the same values in
+ * every translation unit of a program, so set them for the whole program in the build system,
+ * e.g. with CMake `add_compile_definitions()`, rather than with `#define` in a source file.
+ * The library is header-only, so translation units which see different tracers instantiate
+ * the same inline functions and templates differently. That is an ODR violation: the linker keeps
+ * one of the definitions, and some requests are then traced by the wrong tracer or not at all.
+ *
+ * A tracer is a type with a `static constexpr bool enabled` member and a static
+ * `record(const ozo::trace::record&)` function which is called from a thread the
+ * request is executed by, so it should be fast and should not throw.
+ */
+
+#ifndef OZO_TRACE_BUFFER_CAPACITY
+#define OZO_TRACE_BUFFER_CAPACITY 4096
+#endif
+
+namespace ozo::trace {
+
+/**
+ * @brief Request phase
+ * @ingroup group-trace
+ */
+enum class phase : std::uint8_t {
+    acquire, //!< waiting for a connection from the #ConnectionProvider
+    send, //!< passing the query to libpq
+    flush, //!< flushing the query into the socket
+    wait, //!< waiting for the result from the server
+    decode, //!< converting the result into the output object
+    request, //!< the whole request from the start till the handler call
+};
+
+inline constexpr std::string_view to_string_view(phase v) noexcept {
+    switch (v) {
+        case phase::acquire: return "acquire";
+        case phase::send: return "send";
+        case phase::flush: return "flush";
+        case phase::wait: return "wait";
+        case phase::decode: return "decode";
+        case phase::request: return "request";
+    }
+    return "unknown";
+}
+
+inline std::ostream& operator <<(std::ostream& out, phase v) {
+    return out << to_string_view(v);
+}
+
+/**
+ * @brief Span of a request phase reported to a tracer
+ * @ingroup group-trace
+ */
+struct record {
+    std::string_view name; //!< query name, see `ozo::get_query_name()`; empty for unnamed queries
+    std::uint64_t request; //!< identifier of the request, same for all the phases of the request
+    trace::phase phase; //!< phase of the request
+    bool error; //!< the phase has been finished with an error
+    time_traits::time_point start; //!< start time of the phase
+    time_traits::duration duration; //!< duration of the phase
+};
+
+/**
+ * @brief Writes the span as a JSON object
+ * @ingroup group-trace
+ */
+inline std::ostream& operator <<(std::ostream& out, const record& r) {
+    using std::chrono::nanoseconds;
+    using std::chrono::duration_cast;
+    out << "{\"name\":\"";
+    for (const char c : r.name) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    return out << "\",\"request\":" << r.request
+        << ",\"phase\":\"" << r.phase
+        << "\",\"error\":" << (r.error ? "true" : "false")
+        << ",\"start_ns\":" << duration_cast<nanoseconds>(r.start.time_since_epoch()).count()
+        << ",\"duration_ns\":" << duration_cast<nanoseconds>(r.duration).count() << '}';
+}
+
+/**
+ * @brief Tracer which records nothing
+ * @ingroup group-trace
+ */
+struct no_tracer {
+    static constexpr bool enabled = false;
+
+    static void record(const trace::record&) noexcept {}
+
+    template <typename Visitor>
+    static std::size_t consume(Visitor&&) noexcept { return 0; }
+};
+
+/**
+ * @brief Tracer which records spans into per-thread ring buffers
+ * @ingroup group-trace
+ *
+ * Each thread writes to its own lock-free buffer of `OZO_TRACE_BUFFER_CAPACITY` records,
+ * so recording never blocks. If a buffer is full the record is dropped and accounted by
+ * `dropped()`. Records are read from the buffers by `consume()`, e.g. via `ozo::trace::export_spans()`,
+ * which should be called periodically.
+ */
+class ring_buffer_tracer {
+public:
+    static constexpr bool enabled = true;
+
+    using buffer_type = detail::ring_buffer<trace::record, OZO_TRACE_BUFFER_CAPACITY>;
+
+    static void record(const trace::record& r) noexcept {
+        try {
+            if (local_buffer().push(r)) {
+                return;
+            }
+        } catch (...) {
+        }
+        registry().dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Passes all the recorded spans of all the threads to the visitor and
+     * removes them from the buffers. Returns the number of spans consumed.
+     */
+    template <typename Visitor>
+    static std::size_t consume(Visitor&& visitor) {
+        auto& r = registry();
+        const std::lock_guard lock(r.mutex);
+        std::size_t retval = 0;
+        for (const auto& buffer : r.buffers) {
+            retval += buffer->consume(visitor);
+        }
+        // Buffers of finished threads are owned by the registry only
+        r.buffers.erase(std::remove_if(r.buffers.begin(), r.buffers.end(),
+            [] (const auto& buffer) { return buffer.use_count() == 1 && buffer->empty(); }),
+            r.buffers.end());
+        return retval;
+    }
+
+    static std::uint64_t dropped() noexcept {
+        return registry().dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct registry_type {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<buffer_type>> buffers;
+        std::atomic<std::uint64_t> dropped {0};
+    };
+
+    static registry_type& registry() {
+        static registry_type retval;
+        return retval;
+    }
+
+    static buffer_type& local_buffer() {
+        thread_local const std::shared_ptr<buffer_type> buffer = [] {
+            auto retval = std::make_shared<buffer_type>();
+            auto& r = registry();
+            const std::lock_guard lock(r.mutex);
+            r.buffers.push_back(retval);
+            return retval;
+        }();
+        return *buffer;
+    }
+};
+
+#ifndef OZO_TRACER
+#ifdef OZO_ENABLE_TRACE
+#define OZO_TRACER ::ozo::trace::ring_buffer_tracer
+#else
+#define OZO_TRACER ::ozo::trace::no_tracer
+#endif
+#endif
+
+/**
+ * @brief Tracer selected at compile time
+ * @ingroup group-trace
+ */
+using tracer = OZO_TRACER;
+
+/**
+ * @brief Name of the query to tag spans with
+ * @ingroup group-trace
+ *
+ * @return `ozo::get_query_name()` for a #NamedQuery, empty string otherwise.
+ */
+template <typename Query>
+constexpr std::string_view query_name(const Query& query) noexcept {
+    if constexpr (NamedQuery<Query>) {
+        return get_query_name(query);
+    } else {
+        (void)query;
+        return {};
+    }
+}
+
+/**
+ * @brief Traced request
+ * @ingroup group-trace
+ *
+ * Holds the identity and the start time of a request and reports spans of its phases
+ * to the `Tracer`. If the tracer is not enabled the object is empty and does nothing.
+ */
+template <typename Tracer = tracer, bool = Tracer::enabled>
+class request {
+public:
+    using time_point = time_traits::time_point;
+
+    request() = default;
+
+    /**
+     * @param name --- query name, should refer to a static storage.
+     */
+    explicit request(std::string_view name) noexcept
+    : name_(name), id_(next_id()), start_(now()) {}
+
+    time_point start() const noexcept { return start_; }
+
+    static time_point now() noexcept { return time_traits::now(); }
+
+    void span(trace::phase phase, time_point start, const error_code& ec = {}) const noexcept {
+        Tracer::record(trace::record {name_, id_, phase, bool(ec), start, now() - start});
+    }
+
+private:
+    static std::uint64_t next_id() noexcept {
+        static std::atomic<std::uint64_t> counter {0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    std::string_view name_;
+    std::uint64_t id_ = 0;
+    time_point start_;
+};
+
+template <typename Tracer>
+class request<Tracer, false> {
+public:
+    struct time_point {};
+
+    request() = default;
+
+    constexpr explicit request(std::string_view) noexcept {}
+
+    constexpr time_point start() const noexcept { return {}; }
+
+    static constexpr time_point now() noexcept { return {}; }
+
+    constexpr void span(trace::phase, time_point, const error_code& = {}) const noexcept {}
+};
+
+/**
+ * @brief Writes spans recorded by the tracer as JSON objects, one per line
+ * @ingroup group-trace
+ *
+ * @return number of spans written.
+ */
+template <typename Tracer = tracer>
+std::size_t export_spans(std::ostream& out) {
+    return Tracer::consume([&] (const record& r) { out << r << '\n'; });
+}
+
+} // namespace ozo::trace
@@ -5,6 +5,12 @@
 
 namespace ozo {
 
+/**
+ * Tag type to defer the start of a transaction, see `ozo::begin`.
+ */
+struct deferred_t {};
+constexpr deferred_t deferred;
+
 struct begin_op {
     template <typename T, typename TimeConstraint, typename CompletionToken>
     auto operator() (T&& provider, TimeConstraint t, CompletionToken&& token) const {
@@ -27,10 +33,61 @@ struct begin_op {
             std::forward<CompletionToken>(token)
         );
     }
+
+    template <typename T, typename TimeConstraint, typename CompletionToken>
+    auto operator() (T&& provider, deferred_t, TimeConstraint t, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<T>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        if constexpr (impl::PipelineSupported<connection_type<T>>) {
+            return impl::start_deferred_transaction(
+                std::forward<T>(provider),
+                "BEGIN",
+                t,
+                std::forward<CompletionToken>(token)
+            );
+        } else {
+            return (*this)(std::forward<T>(provider), t, std::forward<CompletionToken>(token));
+        }
+    }
+
+    template <typename T, typename CompletionToken>
+    auto operator() (T&& provider, deferred_t, CompletionToken&& token) const {
+        return (*this)(
+            std::forward<T>(provider),
+            deferred,
+            none,
+            std::forward<CompletionToken>(token)
+        );
+    }
 };
 
+/**
+ * Starts a transaction. With the `ozo::deferred` tag the BEGIN statement is not executed
+ * immediately but sent in a single pipeline with the query of the first request within
+ * the transaction, which saves a round trip. If the connection does not support libpq
+ * pipeline mode the tag is ignored.
+ *
+ * @code
+auto transaction = ozo::begin(pool, ozo::deferred, yield);
+ozo::defer_commit(transaction);
+ozo::execute(transaction, "UPDATE t SET v = v + 1"_SQL, yield); // BEGIN, UPDATE and COMMIT in one round trip
+auto conn = ozo::commit(std::move(transaction), yield); // completes without a round trip
+ * @endcode
+ */
 constexpr begin_op begin;
 
+/**
+ * Makes the COMMIT statement to be sent in a single pipeline with the query of the next
+ * request within the transaction, so `ozo::commit()` needs no round trip then.
+ * Does nothing if the connection does not support libpq pipeline mode.
+ */
+template <typename T>
+inline void defer_commit(impl::transaction<T>& transaction) noexcept {
+    if constexpr (impl::PipelineSupported<T>) {
+        transaction.defer_commit();
+    }
+}
+
 struct commit_op {
     template <typename T, typename TimeConstraint, typename CompletionToken>
     auto operator() (impl::transaction<T>&& transaction, TimeConstraint t, CompletionToken&& token) const {
@@ -312,9 +312,30 @@ namespace pg {
 
 OZO_STRONG_TYPEDEF(std::string, name)
 OZO_STRONG_TYPEDEF(std::vector<char>, bytea)
+OZO_STRONG_TYPEDEF(std::string_view, bytea_view)
 
 } // namespace pg
 
+/**
+ * @brief Indicates whether the type refers to the data it is received from
+ * @ingroup group-type_system-types
+ *
+ * Such types (`std::string_view`, `ozo::pg::bytea_view`, `ozo::pg::jsonb_view`)
+ * point into the result value instead of owning a copy, so they may be received
+ * only via `ozo::borrowed_rows` and `ozo::basic_typed_result` which keep the result alive.
+ * Specialize the trait for a user defined view type to get the same check.
+ *
+ * @tparam T --- type to examine.
+ */
+template <typename T>
+struct is_borrowed_view : std::false_type {};
+
+template <>
+struct is_borrowed_view<std::string_view> : std::true_type {};
+
+template <>
+struct is_borrowed_view<pg::bytea_view> : std::true_type {};
+
 
 namespace detail {
 
@@ -446,6 +467,7 @@ OZO_PG_DEFINE_CUSTOM_TYPE(smtp::message, "code.message")
 OZO_PG_DEFINE_TYPE_AND_ARRAY(bool, "bool", BOOLOID, 1000, bytes<1>)
 OZO_PG_DEFINE_TYPE_AND_ARRAY(char, "char", CHAROID, 1002, bytes<1>)
 OZO_PG_DEFINE_TYPE_AND_ARRAY(ozo::pg::bytea, "bytea", BYTEAOID, 1001, dynamic_size)
+OZO_PG_DEFINE_TYPE_AND_ARRAY(ozo::pg::bytea_view, "bytea", BYTEAOID, 1001, dynamic_size)
 
 OZO_PG_DEFINE_TYPE_AND_ARRAY(int64_t, "int8", INT8OID, 1016, bytes<8>)
 OZO_PG_DEFINE_TYPE_AND_ARRAY(int32_t, "int4", INT4OID, INT4ARRAYOID, bytes<4>)
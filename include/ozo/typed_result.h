@@ -0,0 +1,358 @@
+#pragma once
+
+#include <ozo/io/recv.h>
+#include <ozo/result.h>
+#include <ozo/shortcuts.h>
+
+#include <boost/fusion/include/at_c.hpp>
+#include <boost/fusion/include/size.hpp>
+#include <boost/fusion/include/value_at.hpp>
+#include <boost/hana/accessors.hpp>
+#include <boost/hana/at.hpp>
+#include <boost/hana/first.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/length.hpp>
+#include <boost/hana/range.hpp>
+#include <boost/hana/second.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <array>
+#include <functional>
+#include <tuple>
+
+namespace ozo {
+namespace detail {
+
+template <typename Row>
+struct typed_result_fusion_fields {
+    static constexpr std::size_t size = static_cast<std::size_t>(fusion::result_of::size<Row>::value);
+
+    template <std::size_t I>
+    using field_type = std::decay_t<typename fusion::result_of::value_at_c<Row, I>::type>;
+
+    template <std::size_t I>
+    static auto& field(Row& row) { return fusion::at_c<I>(row); }
+};
+
+template <typename Row>
+inline int typed_result_column(const char* name, int column) {
+    if (column == -1) {
+        throw std::range_error(std::string("result does not contain \"") + name + "\" column for "
+            + boost::core::demangle(typeid(Row).name()));
+    }
+    return column;
+}
+
+/**
+ * Fields of `std::tuple` and other Fusion sequences are received from the columns by position.
+ */
+template <typename Row, typename = std::void_t<>>
+struct typed_result_row_traits : typed_result_fusion_fields<Row> {
+    using typed_result_fusion_fields<Row>::size;
+
+    template <typename T>
+    static std::array<int, size> columns(const basic_result<T>& res) {
+        const auto nfields = static_cast<std::size_t>(impl::nfields(*res.handle()));
+        if (nfields != size) {
+            throw std::range_error("result columns count " + std::to_string(nfields)
+                + " does not match sequence " + boost::core::demangle(typeid(Row).name())
+                + " size " + std::to_string(size));
+        }
+        std::array<int, size> retval;
+        for (std::size_t i = 0; i < size; ++i) {
+            retval[i] = static_cast<int>(i);
+        }
+        return retval;
+    }
+};
+
+/**
+ * Fields of a Fusion adapted structure are received from the columns with the same names.
+ */
+template <typename Row>
+struct typed_result_row_traits<Row, Require<FusionAdaptedStruct<Row> && !HanaStruct<Row>>>
+        : typed_result_fusion_fields<Row> {
+    using typed_result_fusion_fields<Row>::size;
+
+    template <typename T>
+    static std::array<int, size> columns(const basic_result<T>& res) {
+        std::array<int, size> retval;
+        hana::for_each(hana::make_range(hana::size_c<0>, hana::size_c<size>), [&] (auto i) {
+            constexpr auto I = decltype(i)::value;
+            const char* name = fusion::extension::struct_member_name<Row, I>::call();
+            retval[i] = typed_result_column<Row>(name, impl::field_number(*res.handle(), name));
+        });
+        return retval;
+    }
+};
+
+/**
+ * Fields of a Hana adapted structure are received from the columns with the same names.
+ */
+template <typename Row>
+struct typed_result_row_traits<Row, Require<HanaStruct<Row>>> {
+    static constexpr std::size_t size = decltype(hana::length(hana::accessors<Row>()))::value;
+
+    template <std::size_t I>
+    static auto& field(Row& row) { return hana::second(hana::at_c<I>(hana::accessors<Row>()))(row); }
+
+    template <std::size_t I>
+    using field_type = std::decay_t<decltype(field<I>(std::declval<Row&>()))>;
+
+    template <typename T>
+    static std::array<int, size> columns(const basic_result<T>& res) {
+        std::array<int, size> retval;
+        hana::for_each(hana::make_range(hana::size_c<0>, hana::size_c<size>), [&] (auto i) {
+            constexpr auto I = decltype(i)::value;
+            const char* name = hana::to<const char*>(hana::first(hana::at_c<I>(hana::accessors<Row>())));
+            retval[i] = typed_result_column<Row>(name, impl::field_number(*res.handle(), name));
+        });
+        return retval;
+    }
+};
+
+template <typename ... Ts>
+struct typed_result_row { using type = typed_row<Ts...>; };
+
+template <typename T>
+struct typed_result_row<T> {
+    using type = std::conditional_t<FusionAdaptedStruct<T> || HanaStruct<T>, T, typed_row<T>>;
+};
+
+} // namespace detail
+
+/**
+ * @ingroup group-requests-types
+ * @brief Result which receives the rows lazily.
+ *
+ * Unlike `ozo::recv_result()` into a container, the result is not decoded upfront. Each field is
+ * received from its cell when it is accessed, so the rows or the columns which are not used
+ * cost nothing. The columns count or names and the oids of the columns are checked once
+ * when the result is assigned.
+ *
+ * Fields of `std::tuple` rows correspond to the columns by position, fields of adapted
+ * structures correspond to the columns with the same names. Each access receives the field
+ * again, so store the value if it is used repeatedly.
+ *
+ * ### Example
+ *
+@code{cpp}
+const auto query = "SELECT id, name FROM users_info"_SQL;
+
+ozo::typed_result<std::int64_t, std::string> res;
+
+ozo::request(conn_info[io], query, ozo::into(res), boost::asio::use_future);
+
+for (const auto row : res) {
+    if (row.get<0>() % 100 == 0) {
+        std::cout << row.get<1>() << std::endl;
+    }
+}
+@endcode
+ * @tparam Row --- type of a row, `std::tuple` or an adapted structure
+ * @tparam OidMap --- #OidMap type to receive the fields with
+ * @tparam Result --- type of the underlying result
+ */
+template <typename Row, typename OidMap = empty_oid_map, typename Result = result>
+class basic_typed_result {
+    using traits = detail::typed_result_row_traits<Row>;
+
+public:
+    using row_type = Row;
+    using oid_map_type = OidMap;
+    using result_type = Result;
+
+    static constexpr std::size_t fields_count = traits::size;
+
+    /**
+     * @brief Proxy of a row which receives its fields on access.
+     */
+    class row_view {
+    public:
+        row_view(const basic_typed_result& result, int row) noexcept : result_(&result), row_(row) {}
+
+        /**
+         * @brief Receives the field of the row.
+         *
+         * @tparam I --- index of the field in the row type.
+         * @return value of the field.
+         */
+        template <std::size_t I>
+        auto get() const {
+            typename traits::template field_type<I> out{};
+            receive<I>(out);
+            return out;
+        }
+
+        /**
+         * @brief Indicates if the field is null without receiving it.
+         *
+         * @tparam I --- index of the field in the row type.
+         */
+        template <std::size_t I>
+        bool is_null() const noexcept {
+            return cell<I>().is_null();
+        }
+
+        /**
+         * @brief Receives all the fields of the row.
+         *
+         * @return row_type --- the received row.
+         */
+        row_type decode() const {
+            row_type out{};
+            hana::for_each(hana::make_range(hana::size_c<0>, hana::size_c<fields_count>), [&] (auto i) {
+                constexpr auto I = decltype(i)::value;
+                receive<I>(traits::template field<I>(out));
+            });
+            return out;
+        }
+
+        int index() const noexcept { return row_; }
+
+    private:
+        template <std::size_t I>
+        auto cell() const noexcept {
+            return result_->result_[row_][result_->columns_[I]];
+        }
+
+        template <std::size_t I, typename Out>
+        void receive(Out& out) const {
+            const auto v = cell<I>();
+            const auto size = v.is_null() ? null_state_size : size_type(v.size());
+            detail::istreambuf_view sbuf(v.data(), size == null_state_size ? 0 : std::size_t(size));
+            istream s(&sbuf);
+            // Oids of the columns are checked when the result is assigned.
+            detail::recv(s, null_oid, size, result_->oid_map_, out);
+        }
+
+        const basic_typed_result* result_;
+        int row_;
+    };
+
+    class const_iterator : public boost::iterator_facade<
+        const_iterator,
+        row_view,
+        boost::random_access_traversal_tag,
+        row_view,
+        int
+    > {
+    public:
+        const_iterator() = default;
+        const_iterator(const basic_typed_result* result, int row) noexcept : result_(result), row_(row) {}
+
+    private:
+        row_view dereference() const noexcept { return {*result_, row_}; }
+
+        bool equal(const const_iterator& rhs) const noexcept {
+            return result_ == rhs.result_ && row_ == rhs.row_;
+        }
+
+        void increment() noexcept { advance(1); }
+        void decrement() noexcept { advance(-1); }
+        void advance(int n) noexcept { row_ += n; }
+
+        int distance_to(const const_iterator& z) const noexcept { return z.row_ - row_; }
+
+        const basic_typed_result* result_ = nullptr;
+        int row_ = 0;
+
+        friend class boost::iterator_core_access;
+    };
+
+    using iterator = const_iterator;
+
+    basic_typed_result() = default;
+
+    /**
+     * @brief Constructs the typed result over the result.
+     *
+     * @param res --- result to receive rows from.
+     * @param oid_map --- #OidMap to check and receive the fields with.
+     */
+    basic_typed_result(result_type res, const oid_map_type& oid_map = oid_map_type{}) {
+        assign(std::move(res), oid_map);
+    }
+
+    /**
+     * @brief Takes ownership of the result and checks its columns.
+     *
+     * Throws `std::range_error` if the columns do not match the row type and `ozo::system_error`
+     * with `ozo::error::oid_type_mismatch` if a column oid is not accepted by its field type.
+     *
+     * @param res --- result to receive rows from.
+     * @param oid_map --- #OidMap to check and receive the fields with.
+     */
+    void assign(result_type res, const oid_map_type& oid_map) {
+        const auto columns = traits::columns(res);
+        hana::for_each(hana::make_range(hana::size_c<0>, hana::size_c<fields_count>), [&] (auto i) {
+            using field_type = typename traits::template field_type<decltype(i)::value>;
+            const auto oid = impl::field_type(*res.handle(), columns[i]);
+            if (!accepts_oid<field_type>(oid_map, oid)) {
+                throw system_error(error::oid_type_mismatch, "unexpected oid " + std::to_string(oid)
+                    + " of column " + std::to_string(columns[i]) + " for type "
+                    + boost::core::demangle(typeid(unwrap_type<field_type>).name()));
+            }
+        });
+        result_ = std::move(res);
+        oid_map_ = oid_map;
+        columns_ = columns;
+    }
+
+    const_iterator begin() const noexcept { return {this, 0}; }
+    const_iterator end() const noexcept { return begin() + static_cast<int>(size()); }
+
+    std::size_t size() const noexcept { return result_.size(); }
+    bool empty() const noexcept { return size() == 0; }
+
+    row_view operator[] (int i) const noexcept { return {*this, i}; }
+
+    row_view at(int i) const {
+        if (i < 0 || static_cast<std::size_t>(i) >= size()) {
+            throw std::out_of_range("ozo::basic_typed_result::at() index " + std::to_string(i) + " out of range");
+        }
+        return (*this)[i];
+    }
+
+    const result_type& result() const noexcept { return result_; }
+
+private:
+    result_type result_;
+    oid_map_type oid_map_;
+    std::array<int, fields_count> columns_ {};
+};
+
+/**
+ * @ingroup group-requests-types
+ * @brief Shortcut for `ozo::basic_typed_result` with the default result and #OidMap.
+ *
+ * Rows are `std::tuple<Ts...>`, or the structure if the only type is an adapted structure.
+ *
+ * @tparam Ts --- types of columns in result, or an adapted structure type.
+ */
+template <typename ... Ts>
+using typed_result = basic_typed_result<typename detail::typed_result_row<Ts...>::type>;
+
+template <typename T, typename M, typename Row>
+basic_typed_result<Row, oid_map_t<M>, basic_result<T>>& recv_result(basic_result<T>& in,
+        const oid_map_t<M>& oid_map, basic_typed_result<Row, oid_map_t<M>, basic_result<T>>& out) {
+    out.assign(std::move(in), oid_map);
+    return out;
+}
+
+template <typename T, typename M, typename Row>
+basic_typed_result<Row, oid_map_t<M>, basic_result<T>>& recv_result(basic_result<T>& in,
+        const oid_map_t<M>& oid_map, std::reference_wrapper<basic_typed_result<Row, oid_map_t<M>, basic_result<T>>> out) {
+    return recv_result(in, oid_map, out.get());
+}
+
+/**
+ * @ingroup group-requests-functions
+ * @brief Shortcut for create reference wrapper for `ozo::basic_typed_result`.
+ *
+ * @param v --- `ozo::basic_typed_result` object for the result.
+ */
+template <typename Row, typename OidMap, typename Result>
+constexpr auto into(basic_typed_result<Row, OidMap, Result>& v) { return std::ref(v);}
+
+} // namespace ozo
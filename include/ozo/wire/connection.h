@@ -0,0 +1,659 @@
+#pragma once
+
+#include <ozo/asio.h>
+#include <ozo/connection.h>
+#include <ozo/impl/io.h>
+#include <ozo/detail/md5.h>
+#include <ozo/wire/conninfo.h>
+#include <ozo/wire/protocol.h>
+#include <ozo/wire/result.h>
+
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <optional>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace ozo::wire {
+
+/**
+ * Asynchronous notification received from the server.
+ */
+struct notification {
+    std::int32_t pid;
+    std::string channel;
+    std::string payload;
+};
+
+/**
+ * Notification taken from the session by `pq_notifies()`, it has the same members
+ * as `PGnotify` has.
+ */
+struct notify {
+    std::string relname;
+    std::string extra;
+    int be_pid = 0;
+};
+
+/**
+ * @brief Native protocol session state
+ * @ingroup group-wire
+ *
+ * This is the native handle of the native protocol connection, the same
+ * thing `PGconn` is for the libpq connection. It implements the protocol
+ * state machine and owns the read and the write buffers. The IO is performed
+ * via the connection socket object which is passed to the IO functions, so the
+ * session does not own the socket once it has been assigned to the connection.
+ *
+ * The read buffer consists of chunks which are never reallocated, so the rows
+ * of results refer to the buffer data directly and the decoders read values in
+ * place. A chunk is reused when no result refers to it anymore.
+ */
+class session {
+public:
+    enum class state {
+        connecting,
+        authenticating,
+        ready,
+        failed,
+    };
+
+    static constexpr std::size_t default_chunk_size = 64 * 1024;
+    static constexpr std::size_t min_read_size = 4 * 1024;
+    // Notifications are kept until taken via pq_notifies(), the oldest ones are dropped
+    // beyond this limit so a connection which does not listen any more does not grow.
+    static constexpr std::size_t max_notifications = 64 * 1024;
+
+    session() = default;
+    explicit session(conninfo info) : info_(std::move(info)) {}
+
+    session(const session&) = delete;
+    session& operator =(const session&) = delete;
+
+    ~session() {
+        if (fd_ != -1) {
+            ::close(fd_);
+        }
+    }
+
+    /**
+     * Opens a non-blocking socket and starts connecting to the server.
+     */
+    bool start() {
+        if (info_.sslmode == "require" || info_.sslmode == "verify-ca" || info_.sslmode == "verify-full") {
+            return fail("SSL is not supported by the native protocol connection");
+        }
+        if (const auto path = info_.unix_socket_path(); !path.empty()) {
+            return start_unix(path);
+        }
+        return start_tcp();
+    }
+
+    /**
+     * Gives up the socket descriptor ownership to the connection socket object.
+     */
+    int release_fd() noexcept { return std::exchange(fd_, -1); }
+
+    template <typename Stream>
+    PostgresPollingStatusType connect_poll(Stream& s) {
+        if (state_ == state::connecting) {
+            int err = 0;
+            socklen_t len = sizeof(err);
+            if (::getsockopt(s.native_handle(), SOL_SOCKET, SO_ERROR, &err, &len) == -1) {
+                err = errno;
+            }
+            if (err != 0) {
+                fail(std::string("could not connect to server: ") + std::strerror(err));
+                return PGRES_POLLING_FAILED;
+            }
+            frontend::write_startup(out_, startup_params());
+            state_ = state::authenticating;
+        }
+
+        if (state_ == state::authenticating) {
+            if (flush(s) == impl::query_state::error) {
+                return PGRES_POLLING_FAILED;
+            }
+            if (!out_.empty()) {
+                return PGRES_POLLING_WRITING;
+            }
+            if (!read(s)) {
+                return PGRES_POLLING_FAILED;
+            }
+            if (!out_.empty() && flush(s) == impl::query_state::error) {
+                return PGRES_POLLING_FAILED;
+            }
+        }
+
+        switch (state_) {
+            case state::ready:
+                return PGRES_POLLING_OK;
+            case state::failed:
+                return PGRES_POLLING_FAILED;
+            default:
+                break;
+        }
+        return out_.empty() ? PGRES_POLLING_READING : PGRES_POLLING_WRITING;
+    }
+
+    /**
+     * Enqueues the extended query protocol messages for a statement.
+     * The arguments have the same meaning as for `PQsendQueryParams`.
+     */
+    bool send_query(const char* text, int params_count, const oid_t* types,
+            const char* const* values, const int* lengths, const int* formats) {
+        if (state_ != state::ready) {
+            return false;
+        }
+        frontend::write_extended_query(out_, text, params_count, types, values, lengths, formats);
+        ++pending_syncs_;
+        return true;
+    }
+
+    /**
+     * Writes the output buffer to the socket as much as possible.
+     */
+    template <typename Stream>
+    impl::query_state flush(Stream& s) {
+        while (!out_.empty()) {
+            error_code ec;
+            const auto n = s.write_some(asio::buffer(out_), ec);
+            if (ec == asio::error::would_block || ec == asio::error::try_again) {
+                return impl::query_state::send_in_progress;
+            }
+            if (ec) {
+                fail("could not send data to server: " + ec.message());
+                return impl::query_state::error;
+            }
+            out_.erase(out_.begin(), out_.begin() + static_cast<std::ptrdiff_t>(n));
+        }
+        return impl::query_state::send_finish;
+    }
+
+    /**
+     * Reads all the data available from the socket and processes
+     * complete messages, like `PQconsumeInput` does.
+     */
+    template <typename Stream>
+    bool read(Stream& s) {
+        for (;;) {
+            prepare_read();
+            error_code ec;
+            const auto n = s.read_some(asio::buffer(chunk_->data() + end_, chunk_->size() - end_), ec);
+            if (ec == asio::error::would_block || ec == asio::error::try_again) {
+                return state_ != state::failed;
+            }
+            if (ec == asio::error::eof) {
+                return fail("server closed the connection unexpectedly");
+            }
+            if (ec) {
+                return fail("could not receive data from server: " + ec.message());
+            }
+            end_ += n;
+            if (!process()) {
+                return false;
+            }
+        }
+    }
+
+    bool is_busy() const noexcept {
+        return ready_.empty() && pending_syncs_ > 0 && state_ != state::failed;
+    }
+
+    /**
+     * Gives the next result like `PQgetResult` does: the results of a statement
+     * are followed by a null handle.
+     */
+    result_handle get_result() noexcept {
+        if (ready_.empty()) {
+            return {};
+        }
+        auto retval = std::move(ready_.front());
+        ready_.pop_front();
+        return retval;
+    }
+
+    bool bad() const noexcept { return state_ == state::failed; }
+
+    const char* error_message() const noexcept { return error_message_.c_str(); }
+
+    PGTransactionStatusType transaction_status() const noexcept {
+        if (state_ != state::ready) {
+            return PQTRANS_UNKNOWN;
+        }
+        if (pending_syncs_ > 0) {
+            return PQTRANS_ACTIVE;
+        }
+        switch (transaction_status_) {
+            case 'I': return PQTRANS_IDLE;
+            case 'T': return PQTRANS_INTRANS;
+            case 'E': return PQTRANS_INERROR;
+        }
+        return PQTRANS_UNKNOWN;
+    }
+
+    std::int32_t backend_pid() const noexcept { return backend_pid_; }
+
+    const std::map<std::string, std::string>& parameters() const noexcept { return parameters_; }
+
+    std::deque<notification>& notifications() noexcept { return notifications_; }
+
+    /**
+     * Processes complete messages from the given input as if they had been
+     * received from the socket.
+     */
+    bool consume(const char* data, std::size_t size) {
+        while (size) {
+            prepare_read();
+            const auto n = std::min(size, chunk_->size() - end_);
+            std::memcpy(chunk_->data() + end_, data, n);
+            end_ += n;
+            data += n;
+            size -= n;
+            if (!process()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void set_state(state v) noexcept { state_ = v; }
+
+private:
+    bool fail(std::string message) {
+        state_ = state::failed;
+        error_message_ = std::move(message);
+        return false;
+    }
+
+    std::map<std::string, std::string> startup_params() const {
+        auto retval = info_.options;
+        retval.emplace("user", info_.user);
+        retval.emplace("database", info_.dbname);
+        return retval;
+    }
+
+    bool start_unix(const std::string& path) {
+        sockaddr_un addr {};
+        if (path.size() >= sizeof(addr.sun_path)) {
+            return fail("Unix-domain socket path \"" + path + "\" is too long");
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        return start_connect(AF_UNIX, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+    }
+
+    bool start_tcp() {
+        addrinfo hints {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addresses = nullptr;
+        if (const int err = ::getaddrinfo(info_.host.c_str(), info_.port.c_str(), &hints, &addresses)) {
+            return fail("could not translate host name \"" + info_.host + "\" to address: " + ::gai_strerror(err));
+        }
+        std::unique_ptr<addrinfo, decltype(&::freeaddrinfo)> guard(addresses, &::freeaddrinfo);
+        for (auto a = addresses; a; a = a->ai_next) {
+            if (start_connect(a->ai_family, a->ai_addr, a->ai_addrlen)) {
+                const int on = 1;
+                ::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool start_connect(int family, const sockaddr* addr, socklen_t size) {
+        fd_ = ::socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd_ == -1) {
+            return fail(std::string("could not create socket: ") + std::strerror(errno));
+        }
+        if (::connect(fd_, addr, size) == -1 && errno != EINPROGRESS) {
+            const int err = errno;
+            ::close(std::exchange(fd_, -1));
+            return fail(std::string("could not connect to server: ") + std::strerror(err));
+        }
+        state_ = state::connecting;
+        return true;
+    }
+
+    void prepare_read() {
+        const auto pending = end_ - begin_;
+        std::size_t required = pending + min_read_size;
+        backend::message m;
+        if (pending >= message_header_size && !backend::parse_message(chunk_->data() + begin_, pending, m)) {
+            std::int32_t length;
+            std::memcpy(&length, chunk_->data() + begin_ + 1, sizeof(length));
+            required = std::max(required,
+                static_cast<std::size_t>(ozo::detail::convert_from_big_endian(length)) + 1 + min_read_size);
+        }
+        if (chunk_ && chunk_->size() - begin_ >= required) {
+            return;
+        }
+        if (chunk_ && chunk_.use_count() == 1 && chunk_->size() >= required) {
+            std::memmove(chunk_->data(), chunk_->data() + begin_, pending);
+        } else {
+            auto chunk = std::make_shared<buffer>(std::max(default_chunk_size, required));
+            if (pending) {
+                std::memcpy(chunk->data(), chunk_->data() + begin_, pending);
+            }
+            chunk_ = std::move(chunk);
+        }
+        begin_ = 0;
+        end_ = pending;
+    }
+
+    bool process() {
+        try {
+            backend::message m;
+            while (const auto n = backend::parse_message(chunk_->data() + begin_, end_ - begin_, m)) {
+                begin_ += n;
+                if (!dispatch(m)) {
+                    return false;
+                }
+            }
+        } catch (const system_error& e) {
+            return fail(std::string("invalid message from server: ") + e.what());
+        }
+        // The chunk may be rewound only if no result refers to it, otherwise the next
+        // read goes to its free tail or to a new chunk.
+        if (begin_ == end_ && chunk_.use_count() == 1) {
+            begin_ = end_ = 0;
+        }
+        return true;
+    }
+
+    bool dispatch(const backend::message& m) {
+        backend::reader in{m};
+        switch (m.type) {
+            case 'R': return authenticate(in);
+            case 'S': {
+                const auto name = in.string();
+                parameters_[std::string(name)] = std::string(in.string());
+                return true;
+            }
+            case 'K':
+                backend_pid_ = in.int32();
+                secret_key_ = in.int32();
+                return true;
+            case 'Z':
+                transaction_status_ = in.byte();
+                if (state_ == state::authenticating) {
+                    state_ = state::ready;
+                    return true;
+                }
+                if (current_) {
+                    ready_.push_back(std::move(current_));
+                }
+                ready_.push_back(nullptr);
+                if (pending_syncs_ > 0) {
+                    --pending_syncs_;
+                }
+                return true;
+            case 'E':
+                return error_response(in);
+            case 'T':
+                return row_description(in);
+            case 'D':
+                return data_row(in);
+            case 'C':
+                return complete(PGRES_COMMAND_OK, std::string(in.string()));
+            case 's':
+                return complete(PGRES_COMMAND_OK, {});
+            case 'I':
+                return complete(PGRES_EMPTY_QUERY, {});
+            case 'A': {
+                notification n;
+                n.pid = in.int32();
+                n.channel = in.string();
+                n.payload = in.string();
+                if (notifications_.size() == max_notifications) {
+                    notifications_.pop_front();
+                }
+                notifications_.push_back(std::move(n));
+                return true;
+            }
+            default:
+                // ParseComplete, BindComplete, CloseComplete, NoData, NoticeResponse
+                // and ParameterDescription carry nothing we need.
+                return true;
+        }
+    }
+
+    bool authenticate(backend::reader& in) {
+        switch (in.int32()) {
+            case 0:
+                return true;
+            case 3:
+                frontend::write_password(out_, info_.password);
+                return true;
+            case 5: {
+                const std::string_view salt(in.bytes(4), 4);
+                const auto inner = ozo::detail::md5_hex(info_.password + info_.user);
+                frontend::write_password(out_, "md5" + ozo::detail::md5_hex(inner + std::string(salt)));
+                return true;
+            }
+            case 10:
+                return fail("SASL authentication is not supported by the native protocol connection");
+        }
+        return fail("unsupported authentication method requested by server");
+    }
+
+    bool error_response(backend::reader& in) {
+        std::string severity, sqlstate, message;
+        for (char field = in.byte(); field != '\0'; field = in.byte()) {
+            const auto value = in.string();
+            switch (field) {
+                case 'V': severity = value; break;
+                case 'S': if (severity.empty()) severity = value; break;
+                case 'C': sqlstate = value; break;
+                case 'M': message = value; break;
+            }
+        }
+        error_message_ = severity + ":  " + message;
+        if (state_ != state::ready) {
+            state_ = state::failed;
+            return false;
+        }
+        current_ = std::make_unique<pg_result>();
+        current_->status = PGRES_FATAL_ERROR;
+        current_->sqlstate = std::move(sqlstate);
+        current_->message = std::move(message);
+        ready_.push_back(std::move(current_));
+        return true;
+    }
+
+    bool row_description(backend::reader& in) {
+        current_ = std::make_unique<pg_result>();
+        current_->status = PGRES_TUPLES_OK;
+        const auto count = in.int16();
+        current_->columns.resize(static_cast<std::size_t>(std::max<std::int16_t>(count, 0)));
+        for (auto& column : current_->columns) {
+            column.name = in.string();
+            in.int32(); // table oid
+            in.int16(); // column attribute number
+            column.type = static_cast<oid_t>(in.int32());
+            in.int16(); // type size
+            in.int32(); // type modifier
+            column.format = static_cast<impl::result_format>(in.int16());
+        }
+        return true;
+    }
+
+    bool data_row(backend::reader& in) {
+        if (!current_ || current_->status != PGRES_TUPLES_OK) {
+            return fail("unexpected DataRow message from server");
+        }
+        const auto count = in.int16();
+        if (static_cast<std::size_t>(count) != current_->columns.size()) {
+            return fail("unexpected field count in DataRow message");
+        }
+        for (std::int16_t i = 0; i < count; ++i) {
+            pg_result::cell v;
+            v.length = in.int32();
+            if (v.length >= 0) {
+                v.data = in.bytes(static_cast<std::size_t>(v.length));
+            }
+            current_->cells.push_back(v);
+        }
+        current_->hold(chunk_);
+        return true;
+    }
+
+    bool complete(ExecStatusType status, std::string tag) {
+        if (!current_) {
+            current_ = std::make_unique<pg_result>();
+            current_->status = status;
+        }
+        current_->command_tag = std::move(tag);
+        ready_.push_back(std::move(current_));
+        return true;
+    }
+
+    conninfo info_;
+    int fd_ = -1;
+    state state_ = state::failed;
+    std::string error_message_;
+
+    buffer_ptr chunk_;
+    std::size_t begin_ = 0;
+    std::size_t end_ = 0;
+    std::vector<char> out_;
+
+    result_handle current_;
+    std::deque<result_handle> ready_;
+    std::size_t pending_syncs_ = 0;
+
+    char transaction_status_ = 'I';
+    std::int32_t backend_pid_ = 0;
+    std::int32_t secret_key_ = 0;
+    std::map<std::string, std::string> parameters_;
+    std::deque<notification> notifications_;
+};
+
+using native_handle = std::unique_ptr<session>;
+
+inline bool connection_status_bad(const session* handle) noexcept {
+    return !handle || handle->bad();
+}
+
+inline const char* PQerrorMessage(const session* handle) noexcept {
+    return handle ? handle->error_message() : "";
+}
+
+inline PGTransactionStatusType PQtransactionStatus(const session* handle) noexcept {
+    return handle ? handle->transaction_status() : PQTRANS_UNKNOWN;
+}
+
+/**
+ * @brief Native protocol connection implementation
+ * @ingroup group-wire
+ *
+ * #Connection which talks to the server via the frontend/backend protocol
+ * directly instead of libpq. It supports the same set of operations and
+ * may be used with any #ConnectionProvider. Requests via this connection
+ * should receive raw results into `ozo::wire::result`.
+ */
+template <typename OidMap, typename Statistics>
+struct connection_impl {
+    connection_impl(io_context& io, Statistics statistics)
+        : socket_(io), statistics_(std::move(statistics)), timer_(io) {}
+
+    native_handle handle_;
+    asio::posix::stream_descriptor socket_;
+    OidMap oid_map_;
+    Statistics statistics_;
+    std::string error_context_;
+    asio::steady_timer timer_;
+
+    friend error_code pq_start_connection(connection_impl& c, const std::string& conninfo) {
+        auto info = parse_conninfo(conninfo);
+        if (!info) {
+            set_error_context(c, "invalid connection string");
+            return error::pq_connection_start_failed;
+        }
+        c.handle_ = std::make_unique<session>(std::move(*info));
+        c.handle_->start();
+        return {};
+    }
+
+    friend error_code pq_assign_socket(connection_impl& c) {
+        error_code ec;
+        c.socket_.assign(c.handle_->release_fd(), ec);
+        if (ec) {
+            set_error_context(c, "assign socket failed");
+            return ec;
+        }
+        c.socket_.non_blocking(true, ec);
+        return ec;
+    }
+
+    friend PostgresPollingStatusType pq_connect_poll(connection_impl& c) {
+        return c.handle_->connect_poll(c.socket());
+    }
+
+    template <typename ...Ts>
+    friend int pq_send_query_params(connection_impl& c, const binary_query<Ts...>& q) noexcept {
+        try {
+            return c.handle_->send_query(q.text(), q.params_count, q.types(), q.values(), q.lengths(), q.formats());
+        } catch (const std::exception&) {
+            return 0;
+        }
+    }
+
+    friend int pq_set_nonblocking(connection_impl&) noexcept {
+        return 0;
+    }
+
+    friend int pq_consume_input(connection_impl& c) noexcept {
+        try {
+            return c.handle_->read(c.socket());
+        } catch (const std::exception&) {
+            return 0;
+        }
+    }
+
+    friend bool pq_is_busy(connection_impl& c) noexcept {
+        return c.handle_->is_busy();
+    }
+
+    friend impl::query_state pq_flush_output(connection_impl& c) noexcept {
+        return c.handle_->flush(c.socket());
+    }
+
+    friend result_handle pq_get_result(connection_impl& c) noexcept {
+        return c.handle_->get_result();
+    }
+
+    friend std::optional<notify> pq_notifies(connection_impl& c) noexcept {
+        auto& notifications = c.handle_->notifications();
+        if (notifications.empty()) {
+            return {};
+        }
+        auto n = std::move(notifications.front());
+        notifications.pop_front();
+        return notify {std::move(n.channel), std::move(n.payload), n.pid};
+    }
+
+private:
+    // The socket may be rebound to another io_context, which resets its mode flags.
+    asio::posix::stream_descriptor& socket() noexcept {
+        if (!socket_.non_blocking()) {
+            error_code ec;
+            socket_.non_blocking(true, ec);
+        }
+        return socket_;
+    }
+};
+
+} // namespace ozo::wire
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <ozo/connector.h>
+#include <ozo/connection.h>
+#include <ozo/impl/async_connect.h>
+#include <ozo/ext/std/shared_ptr.h>
+#include <ozo/wire/connection.h>
+
+namespace ozo::wire {
+
+/**
+ * @brief Native protocol connection information
+ * @ingroup group-wire
+ *
+ * #ConnectionSource which establishes `ozo::wire::connection_impl` connections.
+ * It is a drop-in replacement for `ozo::connection_info`, but the connection
+ * string must be in keyword/value form. Only trust, password and md5
+ * authentication methods are supported, SSL is not supported.
+ *
+ * @tparam OidMap --- OidMap type which defines custom types should be used within this connection.
+ * @tparam Statistics --- statistics type which defines statistics is collected for this connection.
+ */
+template <
+    typename OidMap = empty_oid_map,
+    typename Statistics = no_statistics>
+class connection_info {
+    std::string conn_str;
+    Statistics statistics;
+
+public:
+    using connection = connection_impl<OidMap, Statistics>;
+    using connection_type = std::shared_ptr<connection>;
+
+    connection_info(std::string conn_str, const OidMap& = OidMap{}, Statistics statistics = Statistics{})
+            : conn_str(std::move(conn_str)), statistics(std::move(statistics)) {
+    }
+
+    template <typename TimeConstraint, typename Handler>
+    void operator ()(io_context& io, TimeConstraint t, Handler&& handler) const {
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        impl::async_connect(conn_str, t, std::make_shared<connection>(io, statistics),
+            std::forward<Handler>(handler));
+    }
+
+    auto operator [](io_context& io) const & {
+        return connection_provider(*this, io);
+    }
+
+    auto operator [](io_context& io) && {
+        return connection_provider(std::move(*this), io);
+    }
+};
+
+/**
+ * @brief Constructs `ozo::wire::connection_info` #ConnectionSource.
+ * @ingroup group-wire
+ *
+ * @param conn_str --- keyword/value connection string.
+ * @param OidMap --- oid map for user defined types.
+ * @param statistics --- statistics to collect for a connection.
+ * @return `ozo::wire::connection_info` specialization.
+ */
+template <typename OidMap = empty_oid_map, typename Statistics = no_statistics>
+inline auto make_connection_info(std::string conn_str, const OidMap& oid_map = OidMap{},
+        Statistics statistics = Statistics{}) {
+    return connection_info{std::move(conn_str), oid_map, statistics};
+}
+
+static_assert(Connection<connection_info<>::connection_type>, "is not a Connection");
+static_assert(ConnectionProvider<decltype(std::declval<connection_info<>>()[std::declval<io_context&>()])>, "is not a ConnectionProvider");
+
+} // namespace ozo::wire
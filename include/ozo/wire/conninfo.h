@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cctype>
+#include <cstdlib>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace ozo::wire {
+
+/**
+ * Connection parameters parsed from a keyword/value connection string.
+ */
+struct conninfo {
+    std::string host;
+    std::string port;
+    std::string user;
+    std::string password;
+    std::string dbname;
+    std::string sslmode;
+    std::map<std::string, std::string> options; //!< additional run-time parameters for the startup message
+
+    /**
+     * Path of the Unix-domain socket if host is a directory, empty string otherwise.
+     */
+    std::string unix_socket_path() const {
+        if (host.empty() || host.front() != '/') {
+            return {};
+        }
+        return host + "/.s.PGSQL." + port;
+    }
+};
+
+namespace detail {
+
+inline std::string getenv_or(const char* name, std::string_view fallback) {
+    if (const char* v = std::getenv(name)) {
+        return v;
+    }
+    return std::string(fallback);
+}
+
+inline void skip_spaces(std::string_view& s) noexcept {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) {
+        s.remove_prefix(1);
+    }
+}
+
+inline std::optional<std::string> parse_conninfo_value(std::string_view& s) {
+    std::string value;
+    if (!s.empty() && s.front() == '\'') {
+        s.remove_prefix(1);
+        while (!s.empty() && s.front() != '\'') {
+            if (s.front() == '\\') {
+                s.remove_prefix(1);
+                if (s.empty()) {
+                    return std::nullopt;
+                }
+            }
+            value.push_back(s.front());
+            s.remove_prefix(1);
+        }
+        if (s.empty()) {
+            return std::nullopt;
+        }
+        s.remove_prefix(1);
+        return value;
+    }
+    while (!s.empty() && !std::isspace(static_cast<unsigned char>(s.front()))) {
+        if (s.front() == '\\') {
+            s.remove_prefix(1);
+            if (s.empty()) {
+                return std::nullopt;
+            }
+        }
+        value.push_back(s.front());
+        s.remove_prefix(1);
+    }
+    return value;
+}
+
+} // namespace detail
+
+/**
+ * Parses [keyword/value connection string](https://www.postgresql.org/docs/current/libpq-connect.html#LIBPQ-CONNSTRING)
+ * like `"host=localhost port=5432 user=postgres"`. Missing parameters are taken from the
+ * libpq environment variables `PGHOST`, `PGPORT`, `PGUSER`, `PGPASSWORD` and `PGDATABASE`.
+ * Connection URIs are not supported.
+ *
+ * @return parsed parameters or `std::nullopt` if the string is malformed.
+ */
+inline std::optional<conninfo> parse_conninfo(std::string_view s) {
+    std::map<std::string, std::string> params;
+    for (detail::skip_spaces(s); !s.empty(); detail::skip_spaces(s)) {
+        const auto eq = s.find('=');
+        if (eq == s.npos) {
+            return std::nullopt;
+        }
+        std::string_view key = s.substr(0, eq);
+        while (!key.empty() && std::isspace(static_cast<unsigned char>(key.back()))) {
+            key.remove_suffix(1);
+        }
+        if (key.empty()) {
+            return std::nullopt;
+        }
+        s.remove_prefix(eq + 1);
+        detail::skip_spaces(s);
+        auto value = detail::parse_conninfo_value(s);
+        if (!value) {
+            return std::nullopt;
+        }
+        params[std::string(key)] = std::move(*value);
+    }
+
+    const auto take = [&] (const char* key, const char* env, std::string_view fallback) {
+        const auto i = params.find(key);
+        if (i == params.end()) {
+            return detail::getenv_or(env, fallback);
+        }
+        auto v = std::move(i->second);
+        params.erase(i);
+        return v;
+    };
+
+    conninfo retval;
+    retval.host = take("host", "PGHOST", "localhost");
+    if (const auto i = params.find("hostaddr"); i != params.end()) {
+        retval.host = std::move(i->second);
+        params.erase(i);
+    }
+    retval.port = take("port", "PGPORT", "5432");
+    retval.user = take("user", "PGUSER", detail::getenv_or("USER", "postgres"));
+    retval.password = take("password", "PGPASSWORD", "");
+    retval.dbname = take("dbname", "PGDATABASE", retval.user);
+    retval.sslmode = take("sslmode", "PGSSLMODE", "disable");
+
+    for (const char* key : {"application_name", "options", "client_encoding"}) {
+        if (const auto i = params.find(key); i != params.end()) {
+            retval.options.emplace(key, std::move(i->second));
+        }
+    }
+    return retval;
+}
+
+} // namespace ozo::wire
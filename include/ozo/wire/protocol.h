@@ -0,0 +1,264 @@
+#pragma once
+
+#include <ozo/error.h>
+#include <ozo/type_traits.h>
+#include <ozo/detail/endian.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @defgroup group-wire Native protocol
+ * @brief PostgreSQL frontend/backend protocol v3 implementation.
+ *
+ * This is an alternative to the libpq based connection. It speaks the
+ * [protocol](https://www.postgresql.org/docs/current/protocol.html) directly
+ * over the connection socket.
+ */
+
+namespace ozo::wire {
+
+/**
+ * Protocol version 3.0 number which is sent within the startup message.
+ */
+constexpr std::int32_t protocol_version = 196608;
+
+/**
+ * Size of the message type byte and the message length field
+ * of a backend message header.
+ */
+constexpr std::size_t message_header_size = 5;
+
+namespace frontend {
+
+/**
+ * Frontend messages serializer. Appends messages to the given buffer,
+ * each message length is back-patched when the message is completed.
+ */
+class writer {
+public:
+    explicit writer(std::vector<char>& out) noexcept : out_(out) {}
+
+    writer& begin(char type) {
+        out_.push_back(type);
+        return begin();
+    }
+
+    writer& begin() {
+        start_ = out_.size();
+        return int32(0);
+    }
+
+    writer& end() {
+        const auto length = static_cast<std::int32_t>(out_.size() - start_);
+        const auto v = ozo::detail::convert_to_big_endian(length);
+        std::memcpy(out_.data() + start_, &v, sizeof(v));
+        return *this;
+    }
+
+    writer& byte(char v) {
+        out_.push_back(v);
+        return *this;
+    }
+
+    writer& int16(std::int16_t v) {
+        return raw(ozo::detail::convert_to_big_endian(v));
+    }
+
+    writer& int32(std::int32_t v) {
+        return raw(ozo::detail::convert_to_big_endian(v));
+    }
+
+    writer& bytes(const char* data, std::size_t size) {
+        out_.insert(out_.end(), data, data + size);
+        return *this;
+    }
+
+    writer& string(std::string_view v) {
+        return bytes(v.data(), v.size()).byte('\0');
+    }
+
+private:
+    template <typename T>
+    writer& raw(T v) {
+        return bytes(reinterpret_cast<const char*>(&v), sizeof(v));
+    }
+
+    std::vector<char>& out_;
+    std::size_t start_ = 0;
+};
+
+/**
+ * StartupMessage with the given parameters name-value pairs.
+ */
+template <typename Params>
+inline void write_startup(std::vector<char>& out, const Params& params) {
+    writer w{out};
+    w.begin().int32(protocol_version);
+    for (const auto& [name, value] : params) {
+        w.string(name).string(value);
+    }
+    w.byte('\0').end();
+}
+
+/**
+ * PasswordMessage, used for cleartext and md5 authentication.
+ */
+inline void write_password(std::vector<char>& out, std::string_view password) {
+    writer{out}.begin('p').string(password).end();
+}
+
+/**
+ * Simple query protocol Query message.
+ */
+inline void write_query(std::vector<char>& out, std::string_view text) {
+    writer{out}.begin('Q').string(text).end();
+}
+
+inline void write_sync(std::vector<char>& out) {
+    writer{out}.begin('S').end();
+}
+
+inline void write_terminate(std::vector<char>& out) {
+    writer{out}.begin('X').end();
+}
+
+/**
+ * Extended query protocol messages sequence for a single statement:
+ * Parse, Bind, Describe and Execute for the unnamed statement and portal
+ * followed by Sync. All the result columns are requested in binary format.
+ * The arguments have the same meaning as for `PQsendQueryParams`.
+ */
+inline void write_extended_query(std::vector<char>& out, const char* text, int params_count,
+        const oid_t* types, const char* const* values, const int* lengths, const int* formats) {
+    writer w{out};
+
+    w.begin('P').string("").string(text).int16(static_cast<std::int16_t>(params_count));
+    for (int i = 0; i < params_count; ++i) {
+        w.int32(static_cast<std::int32_t>(types[i]));
+    }
+    w.end();
+
+    w.begin('B').string("").string("").int16(static_cast<std::int16_t>(params_count));
+    for (int i = 0; i < params_count; ++i) {
+        w.int16(static_cast<std::int16_t>(formats[i]));
+    }
+    w.int16(static_cast<std::int16_t>(params_count));
+    for (int i = 0; i < params_count; ++i) {
+        if (values[i] == nullptr) {
+            w.int32(-1);
+        } else {
+            w.int32(lengths[i]).bytes(values[i], static_cast<std::size_t>(lengths[i]));
+        }
+    }
+    w.int16(1).int16(1);
+    w.end();
+
+    w.begin('D').byte('P').string("").end();
+    w.begin('E').string("").int32(0).end();
+    w.begin('S').end();
+}
+
+} // namespace frontend
+
+namespace backend {
+
+/**
+ * Backend message view. The body points into the connection read buffer
+ * and is valid while the buffer is alive.
+ */
+struct message {
+    char type;
+    const char* body;
+    std::size_t size;
+};
+
+/**
+ * Splits the input into backend messages.
+ *
+ * @param data --- input data.
+ * @param size --- input data size.
+ * @param out --- message parsed.
+ * @return number of bytes consumed by the message or 0 if the input
+ * contains no complete message.
+ * @throw system_error with `error::unexpected_eof` on malformed message length.
+ */
+inline std::size_t parse_message(const char* data, std::size_t size, message& out) {
+    if (size < message_header_size) {
+        return 0;
+    }
+    std::int32_t length;
+    std::memcpy(&length, data + 1, sizeof(length));
+    length = static_cast<std::int32_t>(ozo::detail::convert_from_big_endian(length));
+    if (length < 4) {
+        throw system_error(error::unexpected_eof);
+    }
+    const auto total = static_cast<std::size_t>(length) + 1;
+    if (size < total) {
+        return 0;
+    }
+    out = message{data[0], data + message_header_size, total - message_header_size};
+    return total;
+}
+
+/**
+ * Backend message body reader. Every read is bounds checked.
+ */
+class reader {
+public:
+    explicit reader(const message& m) noexcept : pos_(m.body), end_(m.body + m.size) {}
+
+    char byte() {
+        require(1);
+        return *pos_++;
+    }
+
+    std::int16_t int16() {
+        return static_cast<std::int16_t>(ozo::detail::convert_from_big_endian(raw<std::int16_t>()));
+    }
+
+    std::int32_t int32() {
+        return static_cast<std::int32_t>(ozo::detail::convert_from_big_endian(raw<std::int32_t>()));
+    }
+
+    const char* bytes(std::size_t size) {
+        require(size);
+        return std::exchange(pos_, pos_ + size);
+    }
+
+    std::string_view string() {
+        const auto zero = static_cast<const char*>(std::memchr(pos_, '\0', remaining()));
+        if (!zero) {
+            throw system_error(error::unexpected_eof);
+        }
+        const std::string_view retval(pos_, static_cast<std::size_t>(zero - pos_));
+        pos_ = zero + 1;
+        return retval;
+    }
+
+    std::size_t remaining() const noexcept { return static_cast<std::size_t>(end_ - pos_); }
+
+private:
+    void require(std::size_t size) const {
+        if (remaining() < size) {
+            throw system_error(error::unexpected_eof);
+        }
+    }
+
+    template <typename T>
+    T raw() {
+        T v;
+        std::memcpy(&v, bytes(sizeof(T)), sizeof(T));
+        return v;
+    }
+
+    const char* pos_;
+    const char* end_;
+};
+
+} // namespace backend
+
+} // namespace ozo::wire
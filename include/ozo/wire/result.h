@@ -0,0 +1,126 @@
+#pragma once
+
+#include <ozo/error.h>
+#include <ozo/result.h>
+#include <ozo/impl/result.h>
+
+#include <libpq-fe.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ozo::wire {
+
+/**
+ * Read buffer chunk. Chunks are never reallocated so the data of the rows
+ * received may be referenced directly by results.
+ */
+using buffer = std::vector<char>;
+using buffer_ptr = std::shared_ptr<buffer>;
+
+/**
+ * Result of a statement received via the native protocol.
+ *
+ * Rows are not copied from the connection read buffer: each cell refers
+ * to the data inside a buffer chunk and the result shares ownership of
+ * all the chunks it refers to.
+ */
+struct pg_result {
+    struct column {
+        std::string name;
+        oid_t type = null_oid;
+        impl::result_format format = impl::result_format::text;
+    };
+
+    struct cell {
+        const char* data = nullptr;
+        std::int32_t length = -1;
+    };
+
+    ExecStatusType status = PGRES_EMPTY_QUERY;
+    std::vector<column> columns;
+    std::vector<cell> cells;
+    std::vector<std::shared_ptr<const buffer>> buffers;
+    std::string command_tag;
+    std::string sqlstate;
+    std::string message;
+
+    int nfields() const noexcept { return static_cast<int>(columns.size()); }
+
+    int ntuples() const noexcept {
+        return columns.empty() ? 0 : static_cast<int>(cells.size() / columns.size());
+    }
+
+    const cell& at(int row, int column) const noexcept {
+        return cells[static_cast<std::size_t>(row) * columns.size() + static_cast<std::size_t>(column)];
+    }
+
+    void hold(const buffer_ptr& chunk) {
+        if (buffers.empty() || buffers.back() != chunk) {
+            buffers.push_back(chunk);
+        }
+    }
+};
+
+inline oid_t pq_field_type(const pg_result& res, int column) noexcept {
+    return res.columns[column].type;
+}
+
+inline impl::result_format pq_field_format(const pg_result& res, int column) noexcept {
+    return res.columns[column].format;
+}
+
+inline const char* pq_get_value(const pg_result& res, int row, int column) noexcept {
+    const auto& v = res.at(row, column);
+    return v.data ? v.data : "";
+}
+
+inline std::size_t pq_get_length(const pg_result& res, int row, int column) noexcept {
+    const auto& v = res.at(row, column);
+    return v.length < 0 ? 0 : static_cast<std::size_t>(v.length);
+}
+
+inline bool pq_get_isnull(const pg_result& res, int row, int column) noexcept {
+    return res.at(row, column).length < 0;
+}
+
+inline int pq_field_number(const pg_result& res, const char* name) noexcept {
+    for (std::size_t i = 0; i < res.columns.size(); ++i) {
+        if (res.columns[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+inline int pq_nfields(const pg_result& res) noexcept {
+    return res.nfields();
+}
+
+inline int pq_ntuples(const pg_result& res) noexcept {
+    return res.ntuples();
+}
+
+inline ExecStatusType pq_result_status(const pg_result& res) noexcept {
+    return res.status;
+}
+
+inline error_code pq_result_error(const pg_result& res) noexcept {
+    if (!res.sqlstate.empty()) {
+        return sqlstate::make_error_code(std::strtol(res.sqlstate.c_str(), NULL, 36));
+    }
+    return error::no_sql_state_found;
+}
+
+using result_handle = std::unique_ptr<pg_result>;
+
+/**
+ * @brief Database raw result of the native protocol connection.
+ * @ingroup group-wire
+ */
+using result = ozo::basic_result<result_handle>;
+
+} // namespace ozo::wire
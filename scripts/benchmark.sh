@@ -40,5 +40,23 @@ docker-compose run \
     bash \
     -exc '/code/scripts/wait_postgres.sh; ${BASE_BUILD_DIR}/clang_release/benchmarks/ozo_benchmark_performance "host=${POSTGRES_HOST} user=${POSTGRES_USER} dbname=${POSTGRES_DB} password=${POSTGRES_PASSWORD}"'
 
+echo 'ozo performance benchmark against fake server'
+
+docker-compose run \
+    --rm \
+    --user "$(id -u):$(id -g)" \
+    ozo_build_with_pg_tests \
+    bash \
+    -exc '${BASE_BUILD_DIR}/clang_release/benchmarks/ozo_benchmark_performance fake'
+
+echo 'ozo codec benchmark'
+
+docker-compose run \
+    --rm \
+    --user "$(id -u):$(id -g)" \
+    ozo_build_with_pg_tests \
+    bash \
+    -exc '${BASE_BUILD_DIR}/clang_release/benchmarks/ozo_benchmark_codec'
+
 docker-compose stop ozo_postgres
 docker-compose rm -f ozo_postgres
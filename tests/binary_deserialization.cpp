@@ -2,6 +2,8 @@
 
 #include <ozo/io/array.h>
 #include <ozo/io/recv.h>
+#include <ozo/borrowed_rows.h>
+#include <ozo/pg/jsonb.h>
 #include <ozo/ext/std.h>
 #include <ozo/ext/boost/uuid.h>
 
@@ -154,6 +156,76 @@ TEST_F(recv, should_convert_TEXTOID_to_std_string) {
     EXPECT_EQ("test", got);
 }
 
+TEST_F(recv, should_convert_TEXTOID_to_std_string_view_pointing_to_value_data) {
+    const char* bytes = "test";
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(TEXTOID));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::string_view got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_EQ(got.data(), bytes);
+    EXPECT_EQ(got.size(), 4u);
+}
+
+TEST_F(recv, should_convert_BYTEAOID_to_pg_bytea_view_pointing_to_value_data) {
+    const char* bytes = "test";
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(BYTEAOID));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    ozo::pg::bytea_view got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_EQ(got.get().data(), bytes);
+    EXPECT_EQ(got.get().size(), 4u);
+}
+
+TEST_F(recv, should_convert_JSONBOID_to_pg_jsonb_view_pointing_to_value_data_after_version) {
+    const char bytes[] = {1, '{', '}'};
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(JSONBOID));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof(bytes)));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    ozo::pg::jsonb_view got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_EQ(got.raw_string().data(), bytes + 1);
+    EXPECT_EQ(got.raw_string(), "{}");
+}
+
+TEST_F(recv, should_convert_TEXTARRAYOID_to_std_vector_of_std_string_view_pointing_to_value_data) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x00, 0x19, // Oid
+        0x00, 0x00, 0x00, 0x02, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x02, // string size
+        'a', 'b',
+        0x00, 0x00, 0x00, 0x01, // string size
+        'c',
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(TEXTARRAYOID));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof(bytes)));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::vector<std::string_view> got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_THAT(got, ElementsAre("ab", "c"));
+    EXPECT_EQ(got[0].data(), bytes + 24);
+}
+
+TEST_F(recv, should_throw_when_std_string_view_exceeds_value_data) {
+    const char* bytes = "test";
+    std::string_view got;
+    ozo::detail::istreambuf_view sbuf(bytes, 4);
+    ozo::istream s(&sbuf);
+    EXPECT_THROW(ozo::recv(s, TEXTOID, 5, oid_map, got), ozo::system_error);
+}
+
 TEST_F(recv, should_convert_TEXTOID_to_a_nullable_wrapped_std_string_unwrapping_that_nullable) {
     const char* bytes = "test";
     EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(TEXTOID));
@@ -735,6 +807,50 @@ TEST_F(recv_result, send_returns_result_then_result_requested) {
     EXPECT_EQ(got.size(), 2u);
 }
 
+TEST_F(recv_result, should_keep_result_with_borrowed_rows) {
+    const char* bytes = "test";
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(TEXTOID));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    ozo::borrowed_rows<std::tuple<std::string_view>, ozo::basic_result<pg_result_mock*>> got;
+    ozo::recv_result(res, oid_map, std::ref(got));
+    EXPECT_EQ(got.result().handle(), &mock);
+    ASSERT_EQ(got.size(), 2u);
+    EXPECT_EQ(std::get<0>(got[0]).data(), bytes);
+    EXPECT_EQ(std::get<0>(got[1]), "test");
+}
+
+struct hana_adapted_view_row {
+    BOOST_HANA_DEFINE_STRUCT(hana_adapted_view_row,
+        (std::string_view, text),
+        (int32_t, digit)
+    );
+};
+
+TEST(has_borrowed_views, should_detect_views_in_rows) {
+    EXPECT_TRUE(ozo::detail::has_borrowed_views<std::string_view>());
+    EXPECT_TRUE(ozo::detail::has_borrowed_views<ozo::pg::bytea_view>());
+    EXPECT_TRUE(ozo::detail::has_borrowed_views<ozo::pg::jsonb_view>());
+    EXPECT_TRUE(ozo::detail::has_borrowed_views<__OZO_STD_OPTIONAL<std::string_view>>());
+    EXPECT_TRUE(ozo::detail::has_borrowed_views<std::vector<std::string_view>>());
+    EXPECT_TRUE((ozo::detail::has_borrowed_views<std::tuple<std::int32_t, ozo::pg::jsonb_view>>()));
+    EXPECT_TRUE(ozo::detail::has_borrowed_views<hana_adapted_view_row>());
+}
+
+TEST(has_borrowed_views, should_not_detect_views_in_owning_rows) {
+    EXPECT_FALSE(ozo::detail::has_borrowed_views<std::string>());
+    EXPECT_FALSE(ozo::detail::has_borrowed_views<ozo::pg::jsonb>());
+    EXPECT_FALSE(ozo::detail::has_borrowed_views<std::vector<std::string>>());
+    EXPECT_FALSE((ozo::detail::has_borrowed_views<std::tuple<std::int32_t, std::string>>()));
+    EXPECT_FALSE(ozo::detail::has_borrowed_views<fusion_adapted_test_result>());
+    EXPECT_FALSE(ozo::detail::has_borrowed_views<hana_adapted_test_result>());
+}
+
 TEST_F(recv, should_convert_UUIDOID_to_uuid) {
     const char bytes[] = {
         0x12, 0x34, 0x56, 0x78,
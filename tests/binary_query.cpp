@@ -80,6 +80,11 @@ TEST_F(binary_query_formats, format_of_the_param_should_be_equal_to_1) {
     EXPECT_EQ(query.formats()[0], 1);
 }
 
+TEST_F(binary_query_formats, for_each_param_should_be_equal_to_1) {
+    const auto query = make_binary_query("", hana::make_tuple(std::int16_t(), std::string("text"), 0.5));
+    EXPECT_THAT(std::vector<int>(query.formats(), query.formats() + 3), ElementsAre(1, 1, 1));
+}
+
 struct binary_query_lengths : Test {};
 
 TEST_F(binary_query_lengths, should_be_equal_to_parameter_binary_serialized_data_size) {
@@ -97,6 +102,27 @@ TEST_F(binary_query_lengths, for_empty_optional_should_be_minus_one) {
     EXPECT_EQ(query.lengths()[0], -1);
 }
 
+TEST_F(binary_query_lengths, for_std_vector_with_null_items_should_be_equal_to_sent_data_size) {
+    const auto query = make_binary_query("", hana::make_tuple(
+        std::vector<__OZO_STD_OPTIONAL<std::int64_t>>({std::int64_t(1), __OZO_NULLOPT})));
+    EXPECT_EQ(query.lengths()[0], 12 + 8 + (4 + 8) + 4);
+}
+
+TEST_F(binary_query_lengths, for_static_size_params_should_be_shared_by_queries) {
+    const auto first = make_binary_query("", hana::make_tuple(std::int16_t(1), std::int64_t(2)));
+    const auto second = make_binary_query("", hana::make_tuple(std::int16_t(3), std::int64_t(4)));
+    EXPECT_EQ(first.lengths(), second.lengths());
+    EXPECT_EQ(first.types(), second.types());
+    EXPECT_THAT(std::vector<int>(first.lengths(), first.lengths() + 2), ElementsAre(2, 8));
+}
+
+TEST_F(binary_query_lengths, for_dynamic_size_params_should_be_set_per_query) {
+    const auto first = make_binary_query("", hana::make_tuple(std::int16_t(1), std::string("a")));
+    const auto second = make_binary_query("", hana::make_tuple(std::int16_t(3), std::string("bcd")));
+    EXPECT_THAT(std::vector<int>(first.lengths(), first.lengths() + 2), ElementsAre(2, 1));
+    EXPECT_THAT(std::vector<int>(second.lengths(), second.lengths() + 2), ElementsAre(2, 3));
+}
+
 struct binary_query_values : Test {};
 
 TEST_F(binary_query_values, for_string_value_should_be_equal_to_input) {
@@ -166,6 +192,12 @@ TEST_F(binary_query_values, for_not_null_std_weak_ptr_value_should_be_equal_to_b
         ElementsAre('s', 't', 'r', 'i', 'n', 'g'));
 }
 
+TEST_F(binary_query_values, for_static_size_params_should_be_equal_to_binary_representation) {
+    const auto query = make_binary_query("", hana::make_tuple(std::int16_t(0x0102), std::int64_t(0x0304)));
+    EXPECT_THAT(std::vector<char>(query.values()[0], query.values()[0] + 2), ElementsAre(1, 2));
+    EXPECT_THAT(std::vector<char>(query.values()[1], query.values()[1] + 8), ElementsAre(0, 0, 0, 0, 0, 0, 3, 4));
+}
+
 TEST_F(binary_query_values, for_std_reference_wrapper_value_should_be_equal_to_binary_representation) {
     const auto value = std::string("string");
     const auto query = make_binary_query("", hana::make_tuple(std::cref(value)));
@@ -173,4 +205,32 @@ TEST_F(binary_query_values, for_std_reference_wrapper_value_should_be_equal_to_b
         ElementsAre('s', 't', 'r', 'i', 'n', 'g'));
 }
 
+struct binary_query_param_ref : Test {};
+
+TEST_F(binary_query_param_ref, value_should_point_to_referenced_std_string_data) {
+    const std::string value("string");
+    const auto query = make_binary_query("", hana::make_tuple(ozo::ref(value)));
+    EXPECT_EQ(query.values()[0], value.data());
+    EXPECT_EQ(query.lengths()[0], 6);
+    EXPECT_EQ(query.types()[0], ozo::type_oid<std::string>(ozo::empty_oid_map{}));
+}
+
+TEST_F(binary_query_param_ref, value_should_point_to_referenced_pg_bytea_data) {
+    const ozo::pg::bytea value({1, 2, 3});
+    const auto query = make_binary_query("", hana::make_tuple(ozo::ref(value)));
+    EXPECT_EQ(query.values()[0], value.get().data());
+    EXPECT_EQ(query.lengths()[0], 3);
+    EXPECT_EQ(query.types()[0], ozo::type_oid<ozo::pg::bytea>(ozo::empty_oid_map{}));
+}
+
+TEST_F(binary_query_param_ref, with_other_params_should_not_affect_their_values) {
+    const std::string value("ref");
+    const auto query = make_binary_query("", hana::make_tuple(std::string("first"), ozo::ref(value),
+        std::int16_t(0x0102)));
+    EXPECT_THAT(std::vector<char>(query.values()[0], query.values()[0] + 5), ElementsAre('f', 'i', 'r', 's', 't'));
+    EXPECT_EQ(query.values()[1], value.data());
+    EXPECT_THAT(std::vector<char>(query.values()[2], query.values()[2] + 2), ElementsAre(1, 2));
+    EXPECT_THAT(std::vector<int>(query.lengths(), query.lengths() + 3), ElementsAre(5, 3, 2));
+}
+
 } // namespace
@@ -103,6 +103,43 @@ TEST_F(send, with_std_array_of_int_should_store_with_one_dimension_array_header_
     }));
 }
 
+TEST_F(send, with_std_vector_of_std_optional_std_string_should_store_items_with_sizes) {
+    ozo::send(os, oid_map, std::vector<__OZO_STD_OPTIONAL<std::string>>({std::string("abc"), __OZO_NULLOPT}));
+    EXPECT_EQ(buffer, std::vector<char>({
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 0x19,
+        0, 0, 0, 2,
+        0, 0, 0, 0,
+        0, 0, 0, 3,
+        'a', 'b', 'c',
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF),
+    }));
+}
+
+TEST_F(send, with_std_vector_of_std_string_and_not_positionable_ostream_should_store_items_with_sizes) {
+    struct appending_buf : std::streambuf {
+        std::vector<char>& buffer;
+        appending_buf(std::vector<char>& buffer) : buffer(buffer) {}
+        int_type overflow(int_type ch) override {
+            buffer.push_back(static_cast<char>(ch));
+            return ch;
+        }
+    } abuf{buffer};
+    ozo::ostream appending_ostream{&abuf};
+    ozo::send(appending_ostream, oid_map, std::vector<std::string>({"ab", ""}));
+    EXPECT_EQ(buffer, std::vector<char>({
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 0x19,
+        0, 0, 0, 2,
+        0, 0, 0, 0,
+        0, 0, 0, 2,
+        'a', 'b',
+        0, 0, 0, 0,
+    }));
+}
+
 TEST_F(send, should_send_nothing_for_std_nullptr_t) {
     ozo::send(os, oid_map, nullptr);
     EXPECT_TRUE(buffer.empty());
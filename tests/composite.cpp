@@ -1,5 +1,7 @@
 #include "result_mock.h"
 #include <ozo/ext/std/tuple.h>
+#include <ozo/ext/std/vector.h>
+#include <ozo/io/array.h>
 #include <ozo/io/composite.h>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -122,6 +124,28 @@ TEST_F(send_composite, should_store_std_tuple_with_number_of_fields_and_fields_f
     }));
 }
 
+TEST_F(send_composite, should_store_nested_std_vector_with_its_size) {
+    const auto v = std::make_tuple(std::vector<std::string>({"AB"}), std::int16_t(0x0102));
+    ozo::send(os, oid_map, v);
+    EXPECT_EQ(buffer, std::vector<char>({
+        0x00, 0x00, 0x00, 0x02, // Number of members
+                                // ---- std::get<0>(v) frame ---
+        0x00, 0x00, 0x03, char(0xF1), // Oid:  TEXTARRAYOID
+        0x00, 0x00, 0x00, 0x1A, //   size: 26
+        0x00, 0x00, 0x00, 0x01, //   dimensions count: 1
+        0x00, 0x00, 0x00, 0x00, //   data offset: 0
+        0x00, 0x00, 0x00, 0x19, //   element Oid: TEXTOID
+        0x00, 0x00, 0x00, 0x01, //   dimension size: 1
+        0x00, 0x00, 0x00, 0x00, //   dimension index: 0
+        0x00, 0x00, 0x00, 0x02, //   item size: 2
+        'A' , 'B' ,             //   item data: "AB"
+                                // ---- std::get<1>(v) frame ---
+        0x00, 0x00, 0x00, 0x15, //   Oid:  INT2OID
+        0x00, 0x00, 0x00, 0x02, //   size: 2
+        0x01, 0x02,             //   data: 01 02
+    }));
+}
+
 struct recv_composite : Test {
     StrictMock<ozo::tests::pg_result_mock>  mock{};
     ozo::value<ozo::tests::pg_result_mock>  value{{&mock, 0, 0}};
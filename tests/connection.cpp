@@ -290,4 +290,23 @@ TEST(ConnectionProvider, should_return_false_for_non_connection_provider_type){
     EXPECT_FALSE(ozo::ConnectionProvider<int>);
 }
 
+struct provider_without_executor {
+    using connection_type = connection_ptr<>;
+
+    template <typename TimeConstraint, typename Handler>
+    void async_get_connection(TimeConstraint, Handler&&) const {}
+};
+
+TEST(get_provider_executor, should_return_executor_of_connection_for_connection) {
+    StrictMock<executor_gmock> executor;
+    io_context io {executor};
+    auto conn = std::make_shared<connection<>>(io);
+    EXPECT_EQ(ozo::get_provider_executor(conn), io.get_executor());
+}
+
+TEST(get_provider_executor, should_return_system_executor_for_provider_without_executor) {
+    const provider_without_executor provider;
+    EXPECT_TRUE((std::is_same_v<decltype(ozo::get_provider_executor(provider)), asio::system_executor>));
+}
+
 } //namespace
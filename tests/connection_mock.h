@@ -44,6 +44,16 @@ inline error_code pq_result_error(const pg_result& res) noexcept {
     return res.error;
 }
 
+// The mock result has no rows and no fields
+inline int pq_ntuples(const pg_result&) noexcept { return 0; }
+inline int pq_nfields(const pg_result&) noexcept { return 0; }
+inline ozo::oid_t pq_field_type(const pg_result&, int) noexcept { return ozo::null_oid; }
+inline ozo::impl::result_format pq_field_format(const pg_result&, int) noexcept { return ozo::impl::result_format::binary; }
+inline const char* pq_get_value(const pg_result&, int, int) noexcept { return nullptr; }
+inline std::size_t pq_get_length(const pg_result&, int, int) noexcept { return 0; }
+inline bool pq_get_isnull(const pg_result&, int, int) noexcept { return true; }
+inline int pq_field_number(const pg_result&, const char*) noexcept { return -1; }
+
 using ozo::empty_oid_map;
 
 struct connection_mock {
@@ -53,6 +63,9 @@ struct connection_mock {
     MOCK_CONST_METHOD0(is_busy, bool());
     MOCK_METHOD0(flush_output, ozo::impl::query_state());
     MOCK_METHOD0(get_result, boost::optional<pg_result>());
+    MOCK_METHOD0(enter_pipeline_mode, int());
+    MOCK_METHOD0(exit_pipeline_mode, int());
+    MOCK_METHOD0(pipeline_sync, int());
 
     MOCK_CONST_METHOD0(connect_poll, int());
     MOCK_METHOD1(start_connection, ozo::error_code(const std::string&));
@@ -99,8 +112,16 @@ namespace ozo::tests {
 
 static_assert(Query<fake_query>, "fake_query is not a Query");
 
-template <typename OidMap = empty_oid_map>
-struct connection {
+template <typename Statistics>
+struct connection_statistics_member {
+    Statistics statistics_;
+};
+
+template <>
+struct connection_statistics_member<ozo::no_statistics> {};
+
+template <typename OidMap = empty_oid_map, typename Statistics = ozo::no_statistics>
+struct connection : connection_statistics_member<Statistics> {
     using handle_type = std::unique_ptr<native_handle>;
 
     handle_type handle_;
@@ -135,6 +156,18 @@ struct connection {
         return c.mock_->get_result();
     }
 
+    friend int pq_enter_pipeline_mode(connection& c) noexcept {
+        return c.mock_->enter_pipeline_mode();
+    }
+
+    friend int pq_exit_pipeline_mode(connection& c) noexcept {
+        return c.mock_->exit_pipeline_mode();
+    }
+
+    friend int pq_pipeline_sync(connection& c) noexcept {
+        return c.mock_->pipeline_sync();
+    }
+
     friend int pq_connect_poll(connection& c) {
         return c.mock_->connect_poll();
     }
@@ -191,6 +224,7 @@ template <typename OidMap = empty_oid_map>
 inline auto make_connection(connection_mock& mock, io_context& io,
         stream_descriptor_mock& socket_mock, steady_timer_mock& timer, OidMap oid_map = OidMap{}) {
     return std::make_shared<connection<OidMap>>(connection<OidMap>{
+            {},
             std::make_unique<native_handle>(native_handle::bad),
             stream_descriptor{io, socket_mock},
             oid_map,
@@ -0,0 +1,392 @@
+#include <connection_mock.h>
+
+#include <ozo/connection_multiplexer.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+ozo::connection_multiplexer_config make_config(std::size_t capacity) {
+    ozo::connection_multiplexer_config config;
+    config.capacity = capacity;
+    config.connect_timeout = std::chrono::seconds(1);
+    return config;
+}
+
+ozo::connection_multiplexer_config make_config(std::size_t capacity, ozo::time_traits::duration batch_window,
+        std::size_t batch_size = 0) {
+    auto config = make_config(capacity);
+    config.batch_window = batch_window;
+    config.batch_size = batch_size;
+    return config;
+}
+
+struct connection_multiplexer : Test {
+    ozo::io_context io;
+    ozo::connection_info<> conn_info {"host=localhost"};
+    ozo::impl::multiplexer_state<ozo::connection_info<>> state {conn_info, io, make_config(2)};
+};
+
+TEST_F(connection_multiplexer, should_open_channel_on_first_select) {
+    EXPECT_EQ(state.size(), 0u);
+    EXPECT_TRUE(state.select());
+    EXPECT_EQ(state.size(), 1u);
+}
+
+TEST_F(connection_multiplexer, should_share_idle_channel) {
+    const auto first = state.select();
+    EXPECT_EQ(state.select(), first);
+    EXPECT_EQ(state.size(), 1u);
+}
+
+TEST_F(connection_multiplexer, should_not_select_reserved_channel_while_capacity_allows) {
+    const auto first = state.select();
+    first->async_pin(ozo::none, [] (ozo::error_code, auto) {});
+    const auto second = state.select();
+    EXPECT_NE(second, first);
+    EXPECT_EQ(state.size(), 2u);
+}
+
+TEST_F(connection_multiplexer, should_select_reserved_channel_when_capacity_is_exhausted) {
+    const auto first = state.select();
+    first->async_pin(ozo::none, [] (ozo::error_code, auto) {});
+    const auto second = state.select();
+    second->async_pin(ozo::none, [] (ozo::error_code, auto) {});
+    const auto third = state.select();
+    EXPECT_TRUE(third == first || third == second);
+    EXPECT_EQ(state.size(), 2u);
+}
+
+TEST_F(connection_multiplexer, copies_should_share_connections) {
+    const ozo::connection_multiplexer mux(conn_info, io);
+    const auto copy = mux;
+    copy.async_get_connection(ozo::none, [] (ozo::error_code, auto) {});
+    EXPECT_EQ(mux.size(), 1u);
+}
+
+using ozo::tests::connection_gmock;
+using ozo::tests::connection_ptr;
+using ozo::tests::make_pg_result;
+using ozo::tests::native_handle;
+using ozo::tests::pg_result;
+
+struct connection_source_mock {
+    using connection_type = connection_ptr<>;
+    using handler_type = std::function<void(ozo::error_code, connection_type)>;
+
+    handler_type* handler;
+
+    template <typename TimeConstraint, typename Handler>
+    void operator() (ozo::io_context&, TimeConstraint, Handler&& h) const {
+        *handler = std::forward<Handler>(h);
+    }
+};
+
+using channel_type = ozo::impl::multiplex_channel<connection_source_mock>;
+using handle_type = ozo::impl::multiplexed_connection<connection_source_mock>;
+
+struct multiplex_channel : Test {
+    ozo::io_context io;
+    StrictMock<connection_gmock> connection {};
+    StrictMock<ozo::tests::executor_gmock> executor {};
+    StrictMock<ozo::tests::strand_executor_service_gmock> strand_service {};
+    StrictMock<ozo::tests::stream_descriptor_gmock> socket {};
+    StrictMock<ozo::tests::steady_timer_gmock> timer {};
+    ozo::tests::io_context mock_io {executor, strand_service};
+    connection_source_mock::handler_type connect_handler;
+    std::shared_ptr<channel_type> channel = std::make_shared<channel_type>(io,
+        std::make_shared<connection_source_mock>(connection_source_mock {&connect_handler}), make_config(1));
+    std::vector<ozo::error_code> completed;
+    std::size_t processed = 0;
+
+    void connect(PGTransactionStatusType status = PQTRANS_IDLE) {
+        auto conn = ozo::tests::make_connection(connection, mock_io, socket, timer);
+        *conn->handle_ = native_handle(native_handle::good, status);
+        EXPECT_CALL(connection, set_nonblocking()).WillOnce(Return(0));
+        ASSERT_TRUE(connect_handler);
+        std::exchange(connect_handler, {})(ozo::error_code {}, std::move(conn));
+    }
+
+    handle_type acquire() {
+        handle_type retval;
+        channel->async_acquire(ozo::none, [&] (ozo::error_code ec, handle_type conn) {
+            EXPECT_FALSE(ec);
+            retval = std::move(conn);
+        });
+        run();
+        if (!retval.channel_) {
+            connect();
+            run();
+        }
+        return retval;
+    }
+
+    template <typename TimeConstraint>
+    void request(handle_type conn, TimeConstraint t) {
+        ozo::impl::async_multiplexed_request(std::move(conn), ozo::tests::fake_query {}, t,
+            [this] (auto&&, auto&) { ++processed; },
+            [this] (ozo::error_code ec, auto) { completed.push_back(ec); });
+    }
+
+    void run() {
+        io.restart();
+        io.run();
+    }
+
+    void poll() {
+        io.restart();
+        io.poll();
+    }
+
+    void expect_batch_sent(Sequence& s, std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            EXPECT_CALL(connection, send_query_params()).InSequence(s).WillOnce(Return(1));
+            EXPECT_CALL(connection, pipeline_sync()).InSequence(s).WillOnce(Return(1));
+        }
+        EXPECT_CALL(connection, flush_output()).InSequence(s).WillOnce(Return(ozo::impl::query_state::send_finish));
+        EXPECT_CALL(connection, is_busy()).InSequence(s).WillOnce(Return(true));
+        EXPECT_CALL(socket, async_read_some(_)).InSequence(s).WillOnce(Return());
+    }
+
+    void expect_results(Sequence& s, std::initializer_list<boost::optional<pg_result>> results) {
+        for (const auto& result : results) {
+            EXPECT_CALL(connection, is_busy()).InSequence(s).WillOnce(Return(false));
+            EXPECT_CALL(connection, get_result()).InSequence(s).WillOnce(Return(result));
+        }
+    }
+};
+
+TEST_F(multiplex_channel, should_send_queued_requests_in_pipeline_and_dispatch_results_in_order) {
+    handle_type conn;
+    channel->async_acquire(ozo::none, [&] (ozo::error_code, handle_type c) { conn = std::move(c); });
+    run();
+    ASSERT_TRUE(connect_handler);
+    request(handle_type {channel, nullptr}, ozo::none);
+    request(handle_type {channel, nullptr}, ozo::none);
+    run();
+    EXPECT_EQ(channel->load(), 2u);
+
+    Sequence s;
+    EXPECT_CALL(connection, enter_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, send_query_params()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, pipeline_sync()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, send_query_params()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, pipeline_sync()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, flush_output()).InSequence(s).WillOnce(Return(ozo::impl::query_state::send_finish));
+    expect_results(s, {
+        make_pg_result(PGRES_TUPLES_OK, {}), boost::none, make_pg_result(PGRES_PIPELINE_SYNC, {}),
+        make_pg_result(PGRES_FATAL_ERROR, ozo::tests::error::error), boost::none, make_pg_result(PGRES_PIPELINE_SYNC, {}),
+    });
+
+    connect();
+    run();
+
+    EXPECT_TRUE(conn.channel_);
+    EXPECT_EQ(processed, 1u);
+    EXPECT_THAT(completed, ElementsAre(ozo::error_code {}, ozo::error_code {ozo::tests::error::error}));
+    EXPECT_EQ(channel->load(), 0u);
+}
+
+TEST_F(multiplex_channel, should_complete_request_with_error_and_release_load_if_send_failed) {
+    const auto conn = acquire();
+
+    Sequence s;
+    EXPECT_CALL(connection, enter_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, send_query_params()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(connection, flush_output()).InSequence(s).WillOnce(Return(ozo::impl::query_state::send_finish));
+
+    request(conn, ozo::none);
+    run();
+
+    EXPECT_THAT(completed, ElementsAre(ozo::error_code {ozo::error::pg_send_query_params_failed}));
+    EXPECT_EQ(channel->load(), 0u);
+}
+
+TEST_F(multiplex_channel, should_complete_queued_request_with_error_on_timeout_and_release_load) {
+    channel->async_acquire(ozo::none, [] (ozo::error_code, handle_type) {});
+    run();
+    request(handle_type {channel, nullptr}, ozo::time_traits::now());
+    run();
+
+    EXPECT_THAT(completed, ElementsAre(ozo::error_code {boost::asio::error::operation_aborted}));
+
+    Sequence s;
+    EXPECT_CALL(connection, enter_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, flush_output()).InSequence(s).WillOnce(Return(ozo::impl::query_state::send_finish));
+
+    connect();
+    run();
+
+    EXPECT_EQ(channel->load(), 0u);
+}
+
+TEST_F(multiplex_channel, should_complete_acquire_with_error_when_time_constraint_expires_before_connect) {
+    std::vector<ozo::error_code> acquired;
+    channel->async_acquire(ozo::time_traits::now(), [&] (ozo::error_code ec, handle_type) { acquired.push_back(ec); });
+    run();
+    EXPECT_THAT(acquired, ElementsAre(ozo::error_code {boost::asio::error::operation_aborted}));
+}
+
+TEST_F(multiplex_channel, should_complete_pin_with_error_when_time_constraint_expires_before_requests_complete) {
+    const auto conn = acquire();
+
+    Sequence s;
+    EXPECT_CALL(connection, enter_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, send_query_params()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, pipeline_sync()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, flush_output()).InSequence(s).WillOnce(Return(ozo::impl::query_state::send_finish));
+    EXPECT_CALL(connection, is_busy()).InSequence(s).WillOnce(Return(true));
+    EXPECT_CALL(socket, async_read_some(_)).InSequence(s).WillOnce(Return());
+
+    request(conn, ozo::none);
+    run();
+
+    std::vector<ozo::error_code> pinned;
+    channel->async_pin(ozo::time_traits::now() + std::chrono::milliseconds(1),
+        [&] (ozo::error_code ec, handle_type) { pinned.push_back(ec); });
+    EXPECT_TRUE(channel->reserved());
+    run();
+
+    EXPECT_THAT(pinned, ElementsAre(ozo::error_code {boost::asio::error::operation_aborted}));
+    EXPECT_FALSE(channel->reserved());
+    EXPECT_TRUE(completed.empty());
+}
+
+TEST_F(multiplex_channel, should_share_connection_again_when_pinned_handle_is_released) {
+    acquire();
+
+    handle_type pinned;
+    channel->async_pin(ozo::none, [&] (ozo::error_code ec, handle_type conn) {
+        EXPECT_FALSE(ec);
+        pinned = std::move(conn);
+    });
+    run();
+    ASSERT_TRUE(pinned.pinned());
+    EXPECT_TRUE(channel->reserved());
+
+    pinned = handle_type {};
+    run();
+
+    EXPECT_FALSE(channel->reserved());
+    EXPECT_TRUE(channel->connected());
+}
+
+TEST_F(multiplex_channel, should_close_connection_left_in_transaction_when_pinned_handle_is_released) {
+    channel->async_acquire(ozo::none, [] (ozo::error_code, handle_type) {});
+    run();
+    connect(PQTRANS_INTRANS);
+    run();
+
+    handle_type pinned;
+    channel->async_pin(ozo::none, [&] (ozo::error_code, handle_type conn) { pinned = std::move(conn); });
+    run();
+    ASSERT_TRUE(pinned.pinned());
+
+    EXPECT_CALL(socket, close(_)).WillOnce(Return());
+    pinned = handle_type {};
+    run();
+
+    EXPECT_FALSE(channel->reserved());
+    EXPECT_FALSE(channel->connected());
+}
+
+TEST_F(multiplex_channel, should_flush_each_request_without_batch_window) {
+    const auto conn = acquire();
+
+    Sequence s;
+    EXPECT_CALL(connection, enter_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+    expect_batch_sent(s, 1);
+    EXPECT_CALL(connection, send_query_params()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, pipeline_sync()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, flush_output()).InSequence(s).WillOnce(Return(ozo::impl::query_state::send_finish));
+
+    request(conn, ozo::none);
+    request(conn, ozo::none);
+    run();
+}
+
+TEST_F(multiplex_channel, should_send_requests_of_one_tick_with_single_flush_with_zero_batch_window) {
+    channel = std::make_shared<channel_type>(io,
+        std::make_shared<connection_source_mock>(connection_source_mock {&connect_handler}),
+        make_config(1, ozo::time_traits::duration::zero()));
+    const auto conn = acquire();
+
+    Sequence s;
+    EXPECT_CALL(connection, enter_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+    expect_batch_sent(s, 3);
+
+    request(conn, ozo::none);
+    request(conn, ozo::none);
+    request(conn, ozo::none);
+    run();
+    EXPECT_FALSE(channel->batch_open());
+}
+
+TEST_F(multiplex_channel, should_keep_batch_open_until_batch_window_ends) {
+    channel = std::make_shared<channel_type>(io,
+        std::make_shared<connection_source_mock>(connection_source_mock {&connect_handler}),
+        make_config(1, std::chrono::hours(1)));
+    const auto conn = acquire();
+
+    request(conn, ozo::none);
+    request(conn, ozo::none);
+    poll();
+    EXPECT_TRUE(channel->batch_open());
+    EXPECT_EQ(channel->load(), 2u);
+}
+
+TEST_F(multiplex_channel, should_flush_full_batch_before_batch_window_ends) {
+    channel = std::make_shared<channel_type>(io,
+        std::make_shared<connection_source_mock>(connection_source_mock {&connect_handler}),
+        make_config(1, std::chrono::hours(1), 2));
+    const auto conn = acquire();
+
+    Sequence s;
+    EXPECT_CALL(connection, enter_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+    expect_batch_sent(s, 2);
+
+    request(conn, ozo::none);
+    request(conn, ozo::none);
+    poll();
+    EXPECT_FALSE(channel->batch_open());
+}
+
+TEST(connection_multiplexer_state, should_select_channel_with_open_batch) {
+    ozo::io_context io;
+    StrictMock<connection_gmock> connection {};
+    StrictMock<ozo::tests::executor_gmock> executor {};
+    StrictMock<ozo::tests::strand_executor_service_gmock> strand_service {};
+    StrictMock<ozo::tests::stream_descriptor_gmock> socket {};
+    StrictMock<ozo::tests::steady_timer_gmock> timer {};
+    ozo::tests::io_context mock_io {executor, strand_service};
+    connection_source_mock::handler_type connect_handler;
+    ozo::impl::multiplexer_state<connection_source_mock> state {connection_source_mock {&connect_handler}, io,
+        make_config(2, std::chrono::hours(1))};
+
+    const auto first = state.select();
+    handle_type conn;
+    first->async_acquire(ozo::none, [&] (ozo::error_code, handle_type c) { conn = std::move(c); });
+    io.poll();
+    auto pg_conn = ozo::tests::make_connection(connection, mock_io, socket, timer);
+    *pg_conn->handle_ = native_handle(native_handle::good, PQTRANS_IDLE);
+    EXPECT_CALL(connection, set_nonblocking()).WillOnce(Return(0));
+    ASSERT_TRUE(connect_handler);
+    std::exchange(connect_handler, {})(ozo::error_code {}, std::move(pg_conn));
+    io.restart();
+    io.poll();
+    ASSERT_TRUE(conn.channel_);
+
+    ozo::impl::async_multiplexed_request(conn, ozo::tests::fake_query {}, ozo::none,
+        [] (auto&&, auto&) {}, [] (ozo::error_code, auto) {});
+    io.restart();
+    io.poll();
+    ASSERT_TRUE(first->batch_open());
+
+    EXPECT_EQ(state.select(), first);
+    EXPECT_EQ(state.size(), 1u);
+}
+
+} // namespace
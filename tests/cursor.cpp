@@ -0,0 +1,293 @@
+#include <connection_mock.h>
+
+#include <ozo/cursor.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+TEST(make_declare_cursor_query, should_prepend_declare_to_query_text) {
+    const auto query = ozo::make_query("SELECT id FROM t WHERE a = $1", 42);
+    const auto declare = ozo::impl::make_declare_cursor_query("c", query);
+    EXPECT_EQ(std::string(ozo::to_const_char(ozo::get_text(declare))),
+        "DECLARE c BINARY NO SCROLL CURSOR FOR SELECT id FROM t WHERE a = $1");
+}
+
+TEST(make_declare_cursor_query, should_preserve_query_params) {
+    const auto query = ozo::make_query("SELECT $1, $2", 42, std::string("foo"));
+    const auto declare = ozo::impl::make_declare_cursor_query("c", query);
+    EXPECT_EQ(ozo::get_params(declare), ozo::get_params(query));
+}
+
+TEST(make_declare_cursor_query, should_build_query_builder) {
+    using namespace ozo::literals;
+    const auto declare = ozo::impl::make_declare_cursor_query("c", "SELECT "_SQL + 42);
+    EXPECT_EQ(std::string(ozo::to_const_char(ozo::get_text(declare))),
+        "DECLARE c BINARY NO SCROLL CURSOR FOR SELECT $1");
+    EXPECT_EQ(ozo::get_params(declare), boost::hana::make_tuple(42));
+}
+
+TEST(make_cursor_name, should_generate_unique_names) {
+    EXPECT_NE(ozo::impl::make_cursor_name(), ozo::impl::make_cursor_name());
+}
+
+using ozo::error_code;
+using ozo::tests::connection_ptr;
+
+using transaction_handler = std::function<void(error_code, connection_ptr<>)>;
+
+struct cursor_statement {
+    std::string text;
+    __OZO_STD_OPTIONAL<ozo::time_traits::time_point> deadline;
+    ozo::result* out = nullptr;
+    transaction_handler handler;
+};
+
+struct cursor_operations_mock {
+    std::vector<cursor_statement>* statements;
+
+    template <typename TimeConstraint>
+    static __OZO_STD_OPTIONAL<ozo::time_traits::time_point> get_deadline(TimeConstraint t) {
+        if constexpr (std::is_same_v<TimeConstraint, ozo::none_t>) {
+            return {};
+        } else {
+            return t;
+        }
+    }
+
+    template <typename Query, typename TimeConstraint, typename Handler>
+    void request(connection_ptr<>, Query&& query, TimeConstraint t, ozo::result& out, Handler&& handler) const {
+        statements->push_back({ozo::to_const_char(ozo::get_text(query)), get_deadline(t), &out,
+            std::forward<Handler>(handler)});
+    }
+
+    template <typename Query, typename TimeConstraint, typename Handler>
+    void execute(connection_ptr<>, Query&& query, TimeConstraint t, Handler&& handler) const {
+        statements->push_back({ozo::to_const_char(ozo::get_text(query)), get_deadline(t), nullptr,
+            std::forward<Handler>(handler)});
+    }
+};
+
+// Result of the single int4 column in the binary format with the given values.
+ozo::result make_result(std::int32_t first, std::size_t rows) {
+    ozo::native_result_handle res(PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK));
+    PGresAttDesc column {};
+    column.name = const_cast<char*>("value");
+    column.format = 1;
+    column.typid = INT4OID;
+    column.typlen = 4;
+    column.atttypmod = -1;
+    PQsetResultAttrs(res.get(), 1, &column);
+    for (std::size_t i = 0; i < rows; ++i) {
+        const auto value = ozo::detail::convert_to_big_endian(static_cast<std::int32_t>(first + static_cast<std::int32_t>(i)));
+        PQsetvalue(res.get(), static_cast<int>(i), 0,
+            const_cast<char*>(reinterpret_cast<const char*>(&value)), sizeof(value));
+    }
+    return ozo::result(std::move(res));
+}
+
+// Result of the single int4 column in the binary format with NULL values which can not be received
+// into a non-optional row.
+ozo::result make_null_result(std::size_t rows) {
+    ozo::native_result_handle res(PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK));
+    PGresAttDesc column {};
+    column.name = const_cast<char*>("value");
+    column.format = 1;
+    column.typid = INT4OID;
+    column.typlen = 4;
+    column.atttypmod = -1;
+    PQsetResultAttrs(res.get(), 1, &column);
+    for (std::size_t i = 0; i < rows; ++i) {
+        PQsetvalue(res.get(), static_cast<int>(i), 0, nullptr, -1);
+    }
+    return ozo::result(std::move(res));
+}
+
+using row_type = std::tuple<std::int32_t>;
+using cursor_state = ozo::impl::cursor_state<row_type, connection_ptr<>, cursor_operations_mock>;
+
+struct cursor_state_test : Test {
+    StrictMock<ozo::tests::connection_gmock> connection {};
+    StrictMock<ozo::tests::executor_gmock> executor {};
+    StrictMock<ozo::tests::executor_gmock> strand {};
+    StrictMock<ozo::tests::strand_executor_service_gmock> strand_service {};
+    StrictMock<ozo::tests::stream_descriptor_gmock> socket {};
+    StrictMock<ozo::tests::steady_timer_gmock> timer {};
+    ozo::tests::io_context io {executor, strand_service};
+    connection_ptr<> transaction = ozo::tests::make_connection(connection, io, socket, timer);
+    std::vector<cursor_statement> statements;
+    std::vector<std::pair<error_code, __OZO_STD_OPTIONAL<row_type>>> rows;
+    std::shared_ptr<cursor_state> state;
+
+    cursor_state_test() {
+        EXPECT_CALL(strand_service, get_executor()).WillRepeatedly(ReturnRef(strand));
+        EXPECT_CALL(strand, post(_)).WillRepeatedly(InvokeArgument<0>());
+    }
+
+    template <typename TimeConstraint = ozo::none_t>
+    void start(TimeConstraint t = TimeConstraint {}) {
+        state = std::make_shared<cursor_state>(transaction, "c", ozo::cursor_config {4, 2, 16},
+            cursor_operations_mock {&statements});
+        state->start(error_code {}, transaction, t);
+    }
+
+    template <typename TimeConstraint = ozo::none_t>
+    void next(TimeConstraint t = TimeConstraint {}) {
+        state->next(t, [this] (error_code ec, __OZO_STD_OPTIONAL<row_type> row) {
+            rows.emplace_back(ec, std::move(row));
+        });
+    }
+
+    void respond(std::int32_t first, std::size_t size) {
+        respond(make_result(first, size));
+    }
+
+    void respond(ozo::result result) {
+        ASSERT_FALSE(statements.empty());
+        auto& statement = statements.back();
+        ASSERT_TRUE(statement.handler);
+        *statement.out = std::move(result);
+        std::exchange(statement.handler, {})(error_code {}, transaction);
+    }
+
+    std::vector<std::string> texts() const {
+        std::vector<std::string> retval;
+        for (const auto& statement : statements) {
+            retval.push_back(statement.text);
+        }
+        return retval;
+    }
+};
+
+TEST_F(cursor_state_test, should_fetch_first_batch_on_start) {
+    start();
+    EXPECT_THAT(texts(), ElementsAre("FETCH 4 FROM c"));
+}
+
+TEST_F(cursor_state_test, should_prefetch_next_batch_when_consumer_takes_received_one) {
+    start();
+    respond(0, 4);
+    EXPECT_EQ(statements.size(), 1u);
+
+    next();
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0].second, row_type {0});
+    EXPECT_THAT(texts(), ElementsAre("FETCH 4 FROM c", "FETCH 4 FROM c"));
+}
+
+TEST_F(cursor_state_test, should_double_batch_size_when_consumer_waited) {
+    start();
+    respond(0, 4);
+    for (int i = 0; i < 4; ++i) {
+        next();
+    }
+    EXPECT_EQ(rows.size(), 4u);
+
+    next();
+    EXPECT_EQ(rows.size(), 4u);
+    respond(4, 4);
+
+    ASSERT_EQ(rows.size(), 5u);
+    EXPECT_EQ(rows[4].second, row_type {4});
+    EXPECT_EQ(state->batch_size(), 8u);
+    EXPECT_EQ(statements.back().text, "FETCH 8 FROM c");
+}
+
+TEST_F(cursor_state_test, should_halve_batch_size_when_batch_arrives_before_half_is_consumed) {
+    start();
+    respond(0, 4);
+    next();
+    respond(4, 4);
+
+    EXPECT_EQ(state->batch_size(), 2u);
+}
+
+TEST_F(cursor_state_test, should_keep_batch_size_within_bounds) {
+    start();
+    respond(0, 4);
+    next();
+    respond(4, 4);
+    EXPECT_EQ(state->batch_size(), 2u);
+
+    for (int i = 0; i < 4; ++i) {
+        next();
+    }
+    EXPECT_EQ(statements.back().text, "FETCH 2 FROM c");
+    respond(8, 2);
+    EXPECT_EQ(state->batch_size(), 2u);
+}
+
+TEST_F(cursor_state_test, should_not_fetch_after_short_batch_and_complete_with_empty_row) {
+    start();
+    respond(0, 2);
+    next();
+    next();
+    next();
+
+    EXPECT_EQ(statements.size(), 1u);
+    ASSERT_EQ(rows.size(), 3u);
+    EXPECT_EQ(rows[1].second, row_type {1});
+    EXPECT_FALSE(rows[2].first);
+    EXPECT_FALSE(rows[2].second);
+}
+
+TEST_F(cursor_state_test, should_limit_statements_with_time_constraint_of_the_call) {
+    const auto declared = ozo::time_traits::now() + std::chrono::seconds(1);
+    start(declared);
+    ASSERT_EQ(statements.size(), 1u);
+    EXPECT_EQ(statements[0].deadline, declared);
+    respond(0, 4);
+
+    const auto fetched = ozo::time_traits::now() + std::chrono::seconds(2);
+    next(fetched);
+    ASSERT_EQ(statements.size(), 2u);
+    EXPECT_EQ(statements[1].deadline, fetched);
+    respond(4, 1);
+
+    state->close(ozo::none, [] (error_code, connection_ptr<>) {});
+    ASSERT_EQ(statements.size(), 3u);
+    EXPECT_EQ(statements[2].text, "CLOSE c");
+    EXPECT_FALSE(statements[2].deadline);
+}
+
+TEST_F(cursor_state_test, should_close_after_fetch_in_flight_with_time_constraint_of_close) {
+    start();
+    std::vector<error_code> closed;
+    const auto deadline = ozo::time_traits::now() + std::chrono::seconds(1);
+    state->close(deadline, [&] (error_code ec, connection_ptr<>) { closed.push_back(ec); });
+    EXPECT_EQ(statements.size(), 1u);
+
+    respond(0, 4);
+    ASSERT_EQ(statements.size(), 2u);
+    EXPECT_EQ(statements[1].text, "CLOSE c");
+    EXPECT_EQ(statements[1].deadline, deadline);
+
+    std::exchange(statements[1].handler, {})(error_code {}, transaction);
+    EXPECT_THAT(closed, ElementsAre(error_code {}));
+}
+
+TEST_F(cursor_state_test, should_fail_and_end_when_row_can_not_be_received) {
+    start();
+    respond(make_null_result(4));
+    next();
+    next();
+    respond(4, 4);
+    next();
+
+    ASSERT_EQ(rows.size(), 3u);
+    for (const auto& [ec, row] : rows) {
+        EXPECT_EQ(ec, error_code {ozo::error::bad_result_process});
+        EXPECT_FALSE(row);
+    }
+    EXPECT_THAT(texts(), ElementsAre("FETCH 4 FROM c", "FETCH 4 FROM c"));
+
+    std::vector<error_code> closed;
+    state->close(ozo::none, [&] (error_code ec, connection_ptr<>) { closed.push_back(ec); });
+    EXPECT_THAT(closed, ElementsAre(error_code {ozo::error::bad_result_process}));
+    EXPECT_EQ(statements.size(), 2u);
+}
+
+} // namespace
@@ -0,0 +1,107 @@
+#include <ozo/detail/histogram.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+
+namespace {
+
+using namespace testing;
+
+using buckets = ozo::detail::log_linear_buckets<4, 40>;
+
+TEST(log_linear_buckets, index_should_be_identity_for_values_less_than_sub_buckets_count) {
+    for (std::uint64_t v = 0; v < buckets::sub_buckets; ++v) {
+        EXPECT_EQ(buckets::index(v), v);
+    }
+}
+
+TEST(log_linear_buckets, bucket_bounds_should_contain_value) {
+    for (std::uint64_t v : {16ull, 17ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull, (1ull << 39) + 5}) {
+        const auto i = buckets::index(v);
+        EXPECT_LE(buckets::lowest_value(i), v) << v;
+        EXPECT_GE(buckets::highest_value(i), v) << v;
+    }
+}
+
+TEST(log_linear_buckets, relative_error_should_be_less_than_sub_bucket_precision) {
+    for (std::uint64_t v = 1000; v < 1000000; v = v * 3 + 1) {
+        const auto i = buckets::index(v);
+        EXPECT_LE(buckets::highest_value(i) - buckets::lowest_value(i), buckets::lowest_value(i) / buckets::sub_buckets);
+    }
+}
+
+TEST(log_linear_buckets, index_should_clamp_too_large_values_into_last_bucket) {
+    EXPECT_EQ(buckets::index(1ull << 40), buckets::size - 1);
+    EXPECT_EQ(buckets::index(~0ull), buckets::size - 1);
+}
+
+TEST(histogram, snapshot_should_contain_recorded_values) {
+    ozo::detail::histogram<> h;
+    for (std::uint64_t v = 1; v <= 100; ++v) {
+        h.record(v);
+    }
+    const auto s = h.snapshot();
+    EXPECT_EQ(s.count, 100u);
+    EXPECT_EQ(s.sum, 5050u);
+    EXPECT_EQ(s.max, 100u);
+    EXPECT_EQ(s.mean(), 50u);
+    EXPECT_NEAR(double(s.percentile(50)), 50.0, 50.0 / 16);
+    EXPECT_NEAR(double(s.percentile(99)), 99.0, 99.0 / 16);
+    EXPECT_EQ(s.percentile(100), 100u);
+}
+
+TEST(histogram, percentile_of_empty_snapshot_should_be_zero) {
+    EXPECT_EQ(ozo::detail::histogram_snapshot<>{}.percentile(99), 0u);
+}
+
+TEST(histogram, snapshots_should_be_mergeable) {
+    ozo::detail::histogram<> a, b;
+    a.record(10);
+    b.record(1000);
+    auto s = a.snapshot();
+    s += b.snapshot();
+    EXPECT_EQ(s.count, 2u);
+    EXPECT_EQ(s.max, 1000u);
+    EXPECT_EQ(s.percentile(50), 10u);
+}
+
+TEST(histogram, should_count_all_values_recorded_concurrently) {
+    ozo::detail::histogram<> h;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (std::uint64_t v = 0; v < 10000; ++v) {
+                h.record(v);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(h.snapshot().count, 40000u);
+    EXPECT_EQ(h.snapshot().max, 9999u);
+}
+
+TEST(counter_table, should_count_increments_by_key) {
+    ozo::detail::counter_table<4> t;
+    t.increment(1);
+    t.increment(1);
+    t.increment(7);
+    std::map<std::uint32_t, std::uint64_t> result;
+    t.for_each([&](auto key, auto count) { result[key] = count; });
+    EXPECT_THAT(result, ElementsAre(Pair(1u, 2u), Pair(7u, 1u)));
+}
+
+TEST(counter_table, should_count_keys_which_do_not_fit_as_overflow) {
+    ozo::detail::counter_table<3> t;
+    t.increment(1);
+    t.increment(2);
+    t.increment(3);
+    std::map<std::uint32_t, std::uint64_t> result;
+    t.for_each([&](auto key, auto count) { result[key] = count; });
+    EXPECT_THAT(result, ElementsAre(Pair(1u, 1u), Pair(2u, 1u), Pair(decltype(t)::overflow, 1u)));
+}
+
+} // namespace
@@ -0,0 +1,50 @@
+#include <ozo/detail/probe.h>
+#include <ozo/detail/stopwatch.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace {
+
+using namespace std::literals;
+
+TEST(ProbeArgument, should_be_true_for_integers_and_pointers) {
+    EXPECT_TRUE(ozo::detail::ProbeArgument<int>);
+    EXPECT_TRUE(ozo::detail::ProbeArgument<bool>);
+    EXPECT_TRUE(ozo::detail::ProbeArgument<std::int64_t>);
+    EXPECT_TRUE(ozo::detail::ProbeArgument<const char*>);
+}
+
+TEST(ProbeArgument, should_be_false_for_other_types) {
+    EXPECT_FALSE(ozo::detail::ProbeArgument<std::string>);
+    EXPECT_FALSE(ozo::detail::ProbeArgument<std::string_view>);
+    EXPECT_FALSE(ozo::detail::ProbeArgument<double>);
+    EXPECT_FALSE(ozo::detail::ProbeArgument<ozo::time_traits::duration>);
+}
+
+TEST(OZO_PROBE, should_compile_with_probe_arguments_of_the_library_probes) {
+    const ozo::detail::stopwatch<false> stopwatch;
+    OZO_PROBE(query__send, -1, ozo::detail::probe_name("query"), ozo::detail::probe_ns(stopwatch.elapsed()));
+    OZO_PROBE(pool__release, -1, ozo::detail::probe_ns(stopwatch.elapsed()), true);
+}
+
+TEST(OZO_PROBE, should_not_evaluate_arguments_if_usdt_is_disabled) {
+    if constexpr (!ozo::detail::probes_enabled) {
+        int calls = 0;
+        const auto f = [&] { return ++calls; };
+        OZO_PROBE(connect__start, f());
+        EXPECT_EQ(calls, 0);
+    }
+}
+
+TEST(probe_ns, should_convert_duration_to_nanoseconds) {
+    EXPECT_EQ(ozo::detail::probe_ns(std::chrono::microseconds(3)), 3000);
+}
+
+TEST(probe_name, should_return_empty_string_for_empty_name) {
+    EXPECT_STREQ(ozo::detail::probe_name({}), "");
+    EXPECT_STREQ(ozo::detail::probe_name("name"sv), "name");
+}
+
+} // namespace
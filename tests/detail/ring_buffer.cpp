@@ -0,0 +1,67 @@
+#include <ozo/detail/ring_buffer.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace testing;
+
+TEST(ring_buffer, consume_should_visit_pushed_values_in_order) {
+    ozo::detail::ring_buffer<int, 4> buffer;
+    EXPECT_TRUE(buffer.push(1));
+    EXPECT_TRUE(buffer.push(2));
+    EXPECT_TRUE(buffer.push(3));
+    std::vector<int> result;
+    EXPECT_EQ(buffer.consume([&](int v) { result.push_back(v); }), 3u);
+    EXPECT_THAT(result, ElementsAre(1, 2, 3));
+    EXPECT_TRUE(buffer.empty());
+}
+
+TEST(ring_buffer, push_should_fail_when_buffer_is_full) {
+    ozo::detail::ring_buffer<int, 2> buffer;
+    EXPECT_TRUE(buffer.push(1));
+    EXPECT_TRUE(buffer.push(2));
+    EXPECT_FALSE(buffer.push(3));
+    EXPECT_EQ(buffer.size(), 2u);
+}
+
+TEST(ring_buffer, push_should_succeed_after_consume_frees_space) {
+    ozo::detail::ring_buffer<int, 2> buffer;
+    buffer.push(1);
+    buffer.push(2);
+    buffer.consume([](int) {});
+    EXPECT_TRUE(buffer.push(3));
+    std::vector<int> result;
+    buffer.consume([&](int v) { result.push_back(v); });
+    EXPECT_THAT(result, ElementsAre(3));
+}
+
+TEST(ring_buffer, should_pass_all_values_from_producer_to_consumer_thread) {
+    ozo::detail::ring_buffer<int, 16> buffer;
+    constexpr int count = 10000;
+    std::thread producer([&] {
+        for (int i = 0; i < count;) {
+            if (buffer.push(i)) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    int expected = 0;
+    bool ordered = true;
+    while (expected < count) {
+        if (!buffer.consume([&](int v) { ordered = ordered && v == expected; ++expected; })) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(buffer.empty());
+}
+
+} // namespace
@@ -0,0 +1,100 @@
+#include <ozo/execute_many.h>
+#include <ozo/ext/std/optional.h>
+#include <ozo/ext/std/vector.h>
+
+#include <boost/hana/adapt_struct.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+struct row {
+    std::int32_t id;
+    std::string name;
+};
+
+} // namespace
+
+BOOST_HANA_ADAPT_STRUCT(row, id, name);
+
+namespace {
+
+using namespace testing;
+namespace hana = boost::hana;
+
+TEST(make_unnest_statement, should_rewrite_values_row_into_unnest) {
+    EXPECT_EQ(ozo::impl::make_unnest_statement("INSERT INTO t (a, b) VALUES ($1, $2)", 2),
+        "INSERT INTO t (a, b) SELECT * FROM UNNEST($1, $2)");
+}
+
+TEST(make_unnest_statement, should_preserve_statement_tail) {
+    EXPECT_EQ(ozo::impl::make_unnest_statement(
+            "INSERT INTO t (a, b) values( $1 ,$2 ) ON CONFLICT (a) DO UPDATE SET b = EXCLUDED.b", 2),
+        "INSERT INTO t (a, b) SELECT * FROM UNNEST($1, $2) ON CONFLICT (a) DO UPDATE SET b = EXCLUDED.b");
+}
+
+TEST(make_unnest_statement, should_return_empty_for_statement_without_values) {
+    EXPECT_FALSE(ozo::impl::make_unnest_statement("UPDATE t SET a = $1 WHERE b = $2", 2));
+}
+
+TEST(make_unnest_statement, should_return_empty_for_placeholders_out_of_values_row) {
+    EXPECT_FALSE(ozo::impl::make_unnest_statement(
+        "INSERT INTO t (a, b) VALUES ($1, $2) ON CONFLICT (a) DO UPDATE SET b = $3", 3));
+}
+
+TEST(make_unnest_statement, should_return_empty_for_reordered_placeholders) {
+    EXPECT_FALSE(ozo::impl::make_unnest_statement("INSERT INTO t (a, b) VALUES ($2, $1)", 2));
+}
+
+TEST(make_unnest_statement, should_return_empty_for_values_row_with_expressions) {
+    EXPECT_FALSE(ozo::impl::make_unnest_statement("INSERT INTO t (a, b) VALUES ($1, lower($2))", 2));
+}
+
+TEST(make_unnest_statement, should_ignore_placeholders_in_literals_and_comments) {
+    EXPECT_EQ(ozo::impl::make_unnest_statement(
+            "INSERT INTO t (a, b) VALUES ($1, $2) -- $3\n"
+            "ON CONFLICT (a) DO UPDATE SET b = E'$4\\' $5' || '$6''$7' || $$ $8 $$ || $x$ $9 $x$ /* $10 /* $11 */ */", 2),
+        "INSERT INTO t (a, b) SELECT * FROM UNNEST($1, $2) -- $3\n"
+        "ON CONFLICT (a) DO UPDATE SET b = E'$4\\' $5' || '$6''$7' || $$ $8 $$ || $x$ $9 $x$ /* $10 /* $11 */ */");
+}
+
+TEST(make_unnest_statement, should_ignore_values_row_in_literals_and_comments) {
+    EXPECT_EQ(ozo::impl::make_unnest_statement(
+            "INSERT INTO \"values($1)\" (a) /* VALUES ($1) */ VALUES ($1)", 1),
+        "INSERT INTO \"values($1)\" (a) /* VALUES ($1) */ SELECT * FROM UNNEST($1)");
+}
+
+TEST(count_placeholders, should_count_placeholders_out_of_literals_and_comments_only) {
+    EXPECT_EQ(ozo::impl::count_placeholders("SELECT $1, '$2', \"$3\", $$$4$$, $a$ $5 $a$, $6 -- $7"), 2u);
+    EXPECT_EQ(ozo::impl::count_placeholders("SELECT a$1, $1"), 1u);
+}
+
+TEST(ArrayParams, should_be_true_if_any_param_is_array) {
+    EXPECT_FALSE((ozo::impl::ArrayParams<hana::tuple<std::int32_t, std::string>>));
+    EXPECT_TRUE((ozo::impl::ArrayParams<hana::tuple<std::int32_t, std::vector<std::int32_t>>>));
+    EXPECT_TRUE((ozo::impl::ArrayParams<hana::tuple<std::optional<std::vector<std::string>>>>));
+}
+
+TEST(row_params, should_return_members_of_hana_struct) {
+    EXPECT_EQ(ozo::impl::row_params(row{42, "foo"}), hana::make_tuple(42, std::string("foo")));
+}
+
+TEST(row_params, should_return_elements_of_fusion_sequence) {
+    EXPECT_EQ(ozo::impl::row_params(std::make_tuple(42, std::string("foo"))),
+        hana::make_tuple(42, std::string("foo")));
+}
+
+TEST(row_params, should_return_single_value_for_scalar) {
+    EXPECT_EQ(ozo::impl::row_params(42), hana::make_tuple(42));
+}
+
+TEST(transpose_rows, should_return_array_per_param) {
+    const std::vector<row> rows {{1, "a"}, {2, "b"}, {3, "c"}};
+    EXPECT_EQ(ozo::impl::transpose_rows(rows), hana::make_tuple(
+        std::vector<std::int32_t>({1, 2, 3}),
+        std::vector<std::string>({"a", "b", "c"})
+    ));
+}
+
+} // namespace
@@ -0,0 +1,278 @@
+#include <connection_mock.h>
+
+#include <ozo/hedged_request.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+struct hedging_state : Test {
+    ozo::io_context io;
+    ozo::hedging_config config {95, 32, 10ms, 1ms};
+
+    void record(ozo::impl::hedging_state& state, const std::string& key, std::size_t count,
+            ozo::time_traits::duration latency) {
+        for (std::size_t i = 0; i < count; ++i) {
+            state.record(key, latency);
+        }
+    }
+};
+
+TEST_F(hedging_state, delay_should_be_initial_delay_for_unknown_query) {
+    ozo::impl::hedging_state state(io, config);
+    EXPECT_EQ(state.delay("query"), 10ms);
+}
+
+TEST_F(hedging_state, delay_should_be_initial_delay_until_enough_samples) {
+    ozo::impl::hedging_state state(io, config);
+    record(state, "query", 31, 100ms);
+    EXPECT_EQ(state.delay("query"), 10ms);
+}
+
+TEST_F(hedging_state, delay_should_follow_percentile_of_latencies) {
+    ozo::impl::hedging_state state(io, config);
+    record(state, "query", 32, 100ms);
+    const auto delay = state.delay("query");
+    EXPECT_GE(delay, 90ms);
+    EXPECT_LE(delay, 110ms);
+    EXPECT_EQ(state.delay("other"), 10ms);
+}
+
+TEST_F(hedging_state, delay_should_not_be_less_than_min_delay) {
+    config.min_delay = 50ms;
+    ozo::impl::hedging_state state(io, config);
+    EXPECT_EQ(state.delay("query"), 50ms);
+    record(state, "query", 32, 0ms);
+    EXPECT_EQ(state.delay("query"), 50ms);
+}
+
+TEST(get_hedging_key, should_return_query_text_for_unnamed_query) {
+    EXPECT_EQ(ozo::impl::get_hedging_key(ozo::make_query("SELECT $1", 42)), "SELECT $1");
+}
+
+TEST(get_hedging_key, should_return_query_text_for_query_builder) {
+    using namespace ozo::literals;
+    EXPECT_EQ(ozo::impl::get_hedging_key("SELECT "_SQL + 42), "SELECT $1");
+}
+
+TEST(get_hedging_key, should_not_depend_on_params) {
+    EXPECT_EQ(ozo::impl::get_hedging_key(ozo::make_query("SELECT $1", 42)),
+        ozo::impl::get_hedging_key(ozo::make_query("SELECT $1", 43)));
+}
+
+TEST(get_hedging_key, should_return_name_of_named_query) {
+    using namespace boost::hana::literals;
+    const auto query = ozo::impl::make_named_query("named query"_s, ozo::make_query("SELECT 1"));
+    EXPECT_EQ(ozo::impl::get_hedging_key(query), "named query");
+}
+
+using ozo::error_code;
+using ozo::tests::connection_ptr;
+
+struct provider_mock {
+    using connection_type = connection_ptr<>;
+    std::size_t index;
+};
+
+struct hedged_attempts {
+    using connection_handler = std::function<void(error_code, connection_ptr<>)>;
+
+    std::array<connection_handler, 2> connect;
+    std::vector<std::pair<connection_ptr<>, connection_handler>> requests;
+    std::vector<PGcancel*> cancelled;
+    std::vector<std::function<void()>> cancels;
+};
+
+struct operations_mock {
+    hedged_attempts* attempts;
+
+    template <typename TimeConstraint, typename Handler>
+    void get_connection(const provider_mock& provider, TimeConstraint, Handler&& handler) const {
+        attempts->connect[provider.index] = std::forward<Handler>(handler);
+    }
+
+    template <typename Query, typename TimeConstraint, typename Handler>
+    void request(connection_ptr<> conn, const Query&, TimeConstraint, ozo::result&, Handler&& handler) const {
+        attempts->requests.emplace_back(std::move(conn), std::forward<Handler>(handler));
+    }
+
+    // Dummy handle of the connection, it is never passed to libpq.
+    static PGcancel* handle_of(const connection_ptr<>& conn) {
+        return reinterpret_cast<PGcancel*>(conn.get());
+    }
+
+    ozo::impl::native_cancel_handle get_cancel_handle(const connection_ptr<>& conn) const {
+        return ozo::impl::native_cancel_handle(handle_of(conn), [] (PGcancel*) {});
+    }
+
+    template <typename Handler>
+    void cancel(ozo::impl::native_cancel_handle handle, Handler&& handler) const {
+        attempts->cancelled.push_back(handle.get());
+        attempts->cancels.emplace_back(std::forward<Handler>(handler));
+    }
+};
+
+struct hedged_request_state : Test {
+    ozo::io_context io;
+    StrictMock<ozo::tests::connection_gmock> connection {};
+    StrictMock<ozo::tests::executor_gmock> executor {};
+    StrictMock<ozo::tests::strand_executor_service_gmock> strand_service {};
+    StrictMock<ozo::tests::stream_descriptor_gmock> socket {};
+    StrictMock<ozo::tests::steady_timer_gmock> timer {};
+    ozo::tests::io_context mock_io {executor, strand_service};
+    connection_ptr<> primary = ozo::tests::make_connection(connection, mock_io, socket, timer);
+    connection_ptr<> secondary = ozo::tests::make_connection(connection, mock_io, socket, timer);
+    ozo::result out;
+    hedged_attempts attempts;
+    std::vector<std::pair<error_code, connection_ptr<>>> completed;
+    std::shared_ptr<ozo::impl::hedging_state> policy;
+    const std::string key = "SELECT 1";
+
+    void start(ozo::time_traits::duration delay) {
+        policy = std::make_shared<ozo::impl::hedging_state>(io, ozo::hedging_config {95, 32, delay, delay});
+        auto handler = boost::asio::bind_executor(io.get_executor(), [this] (error_code ec, connection_ptr<> conn) {
+            completed.emplace_back(ec, std::move(conn));
+        });
+        using state_type = ozo::impl::hedged_request_state<provider_mock, provider_mock,
+            decltype(ozo::make_query(key.c_str())), std::reference_wrapper<ozo::result>, ozo::none_t,
+            decltype(handler), operations_mock>;
+        std::make_shared<state_type>(policy, provider_mock {0}, provider_mock {1}, ozo::make_query(key.c_str()),
+            ozo::none, std::ref(out), std::move(handler), operations_mock {&attempts})->start();
+        run();
+    }
+
+    void connect(std::size_t index, error_code ec, connection_ptr<> conn) {
+        ASSERT_TRUE(attempts.connect[index]);
+        std::exchange(attempts.connect[index], {})(ec, std::move(conn));
+        run();
+    }
+
+    void respond(const connection_ptr<>& conn, error_code ec) {
+        const auto i = std::find_if(attempts.requests.begin(), attempts.requests.end(),
+            [&] (const auto& r) { return r.first == conn; });
+        ASSERT_NE(i, attempts.requests.end());
+        auto request = std::move(*i);
+        attempts.requests.erase(i);
+        request.second(ec, std::move(request.first));
+        run();
+    }
+
+    void deliver_cancels() {
+        for (auto& cancel : std::exchange(attempts.cancels, {})) {
+            cancel();
+        }
+        run();
+    }
+
+    void run() {
+        io.restart();
+        io.poll();
+    }
+};
+
+TEST_F(hedged_request_state, should_complete_with_primary_before_hedge_delay) {
+    start(std::chrono::hours(1));
+    connect(0, {}, primary);
+    respond(primary, {});
+
+    ASSERT_EQ(completed.size(), 1u);
+    EXPECT_FALSE(completed[0].first);
+    EXPECT_EQ(completed[0].second, primary);
+    EXPECT_FALSE(attempts.connect[1]);
+    EXPECT_TRUE(attempts.cancels.empty());
+    EXPECT_EQ(policy->samples(key), 1u);
+}
+
+TEST_F(hedged_request_state, should_request_secondary_after_hedge_delay) {
+    start(0ms);
+    EXPECT_TRUE(attempts.connect[0]);
+    EXPECT_TRUE(attempts.connect[1]);
+    EXPECT_TRUE(completed.empty());
+}
+
+TEST_F(hedged_request_state, should_request_secondary_immediately_when_primary_fails) {
+    start(std::chrono::hours(1));
+    connect(0, ozo::error::pq_connection_start_failed, nullptr);
+
+    EXPECT_TRUE(attempts.connect[1]);
+    connect(1, {}, secondary);
+    respond(secondary, {});
+
+    ASSERT_EQ(completed.size(), 1u);
+    EXPECT_FALSE(completed[0].first);
+    EXPECT_EQ(completed[0].second, secondary);
+    EXPECT_EQ(policy->samples(key), 0u);
+}
+
+TEST_F(hedged_request_state, should_complete_with_last_error_when_both_fail) {
+    start(0ms);
+    connect(0, {}, primary);
+    connect(1, {}, secondary);
+    respond(secondary, ozo::error::result_status_bad_response);
+    EXPECT_TRUE(completed.empty());
+    respond(primary, ozo::error::pg_consume_input_failed);
+
+    ASSERT_EQ(completed.size(), 1u);
+    EXPECT_EQ(completed[0].first, ozo::error::pg_consume_input_failed);
+    EXPECT_TRUE(attempts.cancels.empty());
+}
+
+TEST_F(hedged_request_state, should_cancel_only_the_loser) {
+    start(0ms);
+    connect(0, {}, primary);
+    connect(1, {}, secondary);
+    respond(primary, {});
+
+    ASSERT_EQ(completed.size(), 1u);
+    EXPECT_EQ(completed[0].second, primary);
+    EXPECT_THAT(attempts.cancelled, ElementsAre(operations_mock::handle_of(secondary)));
+    ASSERT_EQ(attempts.requests.size(), 1u);
+    EXPECT_EQ(attempts.requests[0].first, secondary);
+}
+
+TEST_F(hedged_request_state, should_keep_loser_connection_until_cancel_is_delivered) {
+    start(0ms);
+    connect(0, {}, primary);
+    connect(1, {}, secondary);
+    respond(secondary, {});
+    ASSERT_EQ(completed.size(), 1u);
+    EXPECT_EQ(completed[0].second, secondary);
+
+    std::weak_ptr<ozo::tests::connection<>> loser = primary;
+    primary.reset();
+    respond(loser.lock(), boost::asio::error::operation_aborted);
+    EXPECT_FALSE(loser.expired());
+
+    deliver_cancels();
+    EXPECT_TRUE(loser.expired());
+}
+
+TEST_F(hedged_request_state, should_record_latency_of_cancelled_primary) {
+    start(0ms);
+    connect(0, {}, primary);
+    connect(1, {}, secondary);
+    respond(secondary, {});
+    EXPECT_EQ(policy->samples(key), 0u);
+
+    respond(primary, boost::asio::error::operation_aborted);
+    EXPECT_EQ(policy->samples(key), 1u);
+    EXPECT_EQ(completed.size(), 1u);
+}
+
+TEST_F(hedged_request_state, should_record_latency_of_primary_completed_after_secondary) {
+    start(0ms);
+    connect(0, {}, primary);
+    connect(1, {}, secondary);
+    respond(secondary, {});
+    deliver_cancels();
+
+    respond(primary, {});
+    EXPECT_EQ(policy->samples(key), 1u);
+    EXPECT_EQ(completed.size(), 1u);
+}
+
+} // namespace
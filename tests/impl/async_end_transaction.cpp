@@ -39,4 +39,19 @@ TEST_F(async_end_transaction, should_call_async_execute) {
     ozo::impl::async_end_transaction(std::move(transaction), fake_query {}, timeout, wrap(callback));
 }
 
+TEST_F(async_end_transaction, should_not_call_async_execute_for_finished_transaction) {
+    *conn->handle_ = native_handle::good;
+
+    auto transaction = ozo::impl::transaction<decltype(conn)>(std::move(conn));
+    transaction.defer_begin("BEGIN");
+
+    const InSequence s;
+
+    EXPECT_CALL(callback, get_executor()).WillOnce(Return(io.get_executor()));
+    EXPECT_CALL(executor, dispatch(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_end_transaction(std::move(transaction), fake_query {}, timeout, wrap(callback));
+}
+
 } // namespace
@@ -439,4 +439,47 @@ INSTANTIATE_TEST_CASE_P(
     async_get_result_,
     Values(PGRES_COPY_OUT, PGRES_COPY_IN, PGRES_COPY_BOTH, PGRES_NONFATAL_ERROR));
 
+struct async_get_pipeline_result : async_get_result {
+    void expect_result(Sequence& s, boost::optional<ozo::tests::pg_result> result) {
+        EXPECT_CALL(m.connection, is_busy()).InSequence(s).WillOnce(Return(false));
+        EXPECT_CALL(m.connection, get_result()).InSequence(s).WillOnce(Return(result));
+    }
+};
+
+TEST_F(async_get_pipeline_result, should_process_query_result_and_skip_deferred_statements_results) {
+    Sequence s;
+
+    expect_result(s, make_pg_result(PGRES_COMMAND_OK, error_code{}));
+    expect_result(s, boost::none);
+    expect_result(s, make_pg_result(PGRES_TUPLES_OK, error_code{}));
+    expect_result(s, boost::none);
+    expect_result(s, make_pg_result(PGRES_COMMAND_OK, error_code{}));
+    expect_result(s, boost::none);
+    expect_result(s, make_pg_result(PGRES_PIPELINE_SYNC, error_code{}));
+    EXPECT_CALL(m.connection, exit_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+
+    EXPECT_CALL(process, call()).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{}, _)).InSequence(s).WillOnce(Return());
+
+    m.ctx->deferred = {"BEGIN", "COMMIT"};
+    ozo::impl::async_get_result(m.ctx, process_f);
+}
+
+TEST_F(async_get_pipeline_result, should_post_callback_with_error_of_failed_deferred_statement) {
+    Sequence s;
+
+    expect_result(s, make_pg_result(PGRES_FATAL_ERROR, error_code{error::error}));
+    expect_result(s, boost::none);
+    expect_result(s, make_pg_result(PGRES_PIPELINE_ABORTED, error_code{}));
+    expect_result(s, boost::none);
+    expect_result(s, make_pg_result(PGRES_PIPELINE_SYNC, error_code{}));
+    EXPECT_CALL(m.connection, exit_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+
+    EXPECT_CALL(m.socket, cancel(_)).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{error::error}, _)).InSequence(s).WillOnce(Return());
+
+    m.ctx->deferred = {"BEGIN", nullptr};
+    ozo::impl::async_get_result(m.ctx, process_f);
+}
+
 } // namespace
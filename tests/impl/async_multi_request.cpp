@@ -0,0 +1,205 @@
+#include <connection_mock.h>
+#include <test_error.h>
+
+#include <ozo/impl/async_multi_request.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <vector>
+
+namespace {
+
+namespace hana = boost::hana;
+
+using namespace testing;
+using namespace ozo::tests;
+
+using callback_mock = callback_gmock<connection_ptr<>>;
+
+struct fixture {
+    StrictMock<connection_gmock> connection{};
+    StrictMock<executor_gmock> callback_executor{};
+    StrictMock<callback_mock> callback{};
+    StrictMock<executor_gmock> executor{};
+    StrictMock<strand_executor_service_gmock> strand_service{};
+    StrictMock<stream_descriptor_gmock> socket{};
+    StrictMock<steady_timer_gmock> timer{};
+    io_context io{executor, strand_service};
+    execution_context cb_io {callback_executor};
+    decltype(make_connection(connection, io, socket, timer)) conn =
+            make_connection(connection, io, socket, timer);
+
+    auto make_operation_context() {
+        EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+        return ozo::impl::make_request_operation_context(conn, wrap(callback));
+    }
+
+    decltype(ozo::impl::make_request_operation_context(conn, wrap(callback))) ctx;
+
+    fixture() : ctx(make_operation_context()) {}
+};
+
+using ozo::error_code;
+
+struct process_mock {
+    MOCK_CONST_METHOD0(call, void());
+};
+
+struct process_wrapper {
+    process_mock& mock;
+    template <typename ...Ts>
+    void operator() (Ts&& ...) const { mock.call(); }
+};
+
+struct async_get_results_op : Test {
+    fixture m;
+    StrictMock<process_mock> first;
+    StrictMock<process_mock> second;
+
+    void expect_result(Sequence& s, boost::optional<ozo::tests::pg_result> result) {
+        EXPECT_CALL(m.connection, is_busy()).InSequence(s).WillOnce(Return(false));
+        EXPECT_CALL(m.connection, get_result()).InSequence(s).WillOnce(Return(result));
+    }
+
+    void perform() {
+        ozo::impl::async_get_results_op op {m.ctx, hana::make_tuple(process_wrapper{first}, process_wrapper{second}), 2};
+        op.perform();
+    }
+};
+
+TEST_F(async_get_results_op, should_process_each_result_set_with_its_own_processor) {
+    Sequence s;
+
+    expect_result(s, make_pg_result(PGRES_COMMAND_OK, error_code{}));
+    expect_result(s, boost::none);
+    expect_result(s, make_pg_result(PGRES_TUPLES_OK, error_code{}));
+    EXPECT_CALL(first, call()).InSequence(s).WillOnce(Return());
+    expect_result(s, boost::none);
+    expect_result(s, make_pg_result(PGRES_TUPLES_OK, error_code{}));
+    EXPECT_CALL(second, call()).InSequence(s).WillOnce(Return());
+    expect_result(s, boost::none);
+    expect_result(s, make_pg_result(PGRES_PIPELINE_SYNC, error_code{}));
+    EXPECT_CALL(m.connection, exit_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).InSequence(s).WillOnce(Return());
+
+    m.ctx->deferred = {"BEGIN", nullptr};
+    perform();
+}
+
+TEST_F(async_get_results_op, should_not_process_result_of_query_without_rows) {
+    Sequence s;
+
+    expect_result(s, make_pg_result(PGRES_COMMAND_OK, error_code{}));
+    expect_result(s, boost::none);
+    expect_result(s, make_pg_result(PGRES_TUPLES_OK, error_code{}));
+    EXPECT_CALL(second, call()).InSequence(s).WillOnce(Return());
+    expect_result(s, boost::none);
+    expect_result(s, make_pg_result(PGRES_PIPELINE_SYNC, error_code{}));
+    EXPECT_CALL(m.connection, exit_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).InSequence(s).WillOnce(Return());
+
+    perform();
+}
+
+TEST_F(async_get_results_op, should_post_callback_with_error_of_failed_query_and_skip_aborted_ones) {
+    Sequence s;
+
+    expect_result(s, make_pg_result(PGRES_FATAL_ERROR, error_code{error::error}));
+    expect_result(s, boost::none);
+    expect_result(s, make_pg_result(PGRES_PIPELINE_ABORTED, error_code{}));
+    expect_result(s, boost::none);
+    expect_result(s, make_pg_result(PGRES_PIPELINE_SYNC, error_code{}));
+    EXPECT_CALL(m.connection, exit_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(m.socket, cancel(_)).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{error::error}, _)).InSequence(s).WillOnce(Return());
+
+    perform();
+}
+
+TEST_F(async_get_results_op, should_post_callback_with_bad_result_process_if_processor_throws) {
+    Sequence s;
+
+    expect_result(s, make_pg_result(PGRES_TUPLES_OK, error_code{}));
+    EXPECT_CALL(first, call()).InSequence(s).WillOnce(Throw(std::runtime_error("bad row")));
+    expect_result(s, boost::none);
+    expect_result(s, make_pg_result(PGRES_TUPLES_OK, error_code{}));
+    expect_result(s, boost::none);
+    expect_result(s, make_pg_result(PGRES_PIPELINE_SYNC, error_code{}));
+    EXPECT_CALL(m.connection, exit_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(m.socket, cancel(_)).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::bad_result_process}, _)).InSequence(s).WillOnce(Return());
+
+    perform();
+    EXPECT_EQ(m.conn->error_context_, "bad row");
+}
+
+struct async_pipeline_request : Test {
+    StrictMock<connection_gmock> connection {};
+    StrictMock<executor_gmock> callback_executor {};
+    StrictMock<callback_mock> callback {};
+    StrictMock<executor_gmock> executor {};
+    StrictMock<executor_gmock> strand {};
+    StrictMock<strand_executor_service_gmock> strand_service {};
+    StrictMock<stream_descriptor_gmock> socket {};
+    StrictMock<steady_timer_gmock> timer {};
+    StrictMock<process_mock> process;
+    io_context io {executor, strand_service};
+    execution_context cb_io {callback_executor};
+    decltype(make_connection(connection, io, socket, timer)) conn =
+            make_connection(connection, io, socket, timer);
+
+    static std::vector<ozo::trace::record> consume_spans() {
+        std::vector<ozo::trace::record> retval;
+        ozo::trace::tracer::consume([&] (const ozo::trace::record& r) { retval.push_back(r); });
+        return retval;
+    }
+};
+
+TEST_F(async_pipeline_request, should_report_spans_of_pipeline_phases_to_given_trace) {
+    EXPECT_CALL(strand_service, get_executor()).WillRepeatedly(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    Sequence s;
+
+    EXPECT_CALL(connection, set_nonblocking()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(connection, enter_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, send_query_params()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, pipeline_sync()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, flush_output()).InSequence(s).WillOnce(Return(ozo::impl::query_state::send_finish));
+
+    EXPECT_CALL(connection, is_busy()).InSequence(s).WillOnce(Return(false));
+    EXPECT_CALL(connection, get_result()).InSequence(s).WillOnce(Return(make_pg_result(PGRES_TUPLES_OK, error_code{})));
+    EXPECT_CALL(process, call()).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(connection, is_busy()).InSequence(s).WillOnce(Return(false));
+    EXPECT_CALL(connection, get_result()).InSequence(s).WillOnce(Return(boost::none));
+    EXPECT_CALL(connection, is_busy()).InSequence(s).WillOnce(Return(false));
+    EXPECT_CALL(connection, get_result()).InSequence(s).WillOnce(Return(make_pg_result(PGRES_PIPELINE_SYNC, error_code{})));
+    EXPECT_CALL(connection, exit_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+
+    EXPECT_CALL(executor, post(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback_executor, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    consume_spans();
+    const ozo::trace::request<> trace("pipeline");
+    ozo::impl::async_pipeline_request(conn, "pipeline", trace,
+        [] (const auto&, const auto&) { return hana::make_tuple(fake_query{}); },
+        hana::make_tuple(process_wrapper{process}), 1, ozo::none, wrap(callback));
+
+    const auto spans = consume_spans();
+    std::vector<ozo::trace::phase> phases;
+    for (const auto& span : spans) {
+        phases.push_back(span.phase);
+        EXPECT_EQ(span.name, "pipeline");
+        EXPECT_NE(span.request, 0u);
+        EXPECT_EQ(span.request, spans.front().request);
+        EXPECT_GE(span.start, trace.start());
+        EXPECT_FALSE(span.error);
+    }
+    EXPECT_THAT(phases, ElementsAre(ozo::trace::phase::send, ozo::trace::phase::flush,
+        ozo::trace::phase::decode, ozo::trace::phase::wait, ozo::trace::phase::request));
+    EXPECT_EQ(spans.back().start, trace.start());
+}
+
+} // namespace
@@ -7,6 +7,8 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <vector>
+
 namespace {
 
 namespace hana = boost::hana;
@@ -20,6 +22,8 @@ using ozo::impl::query_state;
 using ozo::error_code;
 using ozo::time_traits;
 
+using namespace boost::hana::literals;
+
 struct async_request_op : Test {
     StrictMock<connection_gmock> connection {};
     StrictMock<executor_gmock> callback_executor {};
@@ -93,4 +97,46 @@ TEST_F(async_request_op, should_cancel_socket_on_timeout) {
     ozo::impl::async_request_op{fake_query {}, timeout, [] (auto, auto) {}, wrap(callback)}(error_code {}, conn);
 }
 
+TEST_F(async_request_op, should_report_spans_of_request_phases_tagged_with_query_name_and_request_id) {
+    EXPECT_CALL(strand_service, get_executor()).WillRepeatedly(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    Sequence s;
+
+    EXPECT_CALL(timer, expires_after(time_traits::duration(42))).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(timer, async_wait(_)).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(connection, set_nonblocking()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(connection, send_query_params()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, flush_output()).InSequence(s).WillOnce(Return(ozo::impl::query_state::send_finish));
+    EXPECT_CALL(connection, is_busy()).InSequence(s).WillOnce(Return(false));
+    EXPECT_CALL(connection, get_result()).InSequence(s).WillOnce(Return(make_pg_result(PGRES_TUPLES_OK, error_code{})));
+    EXPECT_CALL(connection, is_busy()).InSequence(s).WillOnce(Return(false));
+    EXPECT_CALL(connection, get_result()).InSequence(s).WillOnce(Return(boost::none));
+    EXPECT_CALL(timer, cancel()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(executor, post(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback_executor, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    ozo::trace::tracer::consume([] (const auto&) {});
+    const auto start = time_traits::now();
+    ozo::impl::async_request_op{ozo::impl::make_named_query("traced"_s, ozo::make_query("SELECT 1")),
+        timeout, [] (auto, auto) {}, wrap(callback)}(error_code {}, conn);
+
+    std::vector<ozo::trace::record> spans;
+    ozo::trace::tracer::consume([&] (const ozo::trace::record& r) { spans.push_back(r); });
+    std::vector<ozo::trace::phase> phases;
+    for (const auto& span : spans) {
+        phases.push_back(span.phase);
+        EXPECT_EQ(span.name, "traced");
+        EXPECT_NE(span.request, 0u);
+        EXPECT_EQ(span.request, spans.front().request);
+        EXPECT_LE(span.start, time_traits::now());
+        EXPECT_GE(span.start + span.duration, start);
+        EXPECT_FALSE(span.error);
+    }
+    EXPECT_THAT(phases, ElementsAre(ozo::trace::phase::acquire, ozo::trace::phase::send, ozo::trace::phase::flush,
+        ozo::trace::phase::wait, ozo::trace::phase::decode, ozo::trace::phase::request));
+    EXPECT_EQ(spans.front().start, spans.back().start);
+}
+
 } // namespace
@@ -2,6 +2,7 @@
 #include <test_error.h>
 
 #include <ozo/impl/async_request.h>
+#include <ozo/impl/transaction.h>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -183,4 +184,138 @@ TEST_F(async_send_query_params_op, should_wait_for_write_in_strand) {
     ozo::impl::async_send_query_params_op(m.ctx, fake_query{})();
 }
 
+TEST_F(async_send_query_params_op, should_send_deferred_statements_and_query_in_pipeline) {
+    const InSequence s;
+
+    EXPECT_CALL(m.connection, set_nonblocking()).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, enter_pipeline_mode()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, send_query_params()).Times(3).WillRepeatedly(Return(1));
+    EXPECT_CALL(m.connection, pipeline_sync()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, flush_output())
+        .WillOnce(Return(ozo::impl::query_state::send_finish));
+
+    m.ctx->deferred = {"BEGIN", "COMMIT"};
+    ozo::impl::async_send_query_params_op(m.ctx, fake_query{}).perform();
+
+    EXPECT_EQ(m.ctx->state, ozo::impl::query_state::send_finish);
+}
+
+TEST_F(async_send_query_params_op, should_call_handler_with_error_if_enter_pipeline_mode_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.connection, set_nonblocking()).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, enter_pipeline_mode()).WillOnce(Return(0));
+    EXPECT_CALL(m.socket, cancel(_)).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_pipeline_mode_failed}, _))
+        .WillOnce(Return());
+
+    m.ctx->deferred = {"BEGIN", nullptr};
+    ozo::impl::async_send_query_params_op(m.ctx, fake_query{}).perform();
+
+    EXPECT_EQ(m.ctx->state, ozo::impl::query_state::error);
+}
+
+struct async_send_query_params_op_in_transaction : Test {
+    StrictMock<connection_gmock> connection{};
+    StrictMock<executor_gmock> callback_executor{};
+    StrictMock<executor_gmock> executor{};
+    StrictMock<strand_executor_service_gmock> strand_service{};
+    StrictMock<stream_descriptor_gmock> socket{};
+    StrictMock<steady_timer_gmock> timer{};
+    io_context io{executor, strand_service};
+    execution_context cb_io {callback_executor};
+    decltype(ozo::impl::make_transaction(make_connection(connection, io, socket, timer))) transaction =
+            ozo::impl::make_transaction(make_connection(connection, io, socket, timer));
+    StrictMock<callback_gmock<decltype(transaction)>> callback{};
+
+    auto make_operation_context() {
+        EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+        return ozo::impl::make_request_operation_context(transaction, wrap(callback));
+    }
+
+    void expect_send_failed(Sequence& s) {
+        EXPECT_CALL(connection, exit_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+        EXPECT_CALL(socket, cancel(_)).InSequence(s).WillOnce(Return());
+        EXPECT_CALL(callback, call(_, _)).InSequence(s).WillOnce(Return());
+    }
+
+    ~async_send_query_params_op_in_transaction() {
+        EXPECT_CALL(socket, close(_)).WillOnce(Return());
+    }
+};
+
+TEST_F(async_send_query_params_op_in_transaction, should_take_deferred_statements_when_pipeline_is_sent) {
+    const InSequence s;
+
+    transaction.defer_begin("BEGIN");
+    auto ctx = make_operation_context();
+    ctx->deferred = get_deferred_statements(transaction);
+
+    EXPECT_CALL(connection, set_nonblocking()).WillOnce(Return(0));
+    EXPECT_CALL(connection, enter_pipeline_mode()).WillOnce(Return(1));
+    EXPECT_CALL(connection, send_query_params()).Times(2).WillRepeatedly(Return(1));
+    EXPECT_CALL(connection, pipeline_sync()).WillOnce(Return(1));
+    EXPECT_CALL(connection, flush_output()).WillOnce(Return(ozo::impl::query_state::send_finish));
+
+    ozo::impl::async_send_query_params_op(ctx, fake_query{}).perform();
+
+    EXPECT_FALSE(get_deferred_statements(transaction));
+}
+
+TEST_F(async_send_query_params_op_in_transaction, should_keep_deferred_statements_and_exit_pipeline_mode_if_send_failed) {
+    Sequence s;
+
+    transaction.defer_begin("BEGIN");
+    transaction.defer_commit();
+    auto ctx = make_operation_context();
+    ctx->deferred = get_deferred_statements(transaction);
+
+    EXPECT_CALL(connection, set_nonblocking()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(connection, enter_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, send_query_params()).InSequence(s).WillOnce(Return(1)).WillOnce(Return(0));
+    expect_send_failed(s);
+
+    ozo::impl::async_send_query_params_op(ctx, fake_query{}).perform();
+
+    EXPECT_EQ(ctx->state, ozo::impl::query_state::error);
+    const auto deferred = get_deferred_statements(transaction);
+    EXPECT_STREQ(deferred.prologue, "BEGIN");
+    EXPECT_STREQ(deferred.epilogue, "COMMIT");
+}
+
+TEST_F(async_send_query_params_op_in_transaction, should_keep_deferred_statements_and_exit_pipeline_mode_if_pipeline_sync_failed) {
+    Sequence s;
+
+    transaction.defer_begin("BEGIN");
+    auto ctx = make_operation_context();
+    ctx->deferred = get_deferred_statements(transaction);
+
+    EXPECT_CALL(connection, set_nonblocking()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(connection, enter_pipeline_mode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, send_query_params()).Times(2).InSequence(s).WillRepeatedly(Return(1));
+    EXPECT_CALL(connection, pipeline_sync()).InSequence(s).WillOnce(Return(0));
+    expect_send_failed(s);
+
+    ozo::impl::async_send_query_params_op(ctx, fake_query{}).perform();
+
+    EXPECT_STREQ(get_deferred_statements(transaction).prologue, "BEGIN");
+}
+
+TEST_F(async_send_query_params_op_in_transaction, should_keep_deferred_statements_if_enter_pipeline_mode_failed) {
+    Sequence s;
+
+    transaction.defer_begin("BEGIN");
+    auto ctx = make_operation_context();
+    ctx->deferred = get_deferred_statements(transaction);
+
+    EXPECT_CALL(connection, set_nonblocking()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(connection, enter_pipeline_mode()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(socket, cancel(_)).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(callback, call(error_code{ozo::error::pg_pipeline_mode_failed}, _)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_send_query_params_op(ctx, fake_query{}).perform();
+
+    EXPECT_STREQ(get_deferred_statements(transaction).prologue, "BEGIN");
+}
+
 } // namespace
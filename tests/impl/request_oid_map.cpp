@@ -1,3 +1,4 @@
+#include "connection_mock.h"
 #include "test_asio.h"
 
 #include <ozo/connection_info.h>
@@ -6,6 +7,8 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <vector>
+
 namespace ozo::tests {
 
 struct custom_type1 {};
@@ -87,4 +90,42 @@ TEST(request_oid_map_op, should_call_handler_with_oid_request_failed_error_when_
     operation(ozo::error_code {}, connection {});
 }
 
+TEST(request_oid_map_op, should_report_spans_of_oids_request_with_request_id) {
+    using oid_map_type = decltype(ozo::register_types<custom_type1>());
+    StrictMock<connection_gmock> connection {};
+    StrictMock<executor_gmock> executor {};
+    StrictMock<strand_executor_service_gmock> strand_service {};
+    StrictMock<stream_descriptor_gmock> socket {};
+    StrictMock<steady_timer_gmock> timer {};
+    StrictMock<callback_gmock<connection_ptr<oid_map_type>>> callback {};
+    io_context io {executor, strand_service};
+    auto conn = make_connection<oid_map_type>(connection, io, socket, timer);
+
+    Sequence s;
+    EXPECT_CALL(connection, set_nonblocking()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(connection, send_query_params()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, flush_output()).InSequence(s).WillOnce(Return(ozo::impl::query_state::send_finish));
+    EXPECT_CALL(connection, is_busy()).InSequence(s).WillOnce(Return(false));
+    EXPECT_CALL(connection, get_result()).InSequence(s).WillOnce(Return(make_pg_result(PGRES_TUPLES_OK, {})));
+    EXPECT_CALL(connection, is_busy()).InSequence(s).WillOnce(Return(false));
+    EXPECT_CALL(connection, get_result()).InSequence(s).WillOnce(Return(boost::none));
+    EXPECT_CALL(callback, call(ozo::error_code(ozo::error::oid_request_failed), _)).InSequence(s).WillOnce(Return());
+
+    ozo::trace::tracer::consume([] (const auto&) {});
+    const auto start = ozo::time_traits::now();
+    ozo::impl::request_oid_map_op{wrap(callback)}.perform(conn);
+
+    std::vector<ozo::trace::record> spans;
+    ozo::trace::tracer::consume([&] (const ozo::trace::record& r) { spans.push_back(r); });
+    std::vector<ozo::trace::phase> phases;
+    for (const auto& span : spans) {
+        phases.push_back(span.phase);
+        EXPECT_NE(span.request, 0u);
+        EXPECT_EQ(span.request, spans.front().request);
+        EXPECT_GE(span.start, start);
+    }
+    EXPECT_THAT(phases, ElementsAre(ozo::trace::phase::send, ozo::trace::phase::flush,
+        ozo::trace::phase::wait, ozo::trace::phase::decode, ozo::trace::phase::request));
+}
+
 } // namespace
@@ -71,4 +71,35 @@ TEST_F(impl_transaction, transaction_become_null_after_take_connection) {
     EXPECT_TRUE(is_null(transaction));
 }
 
+TEST_F(impl_transaction, should_keep_deferred_begin_until_taken) {
+    EXPECT_CALL(socket, close(_)).WillOnce(Return());
+    auto transaction = ozo::impl::make_transaction(std::move(conn));
+    transaction.defer_begin("BEGIN");
+
+    EXPECT_TRUE(transaction.is_finished());
+    const auto statements = get_deferred_statements(transaction);
+    EXPECT_STREQ(statements.prologue, "BEGIN");
+    EXPECT_EQ(statements.epilogue, nullptr);
+    EXPECT_STREQ(get_deferred_statements(transaction).prologue, "BEGIN");
+
+    take_deferred_statements(transaction);
+    EXPECT_FALSE(transaction.is_finished());
+    EXPECT_FALSE(get_deferred_statements(transaction));
+}
+
+TEST_F(impl_transaction, should_be_finished_after_deferred_commit_completed) {
+    EXPECT_CALL(socket, close(_)).WillOnce(Return());
+    auto transaction = ozo::impl::make_transaction(std::move(conn));
+    transaction.defer_commit();
+
+    const auto statements = get_deferred_statements(transaction);
+    EXPECT_EQ(statements.prologue, nullptr);
+    EXPECT_STREQ(statements.epilogue, "COMMIT");
+    take_deferred_statements(transaction);
+    EXPECT_FALSE(transaction.is_finished());
+
+    complete_deferred_statements(transaction, statements);
+    EXPECT_TRUE(transaction.is_finished());
+}
+
 } // namespace
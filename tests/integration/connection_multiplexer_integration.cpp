@@ -0,0 +1,121 @@
+#include <ozo/connection_multiplexer.h>
+#include <ozo/execute.h>
+#include <ozo/request.h>
+#include <ozo/shortcuts.h>
+#include <ozo/transaction.h>
+#include <ozo/transaction_status.h>
+
+#include <boost/asio/spawn.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+namespace asio = boost::asio;
+
+using namespace testing;
+
+ozo::connection_multiplexer_config make_config(std::size_t capacity) {
+    ozo::connection_multiplexer_config config;
+    config.capacity = capacity;
+    config.connect_timeout = std::chrono::seconds(10);
+    return config;
+}
+
+TEST(connection_multiplexer, concurrent_requests_should_share_connections) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    const ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+    const ozo::connection_multiplexer mux(conn_info, io, make_config(2));
+
+    std::size_t completed = 0;
+    for (std::int32_t i = 0; i < 20; ++i) {
+        asio::spawn(io, [&, i] (asio::yield_context yield) {
+            ozo::rows_of<std::int32_t> result;
+            ozo::request(mux, "SELECT "_SQL + i, ozo::into(result), yield);
+            ASSERT_EQ(result.size(), 1u);
+            EXPECT_EQ(std::get<0>(result[0]), i);
+            ++completed;
+        });
+    }
+
+    io.run();
+
+    EXPECT_EQ(completed, 20u);
+    EXPECT_LE(mux.size(), 2u);
+}
+
+TEST(connection_multiplexer, failed_request_should_not_affect_others) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    const ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+    const ozo::connection_multiplexer mux(conn_info, io, make_config(1));
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        ozo::error_code ec;
+        ozo::execute(mux, "SELECT 1/0"_SQL, yield[ec]);
+        EXPECT_EQ(ec, ozo::sqlstate::division_by_zero);
+    });
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        ozo::rows_of<std::int32_t> result;
+        ozo::request(mux, "SELECT 1"_SQL, ozo::into(result), yield);
+        EXPECT_EQ(result.size(), 1u);
+    });
+
+    io.run();
+}
+
+TEST(connection_multiplexer, transaction_should_pin_connection) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    const ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+    const ozo::connection_multiplexer mux(conn_info, io, make_config(1));
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        auto transaction = ozo::begin(mux, yield);
+        EXPECT_EQ(ozo::get_transaction_status(transaction), ozo::transaction_status::transaction);
+        ozo::execute(transaction, "SET LOCAL statement_timeout = 1000"_SQL, yield);
+        auto connection = ozo::commit(std::move(transaction), yield);
+        EXPECT_EQ(ozo::get_transaction_status(connection), ozo::transaction_status::idle);
+    });
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        ozo::rows_of<std::int32_t> result;
+        ozo::request(mux, "SELECT 1"_SQL, ozo::into(result), yield);
+        EXPECT_EQ(result.size(), 1u);
+    });
+
+    io.run();
+}
+
+TEST(connection_multiplexer, batched_requests_should_complete) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    const ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+    auto config = make_config(1);
+    config.batch_window = std::chrono::milliseconds(1);
+    config.batch_size = 4;
+    const ozo::connection_multiplexer mux(conn_info, io, config);
+
+    std::size_t completed = 0;
+    for (std::int32_t i = 0; i < 10; ++i) {
+        asio::spawn(io, [&, i] (asio::yield_context yield) {
+            ozo::rows_of<std::int32_t> result;
+            ozo::request(mux, "SELECT "_SQL + i, ozo::into(result), yield);
+            ASSERT_EQ(result.size(), 1u);
+            EXPECT_EQ(std::get<0>(result[0]), i);
+            ++completed;
+        });
+    }
+
+    io.run();
+
+    EXPECT_EQ(completed, 10u);
+    EXPECT_EQ(mux.size(), 1u);
+}
+
+} // namespace
@@ -0,0 +1,88 @@
+#include <ozo/connection_info.h>
+#include <ozo/cursor.h>
+#include <ozo/shortcuts.h>
+#include <ozo/transaction.h>
+
+#include <boost/asio/spawn.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+namespace asio = boost::asio;
+
+using namespace testing;
+
+TEST(cursor, should_fetch_all_rows_in_order) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        auto transaction = ozo::begin(conn_info[io], yield);
+        ozo::cursor_config config;
+        config.initial_batch = 16;
+        config.min_batch = 16;
+        config.max_batch = 256;
+        auto cursor = ozo::declare_cursor<std::int32_t>(std::move(transaction),
+            "SELECT generate_series(1, "_SQL + std::int32_t(1000) + ")"_SQL, config, ozo::none, yield);
+        std::int32_t expected = 1;
+        while (auto row = ozo::fetch(cursor, yield)) {
+            EXPECT_EQ(*row, expected++);
+        }
+        EXPECT_EQ(expected, 1001);
+        transaction = ozo::close_cursor(cursor, yield);
+        ozo::commit(std::move(transaction), yield);
+    });
+
+    io.run();
+}
+
+TEST(cursor, should_fetch_and_close_with_time_constraints) {
+    using namespace ozo::literals;
+    using namespace std::chrono_literals;
+
+    ozo::io_context io;
+    ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        auto transaction = ozo::begin(conn_info[io], yield);
+        auto cursor = ozo::declare_cursor<std::int32_t>(std::move(transaction),
+            "SELECT generate_series(1, "_SQL + std::int32_t(100) + ")"_SQL, 1s, yield);
+        std::int32_t expected = 1;
+        while (auto row = ozo::fetch(cursor, 1s, yield)) {
+            EXPECT_EQ(*row, expected++);
+        }
+        EXPECT_EQ(expected, 101);
+        transaction = ozo::close_cursor(cursor, ozo::time_traits::now() + 1s, yield);
+        ozo::commit(std::move(transaction), yield);
+    });
+
+    io.run();
+}
+
+TEST(cursor, should_provide_error_and_transaction_on_failed_declare) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        auto transaction = ozo::begin(conn_info[io], yield);
+        ozo::error_code ec;
+        auto cursor = ozo::declare_cursor<std::int32_t>(std::move(transaction), "SELECT * FROM ozo_missing_table"_SQL, yield[ec]);
+        EXPECT_TRUE(ec);
+        EXPECT_FALSE(ozo::fetch(cursor, yield[ec]));
+        EXPECT_TRUE(ec);
+        transaction = ozo::close_cursor(cursor, yield[ec]);
+        EXPECT_TRUE(ec);
+        EXPECT_TRUE(transaction);
+        ozo::rollback(std::move(transaction), yield);
+    });
+
+    io.run();
+}
+
+} // namespace
@@ -1,6 +1,13 @@
 #include <ozo/connection_info.h>
 #include <ozo/query_builder.h>
 #include <ozo/execute.h>
+#include <ozo/execute_many.h>
+#include <ozo/ext/std/vector.h>
+#include <ozo/request.h>
+#include <ozo/shortcuts.h>
+#include <ozo/transaction.h>
+
+#include <boost/asio/spawn.hpp>
 
 #include <gtest/gtest.h>
 
@@ -23,4 +30,65 @@ TEST(execute, should_perform_operation_without_result) {
     io.run();
 }
 
+TEST(execute_many, should_insert_all_rows) {
+    using namespace ozo::literals;
+    namespace asio = boost::asio;
+
+    ozo::io_context io;
+    ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        ozo::error_code ec;
+        auto transaction = ozo::begin(conn_info[io], yield[ec]);
+        ASSERT_FALSE(ec) << ec.message();
+        transaction = ozo::execute(std::move(transaction),
+            "CREATE TEMPORARY TABLE execute_many_test (id integer, name text)"_SQL, yield[ec]);
+        ASSERT_FALSE(ec) << ec.message();
+        const std::vector<std::tuple<std::int32_t, std::string>> rows {{1, "a"}, {2, "b"}, {3, "c"}};
+        transaction = ozo::execute_many(std::move(transaction),
+            "INSERT INTO execute_many_test (id, name) VALUES ($1, $2)"_SQL, rows, yield[ec]);
+        ASSERT_FALSE(ec) << ec.message() << " | " << error_message(transaction) << " | " << get_error_context(transaction);
+        transaction = ozo::execute_many(std::move(transaction),
+            "UPDATE execute_many_test SET name = name || $2 WHERE id = $1"_SQL, rows, yield[ec]);
+        ASSERT_FALSE(ec) << ec.message() << " | " << error_message(transaction) << " | " << get_error_context(transaction);
+        ozo::rows_of<std::int32_t, std::string> result;
+        transaction = ozo::request(std::move(transaction),
+            "SELECT id, name FROM execute_many_test ORDER BY id"_SQL, ozo::into(result), yield[ec]);
+        ASSERT_FALSE(ec) << ec.message();
+        EXPECT_EQ(result, (ozo::rows_of<std::int32_t, std::string> {{1, "aa"}, {2, "bb"}, {3, "cc"}}));
+        ozo::rollback(std::move(transaction), yield[ec]);
+    });
+
+    io.run();
+}
+
+TEST(execute_many, should_insert_rows_with_array_fields) {
+    using namespace ozo::literals;
+    namespace asio = boost::asio;
+
+    ozo::io_context io;
+    ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        ozo::error_code ec;
+        auto transaction = ozo::begin(conn_info[io], yield[ec]);
+        ASSERT_FALSE(ec) << ec.message();
+        transaction = ozo::execute(std::move(transaction),
+            "CREATE TEMPORARY TABLE execute_many_arrays_test (id integer, tags text[])"_SQL, yield[ec]);
+        ASSERT_FALSE(ec) << ec.message();
+        const std::vector<std::tuple<std::int32_t, std::vector<std::string>>> rows {{1, {"a", "b"}}, {2, {"c"}}};
+        transaction = ozo::execute_many(std::move(transaction),
+            "INSERT INTO execute_many_arrays_test (id, tags) VALUES ($1, $2)"_SQL, rows, yield[ec]);
+        ASSERT_FALSE(ec) << ec.message() << " | " << error_message(transaction) << " | " << get_error_context(transaction);
+        ozo::rows_of<std::int32_t, std::vector<std::string>> result;
+        transaction = ozo::request(std::move(transaction),
+            "SELECT id, tags FROM execute_many_arrays_test ORDER BY id"_SQL, ozo::into(result), yield[ec]);
+        ASSERT_FALSE(ec) << ec.message();
+        EXPECT_EQ(result, rows);
+        ozo::rollback(std::move(transaction), yield[ec]);
+    });
+
+    io.run();
+}
+
 } // namespace
@@ -0,0 +1,60 @@
+#include <ozo/connection_info.h>
+#include <ozo/execute.h>
+#include <ozo/listen.h>
+#include <ozo/query_builder.h>
+
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+namespace asio = boost::asio;
+
+TEST(listen, should_receive_notification_with_payload) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+    auto listener = ozo::listen(ozo::make_connector(conn_info, io), {"ozo_listen_test"}, io);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        ozo::error_code ec;
+        ozo::notification received;
+        asio::spawn(io, [&] (asio::yield_context yield) {
+            ozo::error_code ec;
+            received = ozo::receive(listener, yield[ec]);
+            EXPECT_FALSE(ec) << ec.message();
+            listener.close();
+        });
+        for (int i = 0; i < 100 && received.channel.empty(); ++i) {
+            ozo::execute(ozo::make_connector(conn_info, io), "NOTIFY ozo_listen_test, 'payload'"_SQL, yield[ec]);
+            ASSERT_FALSE(ec) << ec.message();
+            asio::steady_timer timer(io, std::chrono::milliseconds(10));
+            timer.async_wait(yield);
+        }
+        EXPECT_EQ(received.channel, "ozo_listen_test");
+        EXPECT_EQ(received.payload, "payload");
+        EXPECT_NE(received.backend_pid, 0);
+    });
+
+    io.run();
+}
+
+TEST(listen, receive_should_complete_with_operation_aborted_after_close) {
+    ozo::io_context io;
+    ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+    auto listener = ozo::listen(ozo::make_connector(conn_info, io), {"ozo_listen_test"}, io);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        listener.close();
+        ozo::error_code ec;
+        ozo::receive(listener, yield[ec]);
+        EXPECT_EQ(ec, asio::error::operation_aborted);
+    });
+
+    io.run();
+}
+
+} // namespace
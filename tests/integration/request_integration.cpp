@@ -1,12 +1,18 @@
+#include <ozo/borrowed_rows.h>
 #include <ozo/connection_info.h>
 #include <ozo/connection_pool.h>
 #include <ozo/query_builder.h>
 #include <ozo/request.h>
 #include <ozo/execute.h>
+#include <ozo/hedged_request.h>
+#include <ozo/multi_request.h>
+#include <ozo/result_cache.h>
 #include <ozo/shortcuts.h>
+#include <ozo/single_flight.h>
 #include <ozo/pg/jsonb.h>
 
 #include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -355,6 +361,24 @@ TEST(result, should_send_bytea_properly) {
     io.run();
 }
 
+TEST(result, should_send_bytea_by_reference) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+
+    std::vector<std::tuple<ozo::pg::bytea>> res;
+    const auto arr = ozo::pg::bytea(std::vector<char>(1024 * 1024, 'x'));
+    ozo::request(ozo::make_connector(conn_info, io), "SELECT "_SQL + ozo::ref(arr), std::back_inserter(res),
+            [&](ozo::error_code ec, auto conn) {
+        ASSERT_REQUEST_OK(ec, conn);
+        ASSERT_EQ(1u, res.size());
+        EXPECT_EQ(std::get<0>(res[0]).get(), arr.get());
+    });
+
+    io.run();
+}
+
 TEST(request, should_send_empty_optional) {
     using namespace ozo::literals;
     using namespace std::string_literals;
@@ -463,6 +487,25 @@ TEST(request, should_send_and_receive_jsonb) {
     io.run();
 }
 
+TEST(request, should_receive_borrowed_text_and_jsonb) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    const ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+    const auto timeout = ozo::time_traits::duration::max();
+
+    ozo::borrowed_rows_of<std::string_view, ozo::pg::jsonb_view> result;
+    ozo::request(ozo::make_connector(conn_info, io), R"(SELECT 'text', '{"foo": "bar"}'::jsonb)"_SQL,
+            timeout, ozo::into(result), [&](ozo::error_code ec, auto conn) {
+        ASSERT_REQUEST_OK(ec, conn);
+        ASSERT_EQ(1u, result.size());
+        EXPECT_EQ(std::get<0>(result[0]), "text");
+        EXPECT_EQ(std::get<1>(result[0]).raw_string(), R"({"foo": "bar"})");
+    });
+
+    io.run();
+}
+
 TEST(request, should_send_and_receive_composite_with_jsonb_field) {
     using namespace ozo::literals;
     using namespace std::string_literals;
@@ -501,4 +544,138 @@ TEST(request, should_send_and_receive_composite_with_jsonb_field) {
     io.run();
 }
 
+TEST(multi_request, should_return_result_set_per_query) {
+    namespace asio = boost::asio;
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        rows_of<std::int32_t, std::string> header;
+        rows_of<std::int32_t> items;
+        ozo::error_code ec;
+        auto conn = ozo::multi_request(ozo::make_connector(conn_info, io),
+            hana::make_tuple("SELECT "_SQL + std::int32_t(1) + ", 'header'::text"_SQL,
+                             "SELECT generate_series(1, 3)"_SQL),
+            hana::make_tuple(ozo::into(header), ozo::into(items)),
+            yield[ec]);
+
+        ASSERT_REQUEST_OK(ec, conn);
+        EXPECT_THAT(header, ElementsAre(std::make_tuple(1, "header")));
+        EXPECT_THAT(items, ElementsAre(std::make_tuple(1), std::make_tuple(2), std::make_tuple(3)));
+    });
+
+    io.run();
+}
+
+TEST(multi_request, should_return_error_of_failed_query) {
+    namespace asio = boost::asio;
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        rows_of<std::int32_t> first;
+        rows_of<std::int32_t> second;
+        ozo::error_code ec;
+        ozo::multi_request(ozo::make_connector(conn_info, io),
+            hana::make_tuple("SELECT 1/0"_SQL, "SELECT 1"_SQL),
+            hana::make_tuple(ozo::into(first), ozo::into(second)),
+            yield[ec]);
+
+        EXPECT_EQ(ec, ozo::sqlstate::division_by_zero);
+        EXPECT_TRUE(second.empty());
+    });
+
+    io.run();
+}
+
+TEST(single_flight_request, should_provide_same_result_to_concurrent_callers) {
+    namespace asio = boost::asio;
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+    ozo::single_flight group;
+    std::vector<ozo::shared_result> results;
+
+    for (int i = 0; i < 3; ++i) {
+        asio::spawn(io, [&] (asio::yield_context yield) {
+            ozo::error_code ec;
+            auto res = ozo::single_flight_request(group, ozo::make_connector(conn_info, io),
+                "SELECT "_SQL + std::int32_t(42), yield[ec]);
+            ASSERT_FALSE(ec) << ec.message();
+            rows_of<std::int32_t> rows;
+            ozo::recv_result(res, ozo::empty_oid_map{}, ozo::into(rows));
+            EXPECT_THAT(rows, ElementsAre(std::make_tuple(42)));
+            results.push_back(res);
+        });
+    }
+
+    io.run();
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0].handle(), results[1].handle());
+    EXPECT_EQ(results[1].handle(), results[2].handle());
+}
+
+TEST(cached_request, should_provide_cached_result_until_notification) {
+    namespace asio = boost::asio;
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+    ozo::result_cache cache;
+
+    ozo::invalidate_on_notify(cache, ozo::make_connector(conn_info, io), {"ozo_cache_test"},
+        [] (ozo::error_code, auto) {});
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        ozo::error_code ec;
+        const auto first = ozo::cached_request(cache, ozo::make_connector(conn_info, io),
+            "SELECT "_SQL + std::int32_t(42), yield[ec]);
+        ASSERT_FALSE(ec) << ec.message();
+        const auto second = ozo::cached_request(cache, ozo::make_connector(conn_info, io),
+            "SELECT "_SQL + std::int32_t(42), yield[ec]);
+        ASSERT_FALSE(ec) << ec.message();
+        EXPECT_EQ(first.handle(), second.handle());
+        rows_of<std::int32_t> rows;
+        ozo::recv_result(second, ozo::empty_oid_map{}, ozo::into(rows));
+        EXPECT_THAT(rows, ElementsAre(std::make_tuple(42)));
+
+        ozo::execute(ozo::make_connector(conn_info, io), "NOTIFY ozo_cache_test"_SQL, yield[ec]);
+        ASSERT_FALSE(ec) << ec.message();
+        for (int i = 0; i < 100 && cache.size() != 0; ++i) {
+            asio::steady_timer timer(io, std::chrono::milliseconds(10));
+            timer.async_wait(yield);
+        }
+        EXPECT_EQ(cache.size(), 0u);
+        io.stop();
+    });
+
+    io.run();
+}
+
+TEST(hedged_request, should_return_first_result_when_request_is_hedged) {
+    namespace asio = boost::asio;
+    using namespace ozo::literals;
+    using namespace std::chrono_literals;
+
+    ozo::io_context io;
+    ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+    ozo::hedging_policy policy(io, {95, 32, 10ms, 1ms});
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        ozo::error_code ec;
+        rows_of<std::int32_t> rows;
+        auto conn = ozo::hedged_request(policy, ozo::make_connector(conn_info, io),
+            ozo::make_connector(conn_info, io), "SELECT "_SQL + std::int32_t(42) + " FROM pg_sleep(0.1)"_SQL, 5s, ozo::into(rows), yield[ec]);
+        ASSERT_REQUEST_OK(ec, conn);
+        EXPECT_THAT(rows, ElementsAre(std::make_tuple(42)));
+    });
+
+    io.run();
+}
+
 } // namespace
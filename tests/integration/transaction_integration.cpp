@@ -2,7 +2,9 @@
 #include <ozo/query_builder.h>
 #include <ozo/result.h>
 #include <ozo/request.h>
+#include <ozo/shortcuts.h>
 #include <ozo/transaction.h>
+#include <ozo/transaction_status.h>
 
 #include <boost/asio/spawn.hpp>
 
@@ -54,4 +56,26 @@ TEST(transaction, create_schema_in_transaction_and_rollback_then_table_should_no
     io.run();
 }
 
+TEST(transaction, deferred_begin_and_commit_should_be_executed_with_request) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info<> conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        auto transaction = ozo::begin(ozo::make_connector(conn_info, io), ozo::deferred, yield);
+        ASSERT_TRUE(transaction);
+        ozo::defer_commit(transaction);
+        ozo::rows_of<std::int32_t> result;
+        ozo::request(transaction, "SELECT 1"_SQL, ozo::into(result), yield);
+        EXPECT_EQ(ozo::get_transaction_status(transaction), ozo::transaction_status::idle);
+        ASSERT_EQ(result.size(), 1u);
+        EXPECT_EQ(std::get<0>(result[0]), 1);
+        auto connection = ozo::commit(std::move(transaction), yield);
+        EXPECT_EQ(ozo::get_transaction_status(connection), ozo::transaction_status::idle);
+    });
+
+    io.run();
+}
+
 } // namespace
@@ -0,0 +1,232 @@
+#include <connection_mock.h>
+
+#include <ozo/listen.h>
+#include <ozo/connection_info.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+TEST(quote_identifier, should_enclose_name_in_double_quotes) {
+    EXPECT_EQ(ozo::impl::quote_identifier("channel"), "\"channel\"");
+}
+
+TEST(quote_identifier, should_double_quotes_within_name) {
+    EXPECT_EQ(ozo::impl::quote_identifier("my\"channel"), "\"my\"\"channel\"");
+}
+
+TEST(make_listen_query, should_return_listen_statement_for_quoted_channel) {
+    const auto query = ozo::impl::make_listen_query("Channel");
+    EXPECT_EQ(std::string(ozo::to_const_char(ozo::get_text(query))), "LISTEN \"Channel\"");
+}
+
+TEST(listener_state, receive_should_complete_with_operation_aborted_after_close) {
+    ozo::io_context io;
+    auto state = std::make_shared<ozo::impl::listener_state<ozo::connection_info<>>>(
+        ozo::connection_info<>(""), std::vector<std::string>{"channel"}, io, ozo::listener_config{});
+    state->close();
+    ozo::error_code result;
+    state->receive([&] (ozo::error_code ec, ozo::notification) { result = ec; });
+    io.run();
+    EXPECT_EQ(result, boost::asio::error::operation_aborted);
+    EXPECT_TRUE(state->closed());
+}
+
+TEST(listener_state, close_should_complete_pending_receive_with_operation_aborted) {
+    ozo::io_context io;
+    auto state = std::make_shared<ozo::impl::listener_state<ozo::connection_info<>>>(
+        ozo::connection_info<>(""), std::vector<std::string>{"channel"}, io, ozo::listener_config{});
+    ozo::error_code result;
+    state->receive([&] (ozo::error_code ec, ozo::notification) { result = ec; });
+    state->close();
+    io.run();
+    EXPECT_EQ(result, boost::asio::error::operation_aborted);
+}
+
+using ozo::error_code;
+using ozo::tests::connection_ptr;
+
+struct listener_provider_mock {
+    using connection_type = connection_ptr<>;
+};
+
+struct listener_subscriptions {
+    std::vector<std::function<void(error_code, connection_ptr<>)>> connect;
+    std::function<bool(const ozo::notification&)> on_notify;
+    std::function<void(error_code, connection_ptr<>)> listen;
+    std::vector<std::string> channels;
+};
+
+struct listener_operations_mock {
+    listener_subscriptions* subscriptions;
+
+    template <typename TimeConstraint, typename Handler>
+    void get_connection(listener_provider_mock&, TimeConstraint, Handler&& handler) const {
+        subscriptions->connect.emplace_back(std::forward<Handler>(handler));
+    }
+
+    template <typename OnNotify, typename TimeConstraint, typename Handler>
+    void listen(connection_ptr<>, std::vector<std::string> channels, OnNotify&& on_notify,
+            TimeConstraint, Handler&& handler) const {
+        subscriptions->channels = std::move(channels);
+        subscriptions->on_notify = std::forward<OnNotify>(on_notify);
+        subscriptions->listen = std::forward<Handler>(handler);
+    }
+};
+
+using listener_state_type = ozo::impl::listener_state<listener_provider_mock, listener_operations_mock>;
+
+struct listener_state_test : Test {
+    ozo::io_context io;
+    StrictMock<ozo::tests::connection_gmock> connection {};
+    StrictMock<ozo::tests::executor_gmock> executor {};
+    StrictMock<ozo::tests::strand_executor_service_gmock> strand_service {};
+    StrictMock<ozo::tests::stream_descriptor_gmock> socket {};
+    StrictMock<ozo::tests::steady_timer_gmock> timer {};
+    ozo::tests::io_context mock_io {executor, strand_service};
+    listener_subscriptions subscriptions;
+    std::vector<std::pair<error_code, ozo::notification>> received;
+    std::shared_ptr<listener_state_type> state;
+
+    void start(ozo::listener_config config = ozo::listener_config {}) {
+        config.reconnect_delay = ozo::time_traits::duration::zero();
+        state = std::make_shared<listener_state_type>(listener_provider_mock {},
+            std::vector<std::string> {"channel"}, io, config, listener_operations_mock {&subscriptions});
+        state->subscribe();
+        poll();
+    }
+
+    void connect() {
+        ASSERT_FALSE(subscriptions.connect.empty());
+        auto handler = std::move(subscriptions.connect.back());
+        subscriptions.connect.pop_back();
+        handler(error_code {}, ozo::tests::make_connection(connection, mock_io, socket, timer));
+        poll();
+    }
+
+    void notify(const std::string& payload) {
+        ASSERT_TRUE(subscriptions.on_notify);
+        EXPECT_TRUE(subscriptions.on_notify(ozo::notification {"channel", payload, 42}));
+    }
+
+    void receive() {
+        state->receive([this] (error_code ec, ozo::notification n) {
+            received.emplace_back(ec, std::move(n));
+        });
+        poll();
+    }
+
+    void poll() {
+        io.restart();
+        io.poll();
+    }
+};
+
+TEST_F(listener_state_test, should_listen_to_channels_on_connection) {
+    start();
+    connect();
+    EXPECT_THAT(subscriptions.channels, ElementsAre("channel"));
+}
+
+TEST_F(listener_state_test, should_deliver_notification_to_pending_receive) {
+    start();
+    connect();
+    receive();
+    EXPECT_TRUE(received.empty());
+
+    notify("payload");
+    poll();
+
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_FALSE(received[0].first);
+    EXPECT_EQ(received[0].second.channel, "channel");
+    EXPECT_EQ(received[0].second.payload, "payload");
+    EXPECT_EQ(received[0].second.backend_pid, 42);
+}
+
+TEST_F(listener_state_test, should_queue_notifications_until_received_in_order) {
+    start();
+    connect();
+    notify("first");
+    notify("second");
+    receive();
+    receive();
+
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[0].second.payload, "first");
+    EXPECT_EQ(received[1].second.payload, "second");
+}
+
+TEST_F(listener_state_test, should_provide_notifications_lost_and_resubscribe_when_connection_is_lost) {
+    start();
+    connect();
+    notify("before");
+
+    EXPECT_CALL(socket, close(_)).WillOnce(Return());
+    std::exchange(subscriptions.listen, {})(boost::asio::error::connection_reset,
+        ozo::tests::make_connection(connection, mock_io, socket, timer));
+    poll();
+    EXPECT_EQ(subscriptions.connect.size(), 1u);
+
+    connect();
+    notify("after");
+    receive();
+    receive();
+    receive();
+
+    ASSERT_EQ(received.size(), 3u);
+    EXPECT_EQ(received[0].second.payload, "before");
+    EXPECT_EQ(received[1].first, ozo::error::notifications_lost);
+    EXPECT_EQ(received[2].second.payload, "after");
+}
+
+TEST_F(listener_state_test, should_not_provide_notifications_lost_when_connection_was_not_established) {
+    start();
+    ASSERT_EQ(subscriptions.connect.size(), 1u);
+    std::exchange(subscriptions.connect[0], {})(boost::asio::error::connection_refused, nullptr);
+    subscriptions.connect.clear();
+    poll();
+    connect();
+    notify("payload");
+    receive();
+
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_FALSE(received[0].first);
+    EXPECT_EQ(received[0].second.payload, "payload");
+}
+
+TEST_F(listener_state_test, should_replace_queued_notifications_with_notifications_lost_when_queue_is_full) {
+    ozo::listener_config config;
+    config.max_queue_size = 2;
+    start(config);
+    connect();
+    notify("first");
+    notify("second");
+    notify("third");
+    receive();
+    receive();
+
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[0].first, ozo::error::notifications_lost);
+    EXPECT_EQ(received[1].second.payload, "third");
+}
+
+TEST_F(listener_state_test, should_complete_replaced_receive_with_operation_aborted) {
+    start();
+    connect();
+    receive();
+    receive();
+
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0].first, boost::asio::error::operation_aborted);
+
+    notify("payload");
+    poll();
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[1].second.payload, "payload");
+}
+
+} // namespace
@@ -618,6 +618,18 @@ TEST(query_repository_make_query, should_return_query_for_query_conf_with_single
     );
 }
 
+TEST(query_repository_make_query, should_return_named_query_convertible_to_query) {
+    const auto repository = ozo::make_query_repository(
+        "-- name: query with one parameter\n"
+        "SELECT :0::integer",
+        hana::tuple<query_with_one_parameter>()
+    );
+    const auto named = repository.make_query<query_with_one_parameter>(42);
+    EXPECT_EQ(ozo::get_query_name(named), "query with one parameter");
+    const ozo::impl::query<std::string_view, int> query = named;
+    EXPECT_EQ(query, ozo::make_query("SELECT $1::integer", 42));
+}
+
 TEST(query_repository_make_query, should_return_query_for_query_conf_with_single_query_with_one_parameter) {
     const auto repository = ozo::make_query_repository(
         "-- name: query with one parameter\n"
@@ -0,0 +1,101 @@
+#include <ozo/query_statistics.h>
+#include <ozo/wire/connection.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+namespace hana = boost::hana;
+
+TEST(query_statistics, should_be_enabled_statistics) {
+    EXPECT_TRUE(ozo::StatisticsEnabled<ozo::query_statistics>);
+}
+
+TEST(query_statistics, should_aggregate_events_by_query_name) {
+    ozo::query_statistics stats;
+    stats.collect(ozo::event::query{1ms, {}, "first"});
+    stats.collect(ozo::event::decode{1ms, 3, 30, "first"});
+    stats.collect(ozo::event::query{2ms, ozo::error::pg_flush_failed, "first"});
+    stats.collect(ozo::event::query{3ms, {}, "second"});
+    stats.collect(ozo::event::send{1ms, 100});
+
+    const auto s = stats.snapshot();
+    ASSERT_THAT(s, ElementsAre(Key("first"), Key("second")));
+    const auto& first = s.at("first");
+    EXPECT_EQ(first.queries, 2u);
+    EXPECT_EQ(first.errors, 1u);
+    EXPECT_EQ(first.rows, 3u);
+    EXPECT_EQ(first.bytes, 30u);
+    EXPECT_EQ(first.query_time.count, 2u);
+    EXPECT_EQ(first.query_time.max, std::uint64_t(ozo::time_traits::duration(2ms).count()));
+    EXPECT_EQ(first.decode_time.count, 1u);
+    EXPECT_EQ(s.at("second").queries, 1u);
+}
+
+TEST(query_statistics, should_account_unnamed_queries_under_empty_name) {
+    ozo::query_statistics stats;
+    stats.collect(ozo::event::query{1ms, {}, {}});
+    EXPECT_EQ(stats.snapshot("").queries, 1u);
+}
+
+TEST(query_statistics, snapshot_for_unknown_name_should_be_empty) {
+    ozo::query_statistics stats;
+    stats.collect(ozo::event::query{1ms, {}, "first"});
+    EXPECT_EQ(stats.snapshot("second").queries, 0u);
+}
+
+TEST(query_statistics, should_merge_shards_of_all_threads) {
+    ozo::query_statistics stats;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; ++i) {
+                stats.collect(ozo::event::query{1ms, {}, "query"});
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    const auto s = stats.snapshot("query");
+    EXPECT_EQ(s.queries, 4000u);
+    EXPECT_EQ(s.query_time.count, 4000u);
+}
+
+TEST(query_statistics, copies_should_share_registry) {
+    ozo::query_statistics prototype;
+    auto copy = prototype;
+    copy.collect(ozo::event::query{1ms, {}, "query"});
+    EXPECT_EQ(prototype.snapshot("query").queries, 1u);
+}
+
+TEST(query_statistics, should_not_mix_different_registries) {
+    ozo::query_statistics first;
+    ozo::query_statistics second;
+    first.collect(ozo::event::query{1ms, {}, "query"});
+    EXPECT_EQ(first.snapshot("query").queries, 1u);
+    EXPECT_TRUE(second.snapshot().empty());
+}
+
+TEST(query_statistics, should_collect_events_as_value_of_statistics_map) {
+    using connection = ozo::wire::connection_impl<ozo::empty_oid_map,
+        decltype(hana::make_map(
+            hana::make_pair(hana::int_c<0>, ozo::connection_statistics{}),
+            hana::make_pair(hana::int_c<1>, ozo::query_statistics{})
+        ))>;
+    ozo::io_context io;
+    ozo::query_statistics by_query;
+    auto conn = std::make_shared<connection>(io, hana::make_map(
+        hana::make_pair(hana::int_c<0>, ozo::connection_statistics{}),
+        hana::make_pair(hana::int_c<1>, by_query)
+    ));
+    ozo::collect_statistics(conn, ozo::event::query{1ms, {}, "query"});
+    EXPECT_EQ(by_query.snapshot("query").queries, 1u);
+}
+
+} // namespace
@@ -0,0 +1,193 @@
+#include <ozo/result_cache.h>
+#include <ozo/connection_info.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+using clock_type = ozo::impl::result_cache_shard::clock;
+
+ozo::shared_result make_result() {
+    return ozo::shared_result(std::shared_ptr<PGresult>(ozo::native_result_handle(PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK))));
+}
+
+struct result_cache_shard : Test {
+    ozo::impl::result_cache_shard shard;
+    const clock_type::time_point now = clock_type::now();
+};
+
+TEST_F(result_cache_shard, find_should_return_inserted_result) {
+    const auto result = make_result();
+    shard.insert("key", result, 10, now + 1s, 100);
+    const auto found = shard.find("key", now);
+    ASSERT_TRUE(found);
+    EXPECT_EQ(found->handle(), result.handle());
+}
+
+TEST_F(result_cache_shard, find_should_return_empty_for_unknown_key) {
+    shard.insert("key", make_result(), 10, now + 1s, 100);
+    EXPECT_FALSE(shard.find("other", now));
+}
+
+TEST_F(result_cache_shard, find_should_evict_expired_result) {
+    shard.insert("key", make_result(), 10, now + 1s, 100);
+    EXPECT_FALSE(shard.find("key", now + 1s));
+    EXPECT_EQ(shard.size(), 0u);
+    EXPECT_EQ(shard.memory(), 0u);
+}
+
+TEST_F(result_cache_shard, insert_should_evict_least_recently_used_results_over_budget) {
+    shard.insert("first", make_result(), 40, now + 1s, 100);
+    shard.insert("second", make_result(), 40, now + 1s, 100);
+    shard.find("first", now);
+    shard.insert("third", make_result(), 40, now + 1s, 100);
+    EXPECT_TRUE(shard.find("first", now));
+    EXPECT_FALSE(shard.find("second", now));
+    EXPECT_TRUE(shard.find("third", now));
+    EXPECT_EQ(shard.memory(), 80u);
+}
+
+TEST_F(result_cache_shard, insert_should_skip_result_over_budget) {
+    shard.insert("key", make_result(), 101, now + 1s, 100);
+    EXPECT_FALSE(shard.find("key", now));
+    EXPECT_EQ(shard.memory(), 0u);
+}
+
+TEST_F(result_cache_shard, insert_should_replace_result_of_same_key) {
+    shard.insert("key", make_result(), 10, now + 1s, 100);
+    const auto result = make_result();
+    shard.insert("key", result, 20, now + 1s, 100);
+    EXPECT_EQ(shard.find("key", now)->handle(), result.handle());
+    EXPECT_EQ(shard.size(), 1u);
+    EXPECT_EQ(shard.memory(), 20u);
+}
+
+TEST_F(result_cache_shard, clear_should_remove_all_results) {
+    shard.insert("first", make_result(), 10, now + 1s, 100);
+    shard.insert("second", make_result(), 10, now + 1s, 100);
+    shard.clear();
+    EXPECT_EQ(shard.size(), 0u);
+    EXPECT_EQ(shard.memory(), 0u);
+}
+
+TEST(result_cache_state, find_should_return_inserted_result) {
+    ozo::impl::result_cache_state state({});
+    const auto result = make_result();
+    state.insert("key", result, state.generation());
+    const auto found = state.find("key");
+    ASSERT_TRUE(found);
+    EXPECT_EQ(found->handle(), result.handle());
+    EXPECT_GT(state.memory(), 0u);
+}
+
+TEST(result_cache_state, insert_should_skip_result_requested_before_invalidation) {
+    ozo::impl::result_cache_state state({});
+    const auto generation = state.generation();
+    state.invalidate();
+    state.insert("key", make_result(), generation);
+    EXPECT_FALSE(state.find("key"));
+}
+
+struct waiter_mock : ozo::impl::single_flight_waiter {
+    void operator() (ozo::error_code, ozo::shared_result) override {}
+};
+
+TEST(result_cache_state, request_after_invalidation_should_not_join_request_started_before_it) {
+    ozo::impl::result_cache_state state({});
+    const auto generation = state.generation();
+    EXPECT_TRUE(state.flights()->join(state.flight_key("key", generation), std::make_unique<waiter_mock>()));
+    EXPECT_FALSE(state.flights()->join(state.flight_key("key", state.generation()), std::make_unique<waiter_mock>()));
+    state.invalidate();
+    EXPECT_TRUE(state.flights()->join(state.flight_key("key", state.generation()), std::make_unique<waiter_mock>()));
+    EXPECT_EQ(state.flights()->size(), 2u);
+}
+
+TEST(result_cache_state, join_after_invalidate_should_not_insert_result_requested_before_it) {
+    ozo::impl::result_cache_state state({});
+    const auto leader_generation = state.generation();
+    state.flights()->join(state.flight_key("key", leader_generation), std::make_unique<waiter_mock>());
+    state.invalidate();
+    const auto follower_generation = state.generation();
+    state.flights()->join(state.flight_key("key", follower_generation), std::make_unique<waiter_mock>());
+
+    state.insert("key", make_result(), leader_generation);
+    EXPECT_FALSE(state.find("key"));
+    state.insert("key", make_result(), follower_generation);
+    EXPECT_TRUE(state.find("key"));
+}
+
+TEST(result_cache_state, invalidate_should_remove_all_results) {
+    ozo::impl::result_cache_state state({});
+    state.insert("first", make_result(), state.generation());
+    state.insert("second", make_result(), state.generation());
+    state.invalidate();
+    EXPECT_EQ(state.size(), 0u);
+}
+
+TEST(result_cache_state, insert_should_skip_empty_result) {
+    ozo::impl::result_cache_state state({});
+    state.insert("key", ozo::shared_result{}, state.generation());
+    EXPECT_EQ(state.size(), 0u);
+}
+
+struct provider_mock {
+    using connection_type = ozo::connection_info<>::connection_type;
+
+    ozo::io_context& io;
+    std::size_t& requests;
+
+    auto get_executor() const noexcept { return io.get_executor(); }
+
+    template <typename TimeConstraint, typename Handler>
+    void async_get_connection(TimeConstraint, Handler&& handler) const {
+        ++requests;
+        ozo::asio::post(io, ozo::detail::bind(std::forward<Handler>(handler),
+            ozo::error_code{ozo::error::pq_connection_start_failed}, connection_type{}));
+    }
+};
+
+struct async_cached_request : Test {
+    ozo::io_context io;
+    std::size_t requests = 0;
+    std::shared_ptr<ozo::impl::result_cache_state> state = std::make_shared<ozo::impl::result_cache_state>(
+        ozo::result_cache_config{});
+    const decltype(ozo::make_query("SELECT $1", 42)) query = ozo::make_query("SELECT $1", 42);
+    std::vector<std::pair<ozo::error_code, ozo::shared_result>> calls;
+
+    void request() {
+        ozo::impl::async_cached_request(state, provider_mock {io, requests}, query, ozo::none,
+            [this] (ozo::error_code ec, ozo::shared_result result) { calls.emplace_back(ec, std::move(result)); });
+    }
+};
+
+TEST_F(async_cached_request, should_provide_cached_result_via_provider_executor_without_request) {
+    const auto result = make_result();
+    state->insert(ozo::impl::make_keyed_request<provider_mock>(query).key, result, state->generation());
+    request();
+    EXPECT_TRUE(calls.empty());
+    io.run();
+    ASSERT_EQ(calls.size(), 1u);
+    EXPECT_EQ(calls[0].first, ozo::error_code{});
+    EXPECT_EQ(calls[0].second.handle(), result.handle());
+    EXPECT_EQ(requests, 0u);
+}
+
+TEST_F(async_cached_request, should_request_provider_on_miss_and_not_cache_error) {
+    request();
+    io.run();
+    ASSERT_EQ(calls.size(), 1u);
+    EXPECT_EQ(calls[0].first, ozo::error_code{ozo::error::pq_connection_start_failed});
+    EXPECT_EQ(requests, 1u);
+    EXPECT_EQ(state->size(), 0u);
+
+    request();
+    io.restart();
+    io.run();
+    EXPECT_EQ(calls.size(), 2u);
+    EXPECT_EQ(requests, 2u);
+}
+
+} // namespace
@@ -0,0 +1,177 @@
+#include <ozo/single_flight.h>
+#include <ozo/connection_info.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace ozo::tests {
+
+struct single_flight_custom_type {};
+
+} // namespace ozo::tests
+
+OZO_PG_DEFINE_CUSTOM_TYPE(ozo::tests::single_flight_custom_type, "single_flight_custom_type")
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+using namespace boost::hana::literals;
+
+template <typename Query>
+std::string make_key(const Query& query) {
+    return ozo::impl::make_request_key(ozo::binary_query(query, ozo::empty_oid_map{}));
+}
+
+TEST(make_request_key, should_be_equal_for_same_text_and_params) {
+    EXPECT_EQ(make_key(ozo::make_query("SELECT $1, $2", 42, std::string("foo"))),
+        make_key(ozo::make_query("SELECT $1, $2", 42, std::string("foo"))));
+}
+
+TEST(make_request_key, should_differ_for_different_text) {
+    EXPECT_NE(make_key(ozo::make_query("SELECT $1", 42)), make_key(ozo::make_query("SELECT $1 + 1", 42)));
+}
+
+TEST(make_request_key, should_differ_for_different_params) {
+    EXPECT_NE(make_key(ozo::make_query("SELECT $1", 42)), make_key(ozo::make_query("SELECT $1", 43)));
+}
+
+TEST(make_request_key, should_differ_for_params_of_different_types) {
+    EXPECT_NE(make_key(ozo::make_query("SELECT $1", std::int32_t(42))),
+        make_key(ozo::make_query("SELECT $1", std::int64_t(42))));
+}
+
+TEST(make_request_key, should_differ_for_null_and_empty_params) {
+    EXPECT_NE(make_key(ozo::make_query("SELECT $1", __OZO_STD_OPTIONAL<std::string>{})),
+        make_key(ozo::make_query("SELECT $1", __OZO_STD_OPTIONAL<std::string>{""})));
+}
+
+struct waiter_mock : ozo::impl::single_flight_waiter {
+    std::vector<ozo::error_code>& calls;
+
+    explicit waiter_mock(std::vector<ozo::error_code>& calls) : calls(calls) {}
+
+    void operator() (ozo::error_code ec, ozo::shared_result) override {
+        calls.push_back(ec);
+    }
+};
+
+TEST(single_flight_state, join_should_return_true_for_first_waiter_only) {
+    ozo::impl::single_flight_state state;
+    std::vector<ozo::error_code> calls;
+    EXPECT_TRUE(state.join("key", std::make_unique<waiter_mock>(calls)));
+    EXPECT_FALSE(state.join("key", std::make_unique<waiter_mock>(calls)));
+    EXPECT_TRUE(state.join("other", std::make_unique<waiter_mock>(calls)));
+    EXPECT_EQ(state.size(), 2u);
+}
+
+TEST(single_flight_state, complete_should_call_all_waiters_of_request) {
+    ozo::impl::single_flight_state state;
+    std::vector<ozo::error_code> calls;
+    state.join("key", std::make_unique<waiter_mock>(calls));
+    state.join("key", std::make_unique<waiter_mock>(calls));
+    state.join("other", std::make_unique<waiter_mock>(calls));
+    state.complete("key", ozo::error::bad_result_process, ozo::shared_result{});
+    EXPECT_THAT(calls, ElementsAre(ozo::error::bad_result_process, ozo::error::bad_result_process));
+    EXPECT_EQ(state.size(), 1u);
+}
+
+TEST(make_keyed_request, should_reuse_encoded_query_for_empty_oid_map) {
+    const auto query = ozo::make_query("SELECT $1", 42);
+    auto request = ozo::impl::make_keyed_request<ozo::connection_info<>>(query);
+    EXPECT_TRUE(ozo::impl::EncodedQuery<decltype(request.query)>);
+    EXPECT_EQ(request.key, make_key(query));
+    const auto binary = ozo::impl::make_binary_query(std::move(request.query), ozo::empty_oid_map{},
+        std::allocator<char>{});
+    EXPECT_EQ(ozo::impl::make_request_key(binary), make_key(query));
+}
+
+TEST(make_keyed_request, should_keep_name_of_encoded_query) {
+    const auto query = ozo::impl::make_named_query("named query"_s, ozo::make_query("SELECT $1", 42));
+    const auto request = ozo::impl::make_keyed_request<ozo::connection_info<>>(query);
+    EXPECT_EQ(ozo::trace::query_name(request.query), "named query");
+}
+
+TEST(make_keyed_request, should_not_reuse_encoded_query_for_oid_map_with_custom_types) {
+    using oid_map = decltype(ozo::register_types<ozo::tests::single_flight_custom_type>());
+    const auto query = ozo::make_query("SELECT $1", 42);
+    const auto request = ozo::impl::make_keyed_request<ozo::connection_info<oid_map>>(query);
+    EXPECT_TRUE((std::is_same_v<std::decay_t<decltype(request.query)>, std::decay_t<decltype(query)>>));
+    EXPECT_EQ(request.key, make_key(query));
+}
+
+TEST(single_flight_state, leave_should_remove_waiter_and_keep_request_in_flight) {
+    ozo::impl::single_flight_state state;
+    std::vector<ozo::error_code> calls;
+    const ozo::impl::single_flight_state::waiter_ptr first = std::make_unique<waiter_mock>(calls);
+    const ozo::impl::single_flight_state::waiter_ptr second = std::make_unique<waiter_mock>(calls);
+    state.join("key", first);
+    state.join("key", second);
+    EXPECT_TRUE(state.leave("key", second));
+    EXPECT_FALSE(state.leave("key", second));
+    EXPECT_FALSE(state.join("key", std::make_unique<waiter_mock>(calls)));
+    state.complete("key", {}, ozo::shared_result{});
+    EXPECT_THAT(calls, ElementsAre(ozo::error_code{}, ozo::error_code{}));
+    EXPECT_FALSE(state.leave("key", first));
+}
+
+struct single_flight_waiter_impl : Test {
+    ozo::io_context io;
+    std::shared_ptr<ozo::impl::single_flight_state> state = std::make_shared<ozo::impl::single_flight_state>();
+    std::vector<ozo::error_code> calls;
+
+    auto make_waiter() {
+        auto handler = ozo::asio::bind_executor(io.get_executor(),
+            [this] (ozo::error_code ec, ozo::shared_result) { calls.push_back(ec); });
+        return ozo::impl::make_single_flight_waiter(std::move(handler), io.get_executor());
+    }
+};
+
+TEST_F(single_flight_waiter_impl, should_leave_request_with_operation_aborted_on_deadline) {
+    const auto leader = make_waiter();
+    const auto follower = make_waiter();
+    follower->expires_at(ozo::time_traits::now() - 1s, state, "key");
+    state->join("key", leader);
+    state->join("key", follower);
+    io.poll();
+    EXPECT_THAT(calls, ElementsAre(ozo::error_code(boost::asio::error::operation_aborted)));
+    EXPECT_EQ(state->size(), 1u);
+
+    state->complete("key", {}, ozo::shared_result{});
+    io.restart();
+    io.poll();
+    EXPECT_THAT(calls, ElementsAre(ozo::error_code(boost::asio::error::operation_aborted), ozo::error_code{}));
+}
+
+TEST_F(single_flight_waiter_impl, should_cancel_timer_on_request_completion) {
+    const auto follower = make_waiter();
+    follower->expires_at(ozo::time_traits::now() + 1h, state, "key");
+    state->join("key", follower);
+    state->complete("key", {}, ozo::shared_result{});
+    io.run();
+    EXPECT_THAT(calls, ElementsAre(ozo::error_code{}));
+}
+
+TEST_F(single_flight_waiter_impl, should_complete_handler_without_executor_on_provider_executor) {
+    const auto provider = ozo::connection_info<>("")[io];
+    auto handler = [this] (ozo::error_code ec, ozo::shared_result) { calls.push_back(ec); };
+    const auto executor = ozo::asio::get_associated_executor(handler, ozo::get_provider_executor(provider));
+    EXPECT_EQ(executor, io.get_executor());
+    const auto waiter = ozo::impl::make_single_flight_waiter(std::move(handler), executor);
+    waiter->expires_at(ozo::time_traits::now() + 1h, state, "key");
+    state->join("key", waiter);
+    state->complete("key", {}, ozo::shared_result{});
+    EXPECT_TRUE(calls.empty());
+    io.run();
+    EXPECT_THAT(calls, ElementsAre(ozo::error_code{}));
+}
+
+TEST(single_flight_state, join_after_complete_should_return_true) {
+    ozo::impl::single_flight_state state;
+    std::vector<ozo::error_code> calls;
+    state.join("key", std::make_unique<waiter_mock>(calls));
+    state.complete("key", {}, ozo::shared_result{});
+    EXPECT_TRUE(state.join("key", std::make_unique<waiter_mock>(calls)));
+}
+
+} // namespace
@@ -0,0 +1,230 @@
+#include <connection_mock.h>
+
+#include <ozo/impl/async_connect.h>
+#include <ozo/statistics.h>
+#include <ozo/wire/connection.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+namespace hana = boost::hana;
+
+struct statistics_mock {
+    MOCK_METHOD1(collect, void(const ozo::event::query&));
+    MOCK_METHOD1(collect, void(const ozo::event::connect&));
+};
+
+TEST(StatisticsEnabled, should_be_false_for_no_statistics) {
+    EXPECT_FALSE(ozo::StatisticsEnabled<ozo::no_statistics>);
+}
+
+TEST(StatisticsEnabled, should_be_true_for_connection_statistics) {
+    EXPECT_TRUE(ozo::StatisticsEnabled<ozo::connection_statistics>);
+}
+
+TEST(StatisticsEnabled, should_be_true_for_non_empty_map) {
+    using map = decltype(hana::make_map(hana::make_pair(hana::int_c<0>, ozo::connection_statistics{})));
+    EXPECT_TRUE(ozo::StatisticsEnabled<map>);
+}
+
+TEST(ConnectionStatisticsEnabled, should_be_false_for_connection_without_statistics_member) {
+    EXPECT_FALSE(ozo::ConnectionStatisticsEnabled<ozo::tests::connection_ptr<>>);
+}
+
+TEST(ConnectionStatisticsEnabled, should_be_true_for_connection_with_statistics) {
+    using connection = ozo::wire::connection_impl<ozo::empty_oid_map, ozo::connection_statistics>;
+    EXPECT_TRUE(ozo::ConnectionStatisticsEnabled<std::shared_ptr<connection>>);
+    EXPECT_FALSE((ozo::ConnectionStatisticsEnabled<ozo::wire::connection_impl<ozo::empty_oid_map, ozo::no_statistics>>));
+}
+
+TEST(collect_statistics_impl, should_call_collect_member_function) {
+    StrictMock<statistics_mock> mock;
+    EXPECT_CALL(mock, collect(An<const ozo::event::query&>())).WillOnce(Return());
+    ozo::collect_statistics_impl<statistics_mock>::apply(mock, ozo::event::query{});
+}
+
+TEST(collect_statistics_impl, should_call_collect_for_each_value_of_map) {
+    StrictMock<statistics_mock> first, second;
+    auto map = hana::make_map(
+        hana::make_pair(hana::int_c<0>, std::shared_ptr<statistics_mock>(&first, [](auto) {})),
+        hana::make_pair(hana::int_c<1>, std::shared_ptr<statistics_mock>(&second, [](auto) {}))
+    );
+    EXPECT_CALL(first, collect(An<const ozo::event::connect&>())).WillOnce(Return());
+    EXPECT_CALL(second, collect(An<const ozo::event::connect&>())).WillOnce(Return());
+    ozo::collect_statistics_impl<decltype(map)>::apply(map, ozo::event::connect{});
+}
+
+TEST(collect_statistics_impl, should_do_nothing_for_null_shared_ptr) {
+    std::shared_ptr<statistics_mock> ptr;
+    ozo::collect_statistics_impl<decltype(ptr)>::apply(ptr, ozo::event::query{});
+}
+
+TEST(statistics_counters, should_count_events) {
+    ozo::statistics_counters counters;
+    counters.collect(ozo::event::connect{10ms, {}});
+    counters.collect(ozo::event::acquire{1ms});
+    counters.collect(ozo::event::send{2ms, 100});
+    counters.collect(ozo::event::first_byte{3ms});
+    counters.collect(ozo::event::decode{4ms, 5, 200});
+    counters.collect(ozo::event::query{5ms, {}});
+
+    const auto s = counters.snapshot();
+    EXPECT_EQ(s.connects, 1u);
+    EXPECT_EQ(s.queries, 1u);
+    EXPECT_EQ(s.errors, 0u);
+    EXPECT_EQ(s.rows, 5u);
+    EXPECT_EQ(s.bytes_sent, 100u);
+    EXPECT_EQ(s.bytes_received, 200u);
+    EXPECT_EQ(s.connect_time.max, std::uint64_t(ozo::time_traits::duration(10ms).count()));
+    EXPECT_EQ(s.acquire_time.count, 1u);
+    EXPECT_EQ(s.send_time.count, 1u);
+    EXPECT_EQ(s.first_byte_time.count, 1u);
+    EXPECT_EQ(s.decode_time.count, 1u);
+    EXPECT_EQ(s.query_time.count, 1u);
+}
+
+TEST(statistics_counters, should_count_errors_by_sqlstate_class) {
+    ozo::statistics_counters counters;
+    counters.collect(ozo::event::query{1ms, ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table)});
+    counters.collect(ozo::event::query{1ms, ozo::sqlstate::make_error_code(ozo::sqlstate::syntax_error)});
+    counters.collect(ozo::event::query{1ms, ozo::sqlstate::make_error_code(ozo::sqlstate::serialization_failure)});
+    counters.collect(ozo::event::connect{1ms, ozo::error::pq_connect_poll_failed});
+
+    const auto s = counters.snapshot();
+    EXPECT_EQ(s.errors, 4u);
+    EXPECT_THAT(s.errors_by_class, ElementsAre(Pair("40", 1u), Pair("42", 2u), Pair("other", 1u)));
+}
+
+TEST(statistics_snapshot, should_be_aggregated_with_plus) {
+    ozo::statistics_counters a, b;
+    a.collect(ozo::event::query{1ms, ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table)});
+    b.collect(ozo::event::query{2ms, {}});
+    const auto s = a.snapshot() + b.snapshot();
+    EXPECT_EQ(s.queries, 2u);
+    EXPECT_EQ(s.query_time.count, 2u);
+    EXPECT_THAT(s.errors_by_class, ElementsAre(Pair("42", 1u)));
+}
+
+TEST(connection_statistics, copy_should_share_source_counters_and_have_own_connection_counters) {
+    ozo::connection_statistics prototype;
+    auto first = prototype;
+    auto second = prototype;
+    first.collect(ozo::event::query{1ms, {}});
+    second.collect(ozo::event::query{1ms, {}});
+    second.collect(ozo::event::query{1ms, {}});
+
+    EXPECT_EQ(prototype.source().snapshot().queries, 3u);
+    EXPECT_EQ(prototype.connection().snapshot().queries, 0u);
+    EXPECT_EQ(first.connection().snapshot().queries, 1u);
+    EXPECT_EQ(second.connection().snapshot().queries, 2u);
+}
+
+TEST(connection_statistics, move_should_keep_counters_and_leave_source_usable) {
+    ozo::connection_statistics prototype;
+    auto first = prototype;
+    first.collect(ozo::event::query{1ms, {}});
+    auto second = std::move(first);
+    first.collect(ozo::event::query{1ms, {}});
+
+    EXPECT_EQ(second.connection().snapshot().queries, 1u);
+    EXPECT_EQ(first.connection().snapshot().queries, 1u);
+    EXPECT_EQ(prototype.source().snapshot().queries, 2u);
+
+    second = std::move(first);
+    first.collect(ozo::event::query{1ms, {}});
+    EXPECT_EQ(second.connection().snapshot().queries, 1u);
+    EXPECT_EQ(first.connection().snapshot().queries, 1u);
+    EXPECT_EQ(prototype.source().snapshot().queries, 3u);
+}
+
+TEST(get_statistics, should_return_no_statistics_for_connection_without_statistics_member) {
+    EXPECT_TRUE((std::is_same_v<decltype(ozo::get_statistics(std::declval<ozo::tests::connection_ptr<>&>())),
+        ozo::no_statistics>));
+}
+
+TEST(collect_statistics, should_report_event_to_connection_statistics) {
+    ozo::io_context io;
+    using connection = ozo::wire::connection_impl<ozo::empty_oid_map, ozo::connection_statistics>;
+    ozo::connection_statistics prototype;
+    auto conn = std::make_shared<connection>(io, prototype);
+    ozo::collect_statistics(conn, ozo::event::query{1ms, {}});
+    EXPECT_EQ(ozo::get_statistics(conn).connection().snapshot().queries, 1u);
+    EXPECT_EQ(prototype.source().snapshot().queries, 1u);
+}
+
+using connection_with_statistics = ozo::tests::connection<ozo::empty_oid_map, ozo::connection_statistics>;
+
+struct statistics_of_operations : Test {
+    StrictMock<ozo::tests::connection_gmock> connection {};
+    StrictMock<ozo::tests::executor_gmock> executor {};
+    StrictMock<ozo::tests::executor_gmock> strand {};
+    StrictMock<ozo::tests::strand_executor_service_gmock> strand_service {};
+    StrictMock<ozo::tests::stream_descriptor_gmock> socket {};
+    StrictMock<ozo::tests::steady_timer_gmock> timer {};
+    ozo::tests::io_context io {executor, strand_service};
+    ozo::connection_statistics prototype;
+    std::shared_ptr<connection_with_statistics> conn = std::make_shared<connection_with_statistics>(
+        connection_with_statistics {
+            {prototype},
+            std::make_unique<ozo::tests::native_handle>(ozo::tests::native_handle::good),
+            ozo::tests::stream_descriptor {io, socket},
+            ozo::empty_oid_map {},
+            std::addressof(connection),
+            "",
+            ozo::tests::steady_timer {&timer}
+        });
+};
+
+TEST_F(statistics_of_operations, should_report_connect_and_request_events_to_source_statistics) {
+    EXPECT_TRUE(ozo::ConnectionStatisticsEnabled<decltype(conn)>);
+    EXPECT_CALL(strand_service, get_executor()).WillRepeatedly(ReturnRef(strand));
+    EXPECT_CALL(strand, post(_)).WillRepeatedly(InvokeArgument<0>());
+    EXPECT_CALL(executor, post(_)).WillRepeatedly(InvokeArgument<0>());
+    EXPECT_CALL(timer, expires_after(_)).WillRepeatedly(Return(0));
+    EXPECT_CALL(timer, async_wait(_)).WillRepeatedly(Return());
+    EXPECT_CALL(timer, cancel()).WillRepeatedly(Return(0));
+
+    Sequence s;
+
+    EXPECT_CALL(connection, start_connection("conninfo")).InSequence(s).WillOnce(Return(ozo::error_code{}));
+    EXPECT_CALL(connection, assign_socket()).InSequence(s).WillOnce(Return(ozo::error_code{}));
+    EXPECT_CALL(socket, async_write_some(_)).InSequence(s).WillOnce(InvokeArgument<0>(ozo::error_code{}));
+    EXPECT_CALL(connection, connect_poll()).InSequence(s).WillOnce(Return(PGRES_POLLING_OK));
+
+    EXPECT_CALL(connection, set_nonblocking()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(connection, send_query_params()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, flush_output()).InSequence(s).WillOnce(Return(ozo::impl::query_state::send_finish));
+    EXPECT_CALL(connection, is_busy()).InSequence(s).WillOnce(Return(true));
+    EXPECT_CALL(socket, async_read_some(_)).InSequence(s).WillOnce(InvokeArgument<0>(ozo::error_code{}));
+    EXPECT_CALL(connection, consume_input()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, is_busy()).InSequence(s).WillOnce(Return(false));
+    EXPECT_CALL(connection, get_result()).InSequence(s)
+        .WillOnce(Return(ozo::tests::make_pg_result(PGRES_TUPLES_OK, {})));
+    EXPECT_CALL(connection, is_busy()).InSequence(s).WillOnce(Return(false));
+    EXPECT_CALL(connection, get_result()).InSequence(s).WillOnce(Return(boost::none));
+
+    std::vector<ozo::error_code> calls;
+    ozo::impl::async_connect("conninfo", ozo::time_traits::duration(42), conn,
+        [&] (ozo::error_code ec, auto) { calls.push_back(ec); });
+    ozo::impl::async_request_op {ozo::tests::fake_query {}, ozo::time_traits::duration(42),
+        [] (auto, auto) {}, [&] (ozo::error_code ec, auto) { calls.push_back(ec); }}(ozo::error_code {}, conn);
+
+    EXPECT_THAT(calls, ElementsAre(ozo::error_code{}, ozo::error_code{}));
+    const auto source = prototype.source().snapshot();
+    EXPECT_EQ(source.connects, 1u);
+    EXPECT_EQ(source.connect_time.count, 1u);
+    EXPECT_EQ(source.acquire_time.count, 1u);
+    EXPECT_EQ(source.send_time.count, 1u);
+    EXPECT_EQ(source.first_byte_time.count, 1u);
+    EXPECT_EQ(source.decode_time.count, 1u);
+    EXPECT_EQ(source.queries, 1u);
+    EXPECT_EQ(source.query_time.count, 1u);
+    EXPECT_EQ(source.errors, 0u);
+    EXPECT_EQ(ozo::get_statistics(conn).connection().snapshot().queries, 1u);
+}
+
+} // namespace
@@ -0,0 +1,107 @@
+#include <ozo/trace.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <sstream>
+#include <thread>
+
+namespace {
+
+using namespace testing;
+using namespace boost::hana::literals;
+
+struct named_query {
+    static constexpr auto name = "named query"_s;
+};
+
+struct tracer_mock {
+    static constexpr bool enabled = true;
+    static std::vector<ozo::trace::record>& records() {
+        static std::vector<ozo::trace::record> retval;
+        return retval;
+    }
+    static void record(const ozo::trace::record& r) noexcept { records().push_back(r); }
+};
+
+struct disabled_tracer_mock : tracer_mock {
+    static constexpr bool enabled = false;
+};
+
+TEST(query_name, should_return_name_of_named_query) {
+    EXPECT_EQ(ozo::trace::query_name(named_query{}), "named query");
+}
+
+TEST(query_name, should_return_empty_string_for_unnamed_query) {
+    EXPECT_EQ(ozo::trace::query_name(ozo::make_query("SELECT 1")), "");
+}
+
+TEST(query_name, should_return_name_of_query_made_with_name) {
+    const auto query = ozo::impl::make_named_query("named query"_s, ozo::make_query("SELECT 1"));
+    EXPECT_TRUE(ozo::Query<decltype(query)>);
+    EXPECT_EQ(ozo::trace::query_name(query), "named query");
+}
+
+TEST(request, should_be_empty_for_disabled_tracer) {
+    EXPECT_TRUE(std::is_empty_v<ozo::trace::request<disabled_tracer_mock>>);
+    EXPECT_TRUE(std::is_empty_v<ozo::trace::request<ozo::trace::no_tracer>>);
+}
+
+TEST(request, span_should_do_nothing_for_disabled_tracer) {
+    tracer_mock::records().clear();
+    const ozo::trace::request<disabled_tracer_mock> request("query");
+    request.span(ozo::trace::phase::send, request.now());
+    EXPECT_TRUE(tracer_mock::records().empty());
+}
+
+TEST(request, span_should_record_phase_tagged_with_query_name_and_request_id) {
+    tracer_mock::records().clear();
+    const ozo::trace::request<tracer_mock> first("first");
+    const ozo::trace::request<tracer_mock> second("second");
+    const auto start = first.now();
+    first.span(ozo::trace::phase::send, start);
+    second.span(ozo::trace::phase::request, second.start(), ozo::error::pg_flush_failed);
+
+    ASSERT_EQ(tracer_mock::records().size(), 2u);
+    const auto& a = tracer_mock::records()[0];
+    const auto& b = tracer_mock::records()[1];
+    EXPECT_EQ(a.name, "first");
+    EXPECT_EQ(a.phase, ozo::trace::phase::send);
+    EXPECT_FALSE(a.error);
+    EXPECT_EQ(a.start, start);
+    EXPECT_GE(a.duration.count(), 0);
+    EXPECT_EQ(b.name, "second");
+    EXPECT_EQ(b.phase, ozo::trace::phase::request);
+    EXPECT_TRUE(b.error);
+    EXPECT_NE(a.request, b.request);
+}
+
+TEST(record, should_be_written_as_json_object) {
+    const ozo::trace::record r {"my \"query\"", 7, ozo::trace::phase::wait, true,
+        ozo::time_traits::time_point(std::chrono::nanoseconds(100)), std::chrono::nanoseconds(42)};
+    std::ostringstream out;
+    out << r;
+    EXPECT_EQ(out.str(), R"({"name":"my \"query\"","request":7,"phase":"wait","error":true,"start_ns":100,"duration_ns":42})");
+}
+
+TEST(ring_buffer_tracer, export_spans_should_write_spans_recorded_by_all_threads) {
+    std::ostringstream previous;
+    ozo::trace::export_spans<ozo::trace::ring_buffer_tracer>(previous);
+    const ozo::trace::request<ozo::trace::ring_buffer_tracer> request("query");
+    request.span(ozo::trace::phase::acquire, request.start());
+    std::thread([&] { request.span(ozo::trace::phase::decode, request.now()); }).join();
+
+    std::ostringstream out;
+    EXPECT_EQ(ozo::trace::export_spans<ozo::trace::ring_buffer_tracer>(out), 2u);
+    EXPECT_THAT(out.str(), HasSubstr(R"("phase":"acquire")"));
+    EXPECT_THAT(out.str(), HasSubstr(R"("phase":"decode")"));
+    EXPECT_EQ(ozo::trace::export_spans<ozo::trace::ring_buffer_tracer>(out), 0u);
+}
+
+TEST(no_tracer, export_spans_should_write_nothing) {
+    std::ostringstream out;
+    EXPECT_EQ(ozo::trace::export_spans<ozo::trace::no_tracer>(out), 0u);
+    EXPECT_TRUE(out.str().empty());
+}
+
+} // namespace
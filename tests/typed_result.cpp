@@ -0,0 +1,149 @@
+#include "result_mock.h"
+
+#include <ozo/typed_result.h>
+#include <ozo/ext/std.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+BOOST_FUSION_DEFINE_STRUCT((),
+    fusion_adapted_typed_row,
+    (std::string, text)
+    (int32_t, digit)
+)
+
+struct hana_adapted_typed_row {
+    BOOST_HANA_DEFINE_STRUCT(hana_adapted_typed_row,
+        (std::string, text),
+        (int32_t, digit)
+    );
+};
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+using namespace std::literals;
+
+template <typename Row>
+using typed_result = ozo::basic_typed_result<Row, ozo::empty_oid_map, ozo::basic_result<pg_result_mock*>>;
+
+struct basic_typed_result : Test {
+    ozo::empty_oid_map oid_map{};
+    StrictMock<pg_result_mock> mock{};
+    ozo::basic_result<pg_result_mock*> res{&mock};
+
+    const char int32_bytes[4] = { 0x00, 0x00, 0x00, 0x07 };
+    const char* text_bytes = "text";
+
+    void expect_columns() {
+        EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(2));
+        EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(3));
+        EXPECT_CALL(mock, field_number(Eq("digit"s))).WillRepeatedly(Return(0));
+        EXPECT_CALL(mock, field_number(Eq("text"s))).WillRepeatedly(Return(1));
+        EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(INT4OID));
+        EXPECT_CALL(mock, field_type(1)).WillRepeatedly(Return(TEXTOID));
+    }
+
+    void expect_values() {
+        EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+        EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+        EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+        EXPECT_CALL(mock, get_value(_, 1)).WillRepeatedly(Return(text_bytes));
+        EXPECT_CALL(mock, get_length(_, 1)).WillRepeatedly(Return(4));
+        EXPECT_CALL(mock, get_isnull(_, 1)).WillRepeatedly(Return(false));
+    }
+};
+
+TEST_F(basic_typed_result, should_throw_range_error_if_size_of_tuple_does_not_equal_to_columns_count) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_THROW((typed_result<std::tuple<std::int32_t, std::string>>(res, oid_map)), std::range_error);
+}
+
+TEST_F(basic_typed_result, should_throw_system_error_if_column_oid_does_not_match_the_field_type) {
+    expect_columns();
+    EXPECT_THROW((typed_result<std::tuple<std::int32_t, std::int32_t>>(res, oid_map)), ozo::system_error);
+}
+
+TEST_F(basic_typed_result, should_throw_range_error_if_column_of_adapted_structure_field_is_not_found) {
+    expect_columns();
+    EXPECT_CALL(mock, field_number(Eq("text"s))).WillRepeatedly(Return(-1));
+    EXPECT_THROW(typed_result<fusion_adapted_typed_row>(res, oid_map), std::range_error);
+}
+
+TEST_F(basic_typed_result, should_have_size_of_the_result) {
+    expect_columns();
+    const typed_result<std::tuple<std::int32_t, std::string>> typed(res, oid_map);
+    EXPECT_EQ(typed.size(), 3u);
+    EXPECT_EQ(std::distance(typed.begin(), typed.end()), 3);
+}
+
+TEST_F(basic_typed_result, should_receive_only_accessed_field) {
+    expect_columns();
+    EXPECT_CALL(mock, get_value(1, 1)).WillOnce(Return(text_bytes));
+    EXPECT_CALL(mock, get_length(1, 1)).WillOnce(Return(4));
+    EXPECT_CALL(mock, get_isnull(1, 1)).WillOnce(Return(false));
+
+    const typed_result<std::tuple<std::int32_t, std::string>> typed(res, oid_map);
+    EXPECT_EQ(typed[1].get<1>(), "text");
+}
+
+TEST_F(basic_typed_result, should_check_null_without_receiving_field) {
+    expect_columns();
+    EXPECT_CALL(mock, get_isnull(2, 0)).WillOnce(Return(true));
+
+    const typed_result<std::tuple<__OZO_STD_OPTIONAL<std::int32_t>, std::string>> typed(res, oid_map);
+    EXPECT_TRUE(typed[2].is_null<0>());
+}
+
+TEST_F(basic_typed_result, should_decode_tuple_row) {
+    expect_columns();
+    expect_values();
+
+    const typed_result<std::tuple<std::int32_t, std::string>> typed(res, oid_map);
+    std::vector<std::tuple<std::int32_t, std::string>> got;
+    for (const auto row : typed) {
+        got.push_back(row.decode());
+    }
+    EXPECT_THAT(got, ElementsAre(std::make_tuple(7, "text"s), std::make_tuple(7, "text"s), std::make_tuple(7, "text"s)));
+}
+
+TEST_F(basic_typed_result, should_receive_fields_of_fusion_adapted_structure_by_column_names) {
+    expect_columns();
+    expect_values();
+
+    const typed_result<fusion_adapted_typed_row> typed(res, oid_map);
+    EXPECT_EQ(typed[0].get<0>(), "text");
+    EXPECT_EQ(typed[0].get<1>(), 7);
+    const auto row = typed.at(2).decode();
+    EXPECT_EQ(row.text, "text");
+    EXPECT_EQ(row.digit, 7);
+}
+
+TEST_F(basic_typed_result, should_receive_fields_of_hana_adapted_structure_by_column_names) {
+    expect_columns();
+    expect_values();
+
+    const typed_result<hana_adapted_typed_row> typed(res, oid_map);
+    EXPECT_EQ(typed[0].get<0>(), "text");
+    EXPECT_EQ(typed[0].get<1>(), 7);
+    const auto row = typed[1].decode();
+    EXPECT_EQ(row.text, "text");
+    EXPECT_EQ(row.digit, 7);
+}
+
+TEST_F(basic_typed_result, should_throw_out_of_range_for_index_out_of_range) {
+    expect_columns();
+    const typed_result<std::tuple<std::int32_t, std::string>> typed(res, oid_map);
+    EXPECT_THROW(typed.at(3), std::out_of_range);
+}
+
+TEST_F(basic_typed_result, recv_result_should_move_result_into_typed_result) {
+    expect_columns();
+    typed_result<std::tuple<std::int32_t, std::string>> typed;
+    ozo::recv_result(res, oid_map, std::ref(typed));
+    EXPECT_EQ(typed.result().handle(), &mock);
+    EXPECT_EQ(typed.size(), 3u);
+}
+
+} // namespace
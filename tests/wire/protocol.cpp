@@ -0,0 +1,405 @@
+#include <ozo/wire/connection_info.h>
+#include <ozo/detail/md5.h>
+#include <ozo/ext/std/optional.h>
+#include <ozo/ext/std/tuple.h>
+#include <ozo/io/recv.h>
+#include <ozo/listen.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <boost/asio/write.hpp>
+
+#include <sys/socket.h>
+
+namespace {
+
+using namespace testing;
+using namespace ozo::wire;
+
+std::vector<char> row_description(std::initializer_list<std::pair<std::string, ozo::oid_t>> columns) {
+    std::vector<char> out;
+    frontend::writer w{out};
+    w.begin('T').int16(static_cast<std::int16_t>(columns.size()));
+    for (const auto& [name, oid] : columns) {
+        w.string(name).int32(0).int16(0).int32(static_cast<std::int32_t>(oid)).int16(-1).int32(-1).int16(1);
+    }
+    w.end();
+    return out;
+}
+
+std::vector<char> data_row(std::int32_t id, const char* name) {
+    std::vector<char> out;
+    frontend::writer w{out};
+    w.begin('D').int16(2).int32(4).int32(id);
+    if (name) {
+        w.int32(static_cast<std::int32_t>(std::strlen(name))).bytes(name, std::strlen(name));
+    } else {
+        w.int32(-1);
+    }
+    w.end();
+    return out;
+}
+
+std::vector<char> command_complete(const char* tag) {
+    std::vector<char> out;
+    frontend::writer{out}.begin('C').string(tag).end();
+    return out;
+}
+
+std::vector<char> ready_for_query(char status = 'I') {
+    std::vector<char> out;
+    frontend::writer{out}.begin('Z').byte(status).end();
+    return out;
+}
+
+std::vector<char> error_response(const char* sqlstate, const char* message) {
+    std::vector<char> out;
+    frontend::writer{out}.begin('E').byte('S').string("ERROR").byte('C').string(sqlstate)
+        .byte('M').string(message).byte('\0').end();
+    return out;
+}
+
+std::vector<char> concat(std::initializer_list<std::vector<char>> messages) {
+    std::vector<char> out;
+    for (const auto& m : messages) {
+        out.insert(out.end(), m.begin(), m.end());
+    }
+    return out;
+}
+
+struct ready_session : Test {
+    session s;
+
+    ready_session() {
+        s.set_state(session::state::ready);
+    }
+
+    void send_query() {
+        ASSERT_TRUE(s.send_query("SELECT", 0, nullptr, nullptr, nullptr, nullptr));
+    }
+
+    void consume(const std::vector<char>& in) {
+        ASSERT_TRUE(s.consume(in.data(), in.size()));
+    }
+};
+
+TEST(md5, should_produce_rfc1321_test_suite_digests) {
+    EXPECT_EQ(ozo::detail::md5_hex(""), "d41d8cd98f00b204e9800998ecf8427e");
+    EXPECT_EQ(ozo::detail::md5_hex("abc"), "900150983cd24fb0d6963f7d28e17f72");
+    EXPECT_EQ(ozo::detail::md5_hex(
+        "12345678901234567890123456789012345678901234567890123456789012345678901234567890"),
+        "57edf4a22be3c955ac49da2e2107b67a");
+}
+
+TEST(frontend_writer, should_back_patch_message_length) {
+    std::vector<char> out;
+    frontend::write_query(out, "BEGIN");
+    EXPECT_THAT(out, ElementsAre('Q', 0, 0, 0, 10, 'B', 'E', 'G', 'I', 'N', '\0'));
+}
+
+TEST(frontend_writer, write_extended_query_should_produce_parse_bind_describe_execute_sync) {
+    std::vector<char> out;
+    const ozo::oid_t types[] = {23};
+    const char value[] = {0, 0, 0, 7};
+    const char* const values[] = {value};
+    const int lengths[] = {4};
+    const int formats[] = {1};
+    frontend::write_extended_query(out, "SELECT $1", 1, types, values, lengths, formats);
+
+    std::vector<char> types_sequence;
+    std::size_t pos = 0;
+    backend::message m;
+    while (const auto n = backend::parse_message(out.data() + pos, out.size() - pos, m)) {
+        types_sequence.push_back(m.type);
+        pos += n;
+    }
+    EXPECT_EQ(pos, out.size());
+    EXPECT_THAT(types_sequence, ElementsAre('P', 'B', 'D', 'E', 'S'));
+}
+
+TEST(parse_message, should_return_zero_for_incomplete_message) {
+    const auto in = command_complete("SELECT 1");
+    backend::message m;
+    EXPECT_EQ(backend::parse_message(in.data(), in.size() - 1, m), 0u);
+    EXPECT_EQ(backend::parse_message(in.data(), 3, m), 0u);
+}
+
+TEST(parse_message, should_throw_on_malformed_length) {
+    const char in[] = {'C', 0, 0, 0, 1};
+    backend::message m;
+    EXPECT_THROW(backend::parse_message(in, sizeof(in), m), ozo::system_error);
+}
+
+TEST(reader, should_throw_on_read_beyond_message) {
+    const char body[] = {0, 1};
+    backend::reader in{backend::message{'D', body, sizeof(body)}};
+    EXPECT_EQ(in.int16(), 1);
+    EXPECT_THROW(in.byte(), ozo::system_error);
+}
+
+TEST(parse_conninfo, should_parse_keyword_value_pairs) {
+    const auto info = parse_conninfo("host=db.local port=6432 user='john doe' password=s\\ ecret dbname=test application_name=app");
+    ASSERT_TRUE(info);
+    EXPECT_EQ(info->host, "db.local");
+    EXPECT_EQ(info->port, "6432");
+    EXPECT_EQ(info->user, "john doe");
+    EXPECT_EQ(info->password, "s ecret");
+    EXPECT_EQ(info->dbname, "test");
+    EXPECT_EQ(info->options.at("application_name"), "app");
+    EXPECT_EQ(info->unix_socket_path(), "");
+}
+
+TEST(parse_conninfo, should_make_unix_socket_path_for_directory_host) {
+    const auto info = parse_conninfo("host=/var/run/postgresql port=5433");
+    ASSERT_TRUE(info);
+    EXPECT_EQ(info->unix_socket_path(), "/var/run/postgresql/.s.PGSQL.5433");
+}
+
+TEST(parse_conninfo, should_return_nullopt_for_malformed_string) {
+    EXPECT_FALSE(parse_conninfo("host"));
+    EXPECT_FALSE(parse_conninfo("host='localhost"));
+    EXPECT_FALSE(parse_conninfo("=localhost"));
+}
+
+TEST_F(ready_session, should_be_busy_until_result_is_received) {
+    send_query();
+    EXPECT_TRUE(s.is_busy());
+    consume(concat({row_description({{"id", 23}}), command_complete("SELECT 0")}));
+    EXPECT_FALSE(s.is_busy());
+}
+
+TEST_F(ready_session, get_result_should_return_rows_followed_by_null_result) {
+    send_query();
+    consume(concat({
+        row_description({{"id", 23}, {"name", 25}}),
+        data_row(1, "one"),
+        data_row(2, nullptr),
+        command_complete("SELECT 2"),
+        ready_for_query(),
+    }));
+
+    auto res = s.get_result();
+    ASSERT_TRUE(res);
+    EXPECT_EQ(pq_result_status(*res), PGRES_TUPLES_OK);
+    EXPECT_EQ(res->command_tag, "SELECT 2");
+    EXPECT_FALSE(s.get_result());
+    EXPECT_FALSE(s.is_busy());
+
+    std::vector<std::tuple<std::int32_t, std::optional<std::string>>> rows;
+    ozo::recv_result(ozo::make_result(std::move(res)), ozo::empty_oid_map{}, std::back_inserter(rows));
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(std::get<0>(rows[0]), 1);
+    EXPECT_EQ(std::get<1>(rows[0]), "one");
+    EXPECT_EQ(std::get<0>(rows[1]), 2);
+    EXPECT_FALSE(std::get<1>(rows[1]));
+}
+
+TEST_F(ready_session, result_should_refer_to_read_buffer_data) {
+    send_query();
+    const auto in = concat({row_description({{"id", 23}, {"name", 25}}), data_row(1, "value"), command_complete("SELECT 1")});
+    consume(in);
+    auto res = ozo::make_result(s.get_result());
+    EXPECT_EQ(res[0][1].size(), 5u);
+    EXPECT_EQ(std::string_view(res[0][1].data(), 5), "value");
+    EXPECT_EQ(res.handle()->buffers.size(), 1u);
+}
+
+TEST_F(ready_session, should_not_overwrite_data_of_held_result_with_next_result) {
+    send_query();
+    consume(concat({row_description({{"id", 23}, {"name", 25}}), data_row(1, "first"), command_complete("SELECT 1"),
+        ready_for_query()}));
+    auto first = ozo::make_result(s.get_result());
+    EXPECT_FALSE(s.get_result());
+
+    send_query();
+    consume(concat({row_description({{"id", 23}, {"name", 25}}), data_row(2, "XXXXX"), command_complete("SELECT 1"),
+        ready_for_query()}));
+    auto second = ozo::make_result(s.get_result());
+
+    EXPECT_EQ(std::string_view(first[0][1].data(), first[0][1].size()), "first");
+    EXPECT_EQ(std::string_view(second[0][1].data(), second[0][1].size()), "XXXXX");
+}
+
+TEST_F(ready_session, should_not_overwrite_data_of_held_result_when_next_result_does_not_fit_chunk) {
+    send_query();
+    consume(concat({row_description({{"id", 23}, {"name", 25}}), data_row(1, "first"), command_complete("SELECT 1"),
+        ready_for_query()}));
+    auto first = ozo::make_result(s.get_result());
+    EXPECT_FALSE(s.get_result());
+
+    const std::string large(session::default_chunk_size, 'X');
+    send_query();
+    consume(concat({row_description({{"id", 23}, {"name", 25}}), data_row(2, large.c_str()), command_complete("SELECT 1"),
+        ready_for_query()}));
+    auto second = ozo::make_result(s.get_result());
+
+    EXPECT_EQ(std::string_view(first[0][1].data(), first[0][1].size()), "first");
+    EXPECT_EQ(std::string_view(second[0][1].data(), second[0][1].size()), large);
+}
+
+TEST_F(ready_session, should_report_command_ok_for_statement_without_rows) {
+    send_query();
+    consume(concat({command_complete("BEGIN"), ready_for_query('T')}));
+    auto res = s.get_result();
+    ASSERT_TRUE(res);
+    EXPECT_EQ(pq_result_status(*res), PGRES_COMMAND_OK);
+    EXPECT_FALSE(s.get_result());
+    EXPECT_EQ(PQtransactionStatus(&s), PQTRANS_INTRANS);
+}
+
+TEST_F(ready_session, should_report_fatal_error_with_sqlstate) {
+    send_query();
+    consume(concat({error_response("42P01", "relation does not exist"), ready_for_query()}));
+    auto res = s.get_result();
+    ASSERT_TRUE(res);
+    EXPECT_EQ(pq_result_status(*res), PGRES_FATAL_ERROR);
+    EXPECT_EQ(pq_result_error(*res), ozo::sqlstate::undefined_table);
+    EXPECT_FALSE(connection_status_bad(&s));
+}
+
+TEST_F(ready_session, should_fail_on_data_row_without_row_description) {
+    send_query();
+    const auto in = data_row(1, "one");
+    EXPECT_FALSE(s.consume(in.data(), in.size()));
+    EXPECT_TRUE(connection_status_bad(&s));
+}
+
+TEST_F(ready_session, should_collect_notifications) {
+    std::vector<char> in;
+    frontend::writer{in}.begin('A').int32(42).string("channel").string("payload").end();
+    consume(in);
+    ASSERT_EQ(s.notifications().size(), 1u);
+    EXPECT_EQ(s.notifications().front().pid, 42);
+    EXPECT_EQ(s.notifications().front().channel, "channel");
+    EXPECT_EQ(s.notifications().front().payload, "payload");
+}
+
+struct session_over_socket : ready_session {
+    ozo::io_context io;
+    ozo::asio::posix::stream_descriptor local {io};
+    ozo::asio::posix::stream_descriptor remote {io};
+
+    session_over_socket() {
+        int fds[2];
+        EXPECT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        local.assign(fds[0]);
+        remote.assign(fds[1]);
+        local.non_blocking(true);
+    }
+};
+
+TEST_F(session_over_socket, read_should_process_messages_larger_than_read_chunk) {
+    send_query();
+    const std::string big(session::default_chunk_size * 2, 'x');
+    const auto in = concat({
+        row_description({{"id", 23}, {"name", 25}}),
+        data_row(1, big.c_str()),
+        command_complete("SELECT 1"),
+        ready_for_query(),
+    });
+    std::size_t written = 0;
+    while (written < in.size()) {
+        const auto n = ozo::asio::write(remote, ozo::asio::buffer(in.data() + written,
+            std::min<std::size_t>(in.size() - written, 16 * 1024)));
+        written += n;
+        ASSERT_TRUE(s.read(local));
+    }
+    auto res = ozo::make_result(s.get_result());
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0][1].size(), big.size());
+    EXPECT_FALSE(s.get_result());
+}
+
+TEST_F(session_over_socket, flush_should_write_pending_output) {
+    send_query();
+    EXPECT_EQ(s.flush(local), ozo::impl::query_state::send_finish);
+    std::vector<char> out(1024);
+    const auto n = remote.read_some(ozo::asio::buffer(out));
+    EXPECT_GT(n, 0u);
+    EXPECT_EQ(out[0], 'P');
+}
+
+TEST_F(session_over_socket, read_should_fail_when_server_closes_connection) {
+    remote.close();
+    EXPECT_FALSE(s.read(local));
+    EXPECT_TRUE(connection_status_bad(&s));
+    EXPECT_STREQ(PQerrorMessage(&s), "server closed the connection unexpectedly");
+}
+
+TEST_F(ready_session, should_drop_oldest_notification_beyond_limit) {
+    std::vector<char> in;
+    for (std::size_t i = 0; i <= session::max_notifications; ++i) {
+        frontend::writer{in}.begin('A').int32(static_cast<std::int32_t>(i)).string("channel").string("").end();
+    }
+    consume(in);
+    ASSERT_EQ(s.notifications().size(), session::max_notifications);
+    EXPECT_EQ(s.notifications().front().pid, 1);
+}
+
+struct wire_listen : Test {
+    using connection = connection_impl<ozo::empty_oid_map, ozo::no_statistics>;
+
+    ozo::io_context io;
+    std::shared_ptr<connection> conn = std::make_shared<connection>(io, ozo::no_statistics{});
+    ozo::asio::posix::stream_descriptor remote {io};
+
+    wire_listen() {
+        int fds[2];
+        EXPECT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        conn->handle_ = std::make_unique<session>();
+        conn->handle_->set_state(session::state::ready);
+        conn->socket_.assign(fds[0]);
+        remote.assign(fds[1]);
+    }
+
+    void notify(std::int32_t pid, const char* channel, const char* payload) {
+        std::vector<char> in;
+        frontend::writer{in}.begin('A').int32(pid).string(channel).string(payload).end();
+        ozo::asio::write(remote, ozo::asio::buffer(in));
+    }
+};
+
+TEST_F(wire_listen, get_notification_should_take_notifications_from_session) {
+    std::vector<char> in;
+    frontend::writer{in}.begin('A').int32(42).string("channel").string("payload").end();
+    ASSERT_TRUE(conn->handle_->consume(in.data(), in.size()));
+    const auto n = ozo::impl::get_notification(conn);
+    ASSERT_TRUE(n);
+    EXPECT_EQ(n->relname, "channel");
+    EXPECT_EQ(n->extra, "payload");
+    EXPECT_EQ(n->be_pid, 42);
+    EXPECT_TRUE(conn->handle_->notifications().empty());
+    EXPECT_FALSE(ozo::impl::get_notification(conn));
+}
+
+TEST_F(wire_listen, should_provide_notifications_received_via_socket) {
+    std::vector<ozo::notification> received;
+    ozo::error_code result;
+    auto on_notify = [&] (const ozo::notification& n) {
+        received.push_back(n);
+        return true;
+    };
+    auto handler = [&] (ozo::error_code ec, auto) { result = ec; };
+    ozo::impl::async_listen_op<decltype(on_notify), ozo::none_t, decltype(handler)> {
+        {}, on_notify, ozo::none, handler
+    }(ozo::error_code{}, conn);
+
+    notify(1, "first", "one");
+    notify(2, "second", "");
+    io.poll();
+    io.restart();
+    remote.close();
+    io.poll();
+
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[0].channel, "first");
+    EXPECT_EQ(received[0].payload, "one");
+    EXPECT_EQ(received[0].backend_pid, 1);
+    EXPECT_EQ(received[1].channel, "second");
+    EXPECT_EQ(received[1].backend_pid, 2);
+    EXPECT_TRUE(result);
+    EXPECT_TRUE(conn->handle_->notifications().empty());
+}
+
+} // namespace